@@ -22,10 +22,14 @@
 
 #include <include/fwd.hpp>
 #include <include/enums.hpp>
+#include <include/bullet.hpp>
 
+#include <array>
 #include <map>
+#include <random>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 
 
 class AiTemperature
@@ -61,9 +65,17 @@ private:
 };
 
 
+//  Slots are stored inline, so that maps
+//  can be copied without touching the heap
 class ContextMap
 {
-  std::vector <float> mValues {};
+public:
+  static constexpr size_t maxSlots {constants::plane::directionCount};
+
+
+private:
+  std::array <float, maxSlots> mValues {};
+  size_t mSize {};
 
 
 public:
@@ -94,6 +106,29 @@ public:
 };
 
 
+//  Set of actions in the order they were added. Holds every
+//  AiAction at most once, so it never needs to grow
+class AiActionList
+{
+  std::array <AiAction, static_cast <size_t> (AiAction::ActionCount)> mActions {};
+  size_t mCount {};
+
+
+public:
+  AiActionList() = default;
+
+  void push_back( const AiAction );
+
+  AiAction* begin();
+  AiAction* end();
+
+  const AiAction* begin() const;
+  const AiAction* end() const;
+  const AiAction* cbegin() const;
+  const AiAction* cend() const;
+};
+
+
 class AiState
 {
 protected:
@@ -112,11 +147,11 @@ public:
   virtual void update(
     const Plane& self,
     const Plane& opponent,
-    const std::vector <Bullet>& opponentBullets );
+    const BulletSelection& opponentBullets );
 
-  virtual std::vector <AiAction> actions() const;
+  virtual AiActionList actions() const;
 
-  virtual void drawDebugLayer( const Plane& self ) const;
+  void drawDebugLayer( const Plane& self ) const;
 
   void setTemperature( const float );
   float temperature() const;
@@ -137,7 +172,7 @@ public:
   void update(
     const Plane& self,
     const Plane& opponent,
-    const std::vector <Bullet>& opponentBullets );
+    const BulletSelection& opponentBullets );
 
   void drawDebugLayer( const Plane& self ) const;
 
@@ -153,6 +188,16 @@ class AiController
     {PLANE_TYPE::RED, {}},
   };
 
+//  Reused by every update to stay allocation-free
+  std::map <PLANE_TYPE, BulletSelection> mOpponentBullets
+  {
+    {PLANE_TYPE::BLUE, {}},
+    {PLANE_TYPE::RED, {}},
+  };
+
+  std::minstd_rand mRandom {};
+  bool mIsRandomized {};
+
 
 public:
   AiController() = default;
@@ -160,7 +205,10 @@ public:
   void init();
   void update();
 
+//  Bots react with varying speed, the same for the same seed.
+//  Unseeded controller keeps them fully predictable
+  void setSeed( const uint32_t );
+  float randomFactor();
+
   void drawDebugLayer() const;
 };
-
-extern AiController aiController;
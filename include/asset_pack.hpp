@@ -0,0 +1,133 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/sdl.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+//  Single-file archive of pre-decoded assets, built offline by
+//  biplanes_asset_packer. Layout (little-endian):
+//
+//    AssetPackHeader
+//    AssetPackEntry[entryCount], sorted by name
+//    entry data, each blob aligned to dataAlignment
+//
+//  Images are stored as tightly packed RGBA32 pixels, sounds
+//  as raw PCM in the format recorded in their entry.
+
+enum class ASSET_TYPE : uint32_t
+{
+  IMAGE,
+  SOUND,
+};
+
+
+struct AssetPackHeader
+{
+  char magic[4] {'B', 'P', 'A', 'K'};
+  uint32_t version {};
+  uint32_t entryCount {};
+  uint32_t reserved {};
+};
+
+struct AssetPackEntry
+{
+//  Relative to the assets root, '/'-separated
+  char name[104] {};
+
+  uint64_t offset {};
+  uint64_t size {};
+
+  ASSET_TYPE type {};
+
+  uint32_t width {};
+  uint32_t height {};
+
+  uint32_t sampleRate {};
+  uint16_t audioFormat {};
+  uint8_t channels {};
+
+  uint8_t reserved[5] {};
+};
+
+static_assert(sizeof(AssetPackHeader) == 16);
+static_assert(sizeof(AssetPackEntry) == 144);
+
+
+class AssetPack
+{
+public:
+  static constexpr uint32_t version {1};
+  static constexpr size_t dataAlignment {16};
+
+
+private:
+  std::string mRoot {};
+
+  const uint8_t* mData {};
+  size_t mSize {};
+
+//  Whole archive, where it can't be memory-mapped
+  std::vector <uint8_t> mBuffer {};
+
+#if defined(_WIN32)
+  void* mFile {};
+  void* mMapping {};
+#endif
+
+  const AssetPackEntry* mEntries {};
+  uint32_t mEntryCount {};
+
+
+  bool Map( const std::string& path );
+  void Unmap();
+  bool Validate();
+
+
+public:
+  AssetPack() = default;
+  ~AssetPack();
+
+  AssetPack( const AssetPack& ) = delete;
+  AssetPack& operator = ( const AssetPack& ) = delete;
+
+
+//  Opens "<assetsRoot>.bpak"
+  bool Open( const std::string& assetsRoot );
+  void Close();
+
+//  Path of an asset under the assets root, as passed to IMG_Load
+  const AssetPackEntry* find( const std::string& path ) const;
+
+//  Surface pixels point into the archive
+  SDL_Surface* LoadSurface( const std::string& path ) const;
+
+//  Chunk samples point into the archive unless
+//  they had to be converted to the mixer format
+  Mix_Chunk* LoadSound( const std::string& path ) const;
+
+  bool isOpen() const;
+};
@@ -0,0 +1,110 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/fwd.hpp>
+#include <include/sdl.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+//  Packs every image into as few textures as possible,
+//  so that sprites of different images can share a draw call.
+//  Packed pages are cached on disk and reused until any of
+//  the source images changes. Images found in the asset pack
+//  are already decoded, so packing them skips the cache.
+
+class TextureAtlas
+{
+public:
+  static constexpr int maxPageSize {1024};
+  static constexpr int padding {1};
+
+
+  struct Region
+  {
+    SDL_Texture* texture {};
+    SDL_Rect rect {};
+  };
+
+
+private:
+  struct Image
+  {
+    std::string path {};
+    uintmax_t fileSize {};
+    int64_t modificationTime {};
+
+    size_t page {};
+    SDL_Rect rect {};
+  };
+
+  std::vector <Image> mImages {};
+  std::vector <SDL_Texture*> mPages {};
+
+  std::string mCachePath {};
+  bool mIsCacheEnabled {};
+  bool mIsCached {};
+
+//  Decoded images, or cached pages when mIsCached is set
+  std::vector <SDL_Surface*> mSurfaces {};
+  std::vector <std::string> mErrors {};
+
+
+  bool LoadCacheLayout();
+  void SaveCache( const std::vector <SDL_Surface*>& pages ) const;
+
+  SDL_Surface* LoadImage(
+    const size_t image,
+    const AssetPack&,
+    std::string& error ) const;
+
+  std::vector <SDL_Surface*> Pack();
+  void FreeSurfaces();
+
+
+public:
+  TextureAtlas() = default;
+
+  size_t Add( const std::string& path );
+
+//  Building is split in three steps, so that decoding
+//  can run on worker threads: Prepare() and Upload()
+//  must be called from the render thread, while Decode()
+//  may be called from any thread once per index below
+//  decodeCount(), as long as indices don't repeat
+  void Prepare(
+    const std::string& cachePath,
+    const AssetPack& );
+  void Decode(
+    const size_t index,
+    const AssetPack& );
+  void Upload( const AssetPack& );
+
+  void Unload();
+
+  Region region( const size_t image ) const;
+  size_t pageCount() const;
+  size_t decodeCount() const;
+};
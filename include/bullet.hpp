@@ -22,35 +22,32 @@
 
 #include <include/fwd.hpp>
 #include <include/enums.hpp>
-#include <include/timer.hpp>
+#include <include/constants.hpp>
 
-#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 
+//  Copy of a single bullet taken out of BulletSpawner
 class Bullet
 {
+  friend class BulletSpawner;
+
   float mX {};
   float mY {};
   float mDir {};
 
-  bool mIsDead {false};
+//  Heading never changes, so velocity is cached at spawn
+  float mSpeedX {};
+  float mSpeedY {};
+
   PLANE_TYPE mFiredBy {};
 
 
 public:
-  Bullet(
-    const float planeX,
-    const float planeY,
-    const float planeDir,
-    const PLANE_TYPE );
-
+  Bullet() = default;
 
-  void Update();
-  void Draw() const;
 
-  void Destroy();
-
-  bool isDead() const;
   PLANE_TYPE firedBy() const;
 
   float x() const;
@@ -59,9 +56,33 @@ public:
 };
 
 
+//  Fixed-capacity pool with one array per field. Dead bullets
+//  are replaced by the last live one, so live bullets are always
+//  packed at the front and spawning never allocates
 class BulletSpawner
 {
-  std::vector <Bullet> mInstances {};
+  friend struct WorldSnapshot;
+
+public:
+  static constexpr size_t capacity {constants::bullet::maxCount};
+
+
+private:
+  float mX[capacity] {};
+  float mY[capacity] {};
+  float mDir[capacity] {};
+  float mSpeedX[capacity] {};
+  float mSpeedY[capacity] {};
+  PLANE_TYPE mFiredBy[capacity] {};
+
+  size_t mCount {};
+  size_t mHighWaterMark {};
+
+
+  void Insert( const Bullet& );
+  void Remove( const size_t index );
+
+  bool CollisionsUpdate( const size_t index );
 
 
 public:
@@ -78,10 +99,43 @@ public:
   void Update();
   void Draw() const;
 
-  std::vector <Bullet> GetClosestBullets(
+  size_t count() const;
+
+//  Most bullets alive at once since the last Clear()
+  size_t highWaterMark() const;
+
+  Bullet at( const size_t index ) const;
+
+  void GetClosestBullets(
     const float x,
     const float y,
-    const PLANE_TYPE target ) const;
+    const PLANE_TYPE target,
+    const size_t maxCount,
+    BulletSelection& ) const;
 };
 
-extern class BulletSpawner bullets;
+
+//  Bullets picked out of a BulletSpawner by index, valid until the
+//  pool is updated. Meant to be kept and reused between queries,
+//  so that they don't allocate
+class BulletSelection
+{
+  friend class BulletSpawner;
+
+  const BulletSpawner* mPool {};
+
+  uint16_t mIndices[BulletSpawner::capacity] {};
+  size_t mCount {};
+
+//  Squared distances by pool index
+  float mDistances[BulletSpawner::capacity] {};
+
+
+public:
+  BulletSelection() = default;
+
+
+  size_t size() const;
+
+  Bullet operator [] ( const size_t ) const;
+};
@@ -57,5 +57,3 @@ public:
 
   bool isHit( const float x, const float y ) const;
 };
-
-extern std::vector <Cloud> clouds;
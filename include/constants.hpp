@@ -23,12 +23,17 @@
 #include <include/color.hpp>
 
 #include <cstdint>
+#include <cstddef>
 
 
 namespace constants
 {
   static constexpr uint32_t tickRate {120};
   static constexpr uint32_t packetSendRate {60};
+
+//  Congested link is backed off down to this rate. Packets
+//  carry 8 frames of input, so each input still goes out twice
+  static constexpr uint32_t packetSendRateMin {30};
   static constexpr uint8_t defaultWinScore {10};
   static constexpr uint8_t maxWinScore {100};
 
@@ -89,6 +94,13 @@ namespace constants
 
         static constexpr Color actionBox {255, 255, 255, 255};
       }
+
+      namespace perf
+      {
+        static constexpr Color graphBorder {255, 255, 255, 255};
+        static constexpr Color graphSample {255, 255, 0, 255};
+        static constexpr Color tickBudget {255, 0, 0, 255};
+      }
     }
   }
 
@@ -100,6 +112,29 @@ namespace constants
   }
 
 
+  namespace perfHud
+  {
+//  One second of frames at the tick rate
+    static constexpr size_t sampleCount {tickRate};
+
+//  Below the row of menu messages
+    static constexpr float originX {text::sizeX};
+    static constexpr float originY {2.f * text::sizeY};
+
+    static constexpr float sampleSizeX {1.f / baseWidth};
+
+    static constexpr float graphSizeX {sampleCount * sampleSizeX};
+    static constexpr float graphSizeY {24.f / baseHeight};
+    static constexpr float graphSpacingY {4.f / baseHeight};
+
+    static constexpr float graphLabelOffsetX {1.f / baseWidth};
+    static constexpr float graphLabelOffsetY {1.f / baseHeight};
+
+//  Graphs top out at two tick intervals
+    static constexpr double graphMaxTime {2.0 / tickRate};
+  }
+
+
   namespace menu
   {
     static constexpr float originX {};
@@ -201,6 +236,9 @@ namespace constants
     static constexpr double frameTime {0.1};
     static constexpr uint8_t frameCount {5};
     static constexpr double cooldown {1.0};
+
+//    Capacity of the smoke puff pool
+    static constexpr size_t maxCount {32};
   }
 
 //  FIRE ANIM
@@ -220,10 +258,14 @@ namespace constants
     static constexpr float sizeX {40.f / baseWidth};
     static constexpr float sizeY {40.f / baseHeight};
 
+//    Capacity of the explosion pool
+    static constexpr size_t maxCount {8};
+
 
     namespace spark
     {
       static constexpr uint8_t count {25};
+      static constexpr size_t maxCount {8 * count};
       static constexpr uint8_t maxBounces {2};
 
       static constexpr float sizeX {2.f / baseWidth};
@@ -298,12 +340,17 @@ namespace constants
     static constexpr float sizeY {3.f / baseHeight};
     static constexpr float speed {0.77f};
 
+//    Capacity of the bullet pool
+    static constexpr size_t maxCount {256};
+
     static constexpr float groundCollision {186.16f / baseHeight};
 
     namespace hit
     {
       static constexpr float sizeX {9.f / baseWidth};
       static constexpr float sizeY {8.f / baseHeight};
+
+      static constexpr size_t maxCount {64};
     }
   }
 
@@ -333,6 +380,8 @@ namespace constants
 //  CLOUD
   namespace cloud
   {
+    static constexpr size_t count {8};
+
     static constexpr float sizeX {69.f / baseWidth};
     static constexpr float sizeY {32.f / baseHeight};
 
@@ -385,6 +434,9 @@ namespace constants
     static constexpr float aimConeEasy {2.f};
     static constexpr float shootCooldownEasy {2.f * plane::shootCooldown};
 
+//    Only this many of the closest opponent bullets are evaluated
+    static constexpr size_t trackedBullets {16};
+
     namespace debug
     {
       static constexpr float dangerMagnitude {2.f * plane::sizeX};
@@ -21,11 +21,13 @@
 #pragma once
 
 #include <include/timer.hpp>
+#include <include/constants.hpp>
 
-#include <vector>
+#include <cstddef>
 #include <cstdint>
 
 
+//  Frame animation shared by every effect
 class Effect
 {
 protected:
@@ -38,6 +40,8 @@ protected:
 
 
 public:
+  Effect() = default;
+
   Effect(
     const float x,
     const float y,
@@ -45,97 +49,170 @@ public:
     const uint8_t frameCount );
 
 
-  virtual ~Effect() = default;
-
-
-  virtual void Update();
-  void Draw() const;
+  void Update();
 
   bool hasFinished() const;
 
-
-protected:
-  virtual void DrawImpl() const = 0;
+  float x() const;
+  float y() const;
+  uint8_t frame() const;
 };
 
 
-class Effects
+class ExplosionSpark : public Effect
 {
-  std::vector <Effect*> mEffects {};
+  float mSpeedX {};
+  float mSpeedY {};
+
+  uint8_t mBounces {};
 
 
 public:
-  Effects() = default;
-  ~Effects();
+  ExplosionSpark() = default;
 
-  void Spawn( Effect* );
-  void Clear();
+  ExplosionSpark(
+    const float x,
+    const float y,
+    const float speed,
+    const float dir );
 
+//  Hides Effect::Update(), pools are typed so no vtable is needed
   void Update();
-  void Draw() const;
 };
 
-extern Effects effects;
-
 
-class SmokePuff : public Effect
+//  Fixed-capacity array of effects of a single type.
+//  Finished effects are compacted away in place, so
+//  spawn order is kept and spawning never allocates
+template <typename EffectType, size_t Capacity>
+class EffectPool
 {
-public:
-  SmokePuff(
-    const float x,
-    const float y );
+  EffectType mEffects[Capacity] {};
+  size_t mCount {};
 
 
-protected:
-  void DrawImpl() const override;
-};
+public:
+  static constexpr size_t capacity {Capacity};
 
 
-class Explosion : public Effect
-{
-public:
-  Explosion(
-    const float x,
-    const float y );
+  EffectPool() = default;
 
+  void Spawn( const EffectType& );
+  void Clear();
+  void Update();
 
-protected:
-  void DrawImpl() const override;
+  size_t count() const;
+
+  const EffectType* begin() const;
+  const EffectType* end() const;
 };
 
 
-class ExplosionSpark : public Effect
+class Effects
 {
-protected:
-  float mSpeedX {};
-  float mSpeedY {};
+  EffectPool <Effect, constants::smoke::maxCount> mSmokePuffs {};
+  EffectPool <Effect, constants::bullet::hit::maxCount> mBulletImpacts {};
+  EffectPool <Effect, constants::explosion::maxCount> mExplosions {};
+  EffectPool <ExplosionSpark, constants::explosion::spark::maxCount> mExplosionSparks {};
 
-  uint8_t mBounces {};
+
+  void DrawSmokePuffs() const;
+  void DrawBulletImpacts() const;
+  void DrawExplosions() const;
+  void DrawExplosionSparks() const;
 
 
 public:
-  ExplosionSpark(
+  Effects() = default;
+
+  void SpawnSmokePuff(
+    const float x,
+    const float y );
+
+  void SpawnBulletImpact(
+    const float x,
+    const float y );
+
+  void SpawnExplosion(
+    const float x,
+    const float y );
+
+  void SpawnExplosionSpark(
     const float x,
     const float y,
     const float speed,
     const float dir );
 
-  void Update() override;
+  void Clear();
 
+  void Update();
+  void Draw() const;
 
-protected:
-  void DrawImpl() const override;
+  size_t count() const;
 };
 
 
-class BulletImpact : public Effect
+template <typename EffectType, size_t Capacity>
+void
+EffectPool <EffectType, Capacity>::Spawn(
+  const EffectType& effect )
 {
-public:
-  BulletImpact(
-    const float x,
-    const float y );
+//  Running out of slots only drops new effects
+  if ( mCount >= Capacity )
+    return;
 
+  mEffects[mCount] = effect;
+  ++mCount;
+}
 
-protected:
-  void DrawImpl() const override;
-};
+template <typename EffectType, size_t Capacity>
+void
+EffectPool <EffectType, Capacity>::Clear()
+{
+  mCount = 0;
+}
+
+template <typename EffectType, size_t Capacity>
+void
+EffectPool <EffectType, Capacity>::Update()
+{
+  size_t liveCount {};
+
+  for ( size_t i {}; i < mCount; ++i )
+  {
+    auto& effect = mEffects[i];
+
+    effect.Update();
+
+    if ( effect.hasFinished() == true )
+      continue;
+
+    if ( liveCount != i )
+      mEffects[liveCount] = effect;
+
+    ++liveCount;
+  }
+
+  mCount = liveCount;
+}
+
+template <typename EffectType, size_t Capacity>
+size_t
+EffectPool <EffectType, Capacity>::count() const
+{
+  return mCount;
+}
+
+template <typename EffectType, size_t Capacity>
+const EffectType*
+EffectPool <EffectType, Capacity>::begin() const
+{
+  return mEffects;
+}
+
+template <typename EffectType, size_t Capacity>
+const EffectType*
+EffectPool <EffectType, Capacity>::end() const
+{
+  return mEffects + mCount;
+}
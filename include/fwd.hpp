@@ -38,6 +38,9 @@ class FlowControl;
 }
 
 class Timer;
+class AssetPack;
+class ResourceCache;
+class TextureAtlas;
 
 struct Color;
 struct Controls;
@@ -46,6 +49,8 @@ struct Sizes;
 struct Sounds;
 struct Statistics;
 struct Textures;
+struct World;
+struct WorldSnapshot;
 
 struct PlaneNetworkData;
 struct Packet;
@@ -53,6 +58,7 @@ class MatchMaker;
 
 class Bullet;
 class BulletSpawner;
+class BulletSelection;
 class Cloud;
 class Menu;
 class Plane;
@@ -56,6 +56,7 @@ public:
   {
     bool collisions {};
     bool ai {};
+    bool perfHud {};
 
     bool stepByStepMode {};
     bool advanceOneTick {};
@@ -82,6 +83,9 @@ public:
   uint8_t audioVolume {75};
   uint8_t stereoDepth {40};
 
+//  MiB of rarely used assets kept resident
+  uint32_t assetCacheBudget {8};
+
   GAME_MODE gameMode {};
   DIFFICULTY botDifficulty {DIFFICULTY::EASY};
   uint8_t winScore {10};
@@ -22,15 +22,27 @@
 
 #include <lib/SDL_Vector.h>
 
-#include <vector>
+#include <cstddef>
 
 
 bool segment_intersects_polygon(
   const SDL_Vector& from,
   const SDL_Vector& to,
-  const std::vector <SDL_Vector>& polygon,
+  const SDL_Vector* polygon,
+  const size_t pointCount,
   SDL_Vector* contact );
 
+template <size_t PointCount>
+bool segment_intersects_polygon(
+  const SDL_Vector& from,
+  const SDL_Vector& to,
+  const SDL_Vector (&polygon)[PointCount],
+  SDL_Vector* contact )
+{
+  return segment_intersects_polygon(
+    from, to, polygon, PointCount, contact );
+}
+
 float get_distance_between_points(
   const SDL_Vector& p1,
   const SDL_Vector& p2 );
@@ -49,3 +61,24 @@ float get_angle_to_point(
 
 size_t angleToPitchIndex( const float degrees );
 
+
+//  With BIPLANES_DETERMINISTIC_MATH these use a lookup table
+//  and give bit-identical results on every platform
+float sin_deg( const float degrees );
+float cos_deg( const float degrees );
+
+
+//  Unit vector of a heading in game space: {sin, -cos},
+//  since 0 degrees points up and the Y axis points down
+struct Direction
+{
+  float x {};
+  float y {};
+};
+
+//  Precomputed for every constants::plane::pitchStep multiple
+const Direction& pitch_direction( const size_t pitchIndex );
+
+//  Table lookup for pitch step multiples, sin_deg/cos_deg otherwise
+Direction direction_vector( const float degrees );
+
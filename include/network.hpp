@@ -29,10 +29,16 @@
 void eventPush( const EVENTS );
 void eventsPack( Packet& );
 void eventsReset();
-void eventsNewTick();
 
-void processOpponentData( const Packet&, const Packet& prev );
+void processOpponentData( const Packet& );
+void applyOpponentEvent( const EVENTS );
 void sendDisconnectMessage();
 
-Packet& operator << ( Packet&, const Controls& );
+void sendPacket( const Packet& );
+bool receivePacket( Packet& );
+
+void flowControlInit( net::FlowControl& );
+
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
 Packet& operator << ( Packet&, const PlaneNetworkData& );
+#endif
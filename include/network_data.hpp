@@ -22,6 +22,16 @@
 
 #include <include/enums.hpp>
 
+#include <cstdint>
+
+
+//  Peers with different physics modes can't play together
+#if defined(BIPLANES_DETERMINISTIC_MATH)
+static constexpr int32_t ProtocolId {0x11223347};
+#else
+static constexpr int32_t ProtocolId {0x11223346};
+#endif
+
 
 struct PlaneNetworkData
 {
@@ -37,19 +47,51 @@ struct PlaneNetworkData
 };
 
 
+struct NetworkEvent
+{
+  EVENTS type {EVENTS::NONE};
+
+//  Sender's frame when the event was first sent
+  uint32_t frame {};
+
+
+  NetworkEvent() = default;
+};
+
+
 struct Packet
 {
-  PLANE_PITCH pitch {};
-  PLANE_THROTTLE throttle {};
+//  Sender's last simulated frame and its
+//  inputs for the frames leading up to it
+  uint32_t frame {};
+  uint8_t inputs[8] {};
+
   bool disconnect {};
 
+//  Sender hasn't heard from opponent yet, so the rest is from
+//  before the match was reset and must not be applied
+  bool waiting {};
+
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
+//  Sender's plane state to correct drift of inexact physics,
+//  left out of some packets when the link is congested
+  bool hasState {};
   float x {};
   float y {};
   float dir {};
   float pilot_x {};
   float pilot_y {};
+#endif
+
+//  Sender's events not yet acked by opponent, oldest first.
+//  Ids count up from eventId, wrapping around
+  uint16_t eventId {};
+  uint8_t eventCount {};
+  NetworkEvent events[16];
 
-  unsigned char events[32] {};
+//  Id of the next opponent's event the sender expects,
+//  acks all the ones before it
+  uint16_t eventAck {};
 
 
   Packet() = default;
@@ -31,8 +31,6 @@ struct NetworkState
   net::FlowControl* flowControl {};
   MatchMaker* matchmaker {};
 
-  Timer sendCoordsTimer {0.25};
-
   SRV_CLI nodeType {SRV_CLI::SERVER};
 
   bool connectionChanged {};
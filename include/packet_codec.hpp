@@ -0,0 +1,143 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/fwd.hpp>
+#include <include/network_data.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+
+//  Wire format of Packet. Fields are bit-packed in a fixed
+//  order, so it doesn't depend on struct layout or endianness.
+//  Each packet is delta-encoded against the newest one
+//  the opponent reports having decoded, sending only
+//  what changed since.
+
+class BitWriter
+{
+  uint8_t* mData {};
+  size_t mCapacity {};
+  size_t mBitCount {};
+  bool mHasOverflowed {};
+
+
+public:
+  BitWriter(
+    uint8_t* data,
+    const size_t capacity );
+
+  void Write(
+    const uint32_t value,
+    const uint8_t bits );
+
+  size_t byteCount() const;
+  bool hasOverflowed() const;
+};
+
+class BitReader
+{
+  const uint8_t* mData {};
+  size_t mSize {};
+  size_t mBitCount {};
+  bool mHasOverflowed {};
+
+
+public:
+  BitReader(
+    const uint8_t* data,
+    const size_t size );
+
+  uint32_t Read( const uint8_t bits );
+
+  bool hasOverflowed() const;
+};
+
+
+//  Recently sent or received packets, indexed by sequence
+class PacketHistory
+{
+public:
+  static constexpr uint32_t size {64};
+
+
+private:
+  Packet mPackets[size] {};
+  uint32_t mSequences[size] {};
+  bool mIsValid[size] {};
+
+
+public:
+  PacketHistory() = default;
+
+  void Reset();
+  void Store(
+    const uint32_t sequence,
+    const Packet& );
+
+  const Packet* find( const uint32_t sequence ) const;
+  const Packet* findLowBits(
+    const uint8_t sequenceLowBits,
+    uint32_t& sequence ) const;
+};
+
+
+class PacketCodec
+{
+  PacketHistory mSent {};
+  PacketHistory mReceived {};
+
+//  Newest of our packets the opponent has decoded
+  uint32_t mBaselineSequence {};
+  bool mHasBaseline {};
+
+//  Newest of opponent's packets we have decoded
+  uint32_t mDecodedSequence {};
+  bool mHasDecoded {};
+
+
+public:
+  static constexpr uint8_t version {3};
+
+//  Largest encoded packet, sent without a baseline
+  static constexpr size_t maxSize {128};
+
+
+  PacketCodec() = default;
+
+  void Reset();
+
+//  Returns encoded size, 0 if it doesn't fit
+  size_t Encode(
+    const Packet&,
+    const uint32_t sequence,
+    uint8_t* data,
+    const size_t capacity );
+
+//  Fails on a wrong version, malformed data
+//  or a baseline that was never decoded
+  bool Decode(
+    const uint8_t* data,
+    const size_t size,
+    const uint32_t sequence,
+    Packet& );
+};
@@ -0,0 +1,35 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+
+//  Debug overlay with rolling min/avg/max of frame timings,
+//  draw calls, live entities and link quality over the last
+//  second. Samples are only taken while it's shown
+
+void perf_hud_record(
+  const double frameTime,
+  const double tickTime,
+  const uint32_t ticks );
+
+void draw_perf_hud();
@@ -212,8 +212,6 @@ public:
     int8_t mAngelLoop {};
     Timer mAngelAnim {0.0f};
 
-    int mAudioLoopChannel {-1};
-
 
   public:
     Pilot();
@@ -276,5 +274,3 @@ public:
 
   Statistics mStats {};
 };
-
-extern std::map <PLANE_TYPE, Plane> planes;
@@ -0,0 +1,113 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/fwd.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+//  Smooths how the remote plane is drawn in online matches.
+//  Rollback snaps it to a new path whenever a late input or state
+//  correction arrives. Instead of drawing the jump, the difference
+//  is kept as an offset that fades out over a few frames. States
+//  are timestamped as they're simulated, so the plane can also be
+//  drawn a bit in the past, interpolated between them, or carried
+//  along its speed vector while no new frame has been simulated.
+
+class PlaneSmoothing
+{
+public:
+  struct Config
+  {
+//  Drawn this many seconds behind the newest state
+    double interpolationDelay {};
+
+//  Newest state is extrapolated at most this many seconds
+    double extrapolationLimit {0.05};
+
+//  Correction offset halves every this many seconds
+    double errorHalfLife {0.04};
+
+//  Larger jumps snap right away
+    float snapDistance {0.1f};
+  };
+
+
+private:
+  struct State
+  {
+    double time {};
+    uint32_t frame {};
+
+    float x {};
+    float y {};
+    float pilotX {};
+    float pilotY {};
+
+//  Distance covered by the last tick
+    float speedX {};
+    float speedY {};
+
+    bool isVisible {};
+    bool hasJumped {};
+  };
+
+  struct Position
+  {
+    float x {};
+    float y {};
+    float pilotX {};
+    float pilotY {};
+  };
+
+
+  Config mConfig {};
+
+  std::array <State, 16> mStates {};
+  size_t mStateCount {};
+  size_t mNewest {};
+
+  Position mError {};
+  double mErrorTime {};
+
+
+  const State& state( const size_t age ) const;
+  Position sample( const double time ) const;
+  Position error( const double time ) const;
+
+
+public:
+  PlaneSmoothing() = default;
+
+  void setConfig( const Config& );
+  const Config& config() const;
+
+  void Reset();
+
+//  Call after each simulation step, only new frames are stored
+  void Update( const Plane&, const uint32_t frame, const double time );
+
+//  Copy of the plane moved to where it should be drawn
+  Plane Apply( const Plane&, const double time ) const;
+};
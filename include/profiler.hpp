@@ -0,0 +1,70 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+
+//  Scoped-zone profiler, compiled in with BIPLANES_PROFILER_ENABLED.
+//  Every thread records the zones it closes into its own ring
+//  buffer, so only the most recent ones are kept. The trace can be
+//  opened in chrome://tracing or ui.perfetto.dev.
+//  Zone names must be string literals: only pointers are stored.
+
+#if defined(BIPLANES_PROFILER_ENABLED)
+
+  #define PROFILER_CONCAT_IMPL(a, b) a##b
+  #define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+  #define PROFILE_ZONE(name) \
+    const ProfilerZone PROFILER_CONCAT(profilerZone, __LINE__) {name}
+
+  #define PROFILE_THREAD_NAME(name) \
+    profiler_set_thread_name(name)
+
+
+class ProfilerZone
+{
+  const char* mName {};
+  int64_t mStart {};
+
+
+public:
+  ProfilerZone( const char* name );
+  ~ProfilerZone();
+
+  ProfilerZone( const ProfilerZone& ) = delete;
+  ProfilerZone& operator = ( const ProfilerZone& ) = delete;
+};
+
+
+void profiler_set_thread_name( const char* );
+
+//  Other threads must not record zones while the trace is written
+bool profiler_write_trace( const std::string& path );
+
+#else
+
+  #define PROFILE_ZONE(name)
+  #define PROFILE_THREAD_NAME(name)
+
+#endif
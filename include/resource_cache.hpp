@@ -0,0 +1,146 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/fwd.hpp>
+#include <include/sdl.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+//  Rarely used assets, loaded on first use and evicted
+//  in least-recently-used order once their total size
+//  exceeds the budget. Assets used during the current
+//  frame or acquired by someone are never evicted.
+//  Everything but Prefetch() decoding runs on the render thread.
+
+class ResourceCache
+{
+public:
+  using Id = size_t;
+
+
+private:
+  enum class TYPE
+  {
+    TEXTURE,
+    SOUND,
+  };
+
+  struct Entry
+  {
+    std::string path {};
+    TYPE type {};
+
+    SDL_Texture* texture {};
+    Mix_Chunk* sound {};
+    size_t size {};
+
+    uint32_t refCount {};
+    uint64_t lastUsed {};
+
+    bool isPending {};
+    bool isFailed {};
+  };
+
+  struct Decoded
+  {
+    Id id {};
+    SDL_Surface* surface {};
+    Mix_Chunk* sound {};
+  };
+
+
+  std::vector <Entry> mEntries {};
+  const AssetPack* mAssetPack {};
+
+  size_t mBudget {};
+  size_t mResidentSize {};
+  uint64_t mFrame {};
+
+
+  std::thread mWorker {};
+  std::mutex mMutex {};
+  std::condition_variable mRequestsChanged {};
+
+//  Guarded by mMutex
+  std::vector <Id> mRequests {};
+  std::vector <Decoded> mDecoded {};
+  bool mIsStopping {};
+
+
+  Id Add(
+    const std::string& path,
+    const TYPE );
+
+  Decoded Decode( const Id ) const;
+  void Store( const Decoded& );
+  void Load( const Id );
+  void Evict();
+  void Free( Entry& );
+
+  bool isSoundPlaying( const Mix_Chunk* ) const;
+
+  void RunWorker();
+  void StopWorker();
+
+
+public:
+  ResourceCache() = default;
+  ~ResourceCache();
+
+  ResourceCache( const ResourceCache& ) = delete;
+  ResourceCache& operator = ( const ResourceCache& ) = delete;
+
+
+  void Open(
+    const AssetPack&,
+    const size_t budget );
+  void Close();
+
+  Id AddTexture( const std::string& path );
+  Id AddSound( const std::string& path );
+
+//  Loads the asset right away if it isn't resident yet
+  SDL_Texture* texture( const Id );
+  Mix_Chunk* sound( const Id );
+
+//  Decodes the asset in the background
+  void Prefetch( const Id );
+
+//  Acquired assets stay resident until released
+  void Acquire( const Id );
+  void Release( const Id );
+
+//  Call once per frame
+  void Update();
+
+  bool isResident( const Id ) const;
+  size_t residentSize() const;
+};
+
+ResourceCache& resourceCache();
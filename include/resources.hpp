@@ -21,7 +21,13 @@
 #pragma once
 
 
-void textures_load();
+//  Decodes every asset on worker threads. Call
+//  resources_load_update() every frame to upload
+//  finished textures, until it returns true
+void resources_load_begin();
+bool resources_load_update();
+float resources_load_progress();
+bool resources_loaded();
+
 void textures_unload();
-void sounds_load();
 void sounds_unload();
@@ -0,0 +1,57 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/fwd.hpp>
+#include <include/enums.hpp>
+
+#include <cstdint>
+
+
+//  Input prediction and rollback for HUMAN_VS_HUMAN mode.
+//  Each peer keeps the world state and both planes' inputs for the
+//  last rollbackFrames ticks. Missing remote input is predicted by
+//  repeating the last confirmed one; when the real input or a state
+//  correction for a past tick arrives, the world is restored to
+//  that tick and re-simulated up to the present with all side
+//  effects (sounds, outgoing events) muted.
+
+static constexpr uint32_t rollbackFrames {64};
+
+
+void rollbackReset();
+uint32_t rollbackFrame();
+
+bool rollbackShouldStall( const float roundTripTime );
+
+void rollbackAddRemoteInput( const uint32_t frame, const Controls& );
+void rollbackAddRemoteState( const uint32_t frame, const PlaneNetworkData& );
+void rollbackAddRemoteEvent( const uint32_t frame, const EVENTS );
+void rollbackAddLocalEvent( const EVENTS );
+
+void rollbackAdvance( const Controls& local, const bool withRemote );
+
+void rollbackPackInputs( Packet& );
+void rollbackUnpackInputs( const Packet& );
+
+//  World state before the frame was simulated, with every rollback
+//  so far applied. Nullptr for frames no longer or not yet in history
+const WorldSnapshot* rollbackSnapshot( const uint32_t frame );
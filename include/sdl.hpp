@@ -21,6 +21,7 @@
 #pragma once
 
 #include <include/fwd.hpp>
+#include <include/sdl_rect.hpp>
 
 #if !defined(__EMSCRIPTEN__)
   #include <SDL.h>
@@ -35,17 +36,6 @@
 #include <string>
 
 
-#if !SDL_VERSION_ATLEAST(2, 0, 22)
-
-SDL_FORCE_INLINE SDL_bool SDL_PointInFRect(const SDL_FPoint *p, const SDL_FRect *r)
-{
-    return ( (p->x >= r->x) && (p->x < (r->x + r->w)) &&
-             (p->y >= r->y) && (p->y < (r->y + r->h)) ) ? SDL_TRUE : SDL_FALSE;
-}
-
-#endif
-
-
 extern int DISPLAY_INDEX;
 
 extern SDL_Window* gWindow;
@@ -0,0 +1,76 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/enums.hpp>
+
+#include <cstdint>
+
+
+//  Side effects of the simulation (sounds, menu messages,
+//  outgoing network events) are reported through SimEvent
+//  instead of being performed in place. The simulation itself
+//  never touches the window, renderer or mixer, so it can run
+//  headless; the SDL frontend subscribes with setSimEventHandler.
+
+enum class SIM_EVENT : uint8_t
+{
+  SHOT_FIRED,
+  PLANE_HIT,
+  PLANE_EXPLODED,
+  BULLET_IMPACT,
+
+  PILOT_BAILED,
+  PILOT_FALLING,
+  PILOT_CHUTE_FALLING,
+  PILOT_FALL_ENDED,
+  PILOT_CHUTE_HIT,
+  PILOT_DIED,
+  PILOT_RESCUED,
+
+  ROUND_WON,
+  ROUND_LOST,
+  TOTAL_STATS_UPDATED,
+
+  NETWORK_EVENT,
+};
+
+
+struct SimEvent
+{
+  SIM_EVENT type {};
+  PLANE_TYPE plane {};
+  float x {};
+
+  EVENTS netEvent {EVENTS::NONE};
+  MESSAGE_TYPE message {MESSAGE_TYPE::NONE};
+};
+
+
+using SimEventHandler = void (*) ( const SimEvent& );
+
+void setSimEventHandler( const SimEventHandler );
+void simEventPush( const SimEvent& );
+void simNetEventPush( const EVENTS );
+
+
+void sim_reset();
+void sim_tick();
@@ -38,8 +38,9 @@ struct Sounds
   Mix_Chunk* pilotDeath {};
   Mix_Chunk* pilotRescue {};
 
-  Mix_Chunk* victory {};
-  Mix_Chunk* defeat {};
+//  Resource cache ids
+  size_t victory {};
+  size_t defeat {};
 
 
   Sounds() = default;
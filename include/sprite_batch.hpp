@@ -0,0 +1,60 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/sdl.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+
+//  Sprites are queued instead of drawn right away. Consecutive
+//  sprites sharing a texture are submitted with a single
+//  SDL_RenderGeometry call when the texture changes, when a
+//  primitive is drawn (see setRenderColor) or when the frame ends.
+
+struct SpriteBatchStats
+{
+  size_t drawCalls {};
+  size_t vertices {};
+  size_t sprites {};
+};
+
+
+void sprite_batch_draw(
+  SDL_Texture*,
+  const SDL_Rect* srcRect,
+  const SDL_FRect& dstRect,
+  const uint8_t alpha = 255 );
+
+void sprite_batch_draw_ex(
+  SDL_Texture*,
+  const SDL_Rect* srcRect,
+  const SDL_FRect& dstRect,
+  const double angle,
+  const SDL_RendererFlip,
+  const uint8_t alpha = 255 );
+
+void sprite_batch_flush();
+void sprite_batch_end_frame();
+
+//  Totals of the last finished frame
+SpriteBatchStats sprite_batch_stats();
@@ -23,24 +23,41 @@
 #include <SDL_image.h>
 
 
+//  All textures are pages of a single atlas,
+//  so every image is drawn through its rect.
+//  Rarely used images are loaded on demand
+//  through the resource cache instead
+
 struct Textures
 {
   SDL_Texture* main_font {};
 
-  SDL_Texture* menu_help {};
+//  Resource cache id
+  size_t menu_help {};
+
   SDL_Texture* menu_button {};
+  SDL_Rect menu_button_rect {};
   SDL_Texture* menu_logo {};
+  SDL_Rect menu_logo_rect {};
 
   SDL_Texture* font_zeppelin_score {};
 
   SDL_Texture* background {};
+  SDL_Rect background_rect {};
   SDL_Texture* barn {};
+  SDL_Rect barn_rect {};
   SDL_Texture* plane_red {};
+  SDL_Rect plane_red_rect {};
   SDL_Texture* plane_blue {};
+  SDL_Rect plane_blue_rect {};
   SDL_Texture* bullet {};
+  SDL_Rect bullet_rect {};
   SDL_Texture* cloud {};
+  SDL_Rect cloud_rect {};
   SDL_Texture* cloud_opaque {};
+  SDL_Rect cloud_opaque_rect {};
   SDL_Texture* zeppelin {};
+  SDL_Rect zeppelin_rect {};
 
   SDL_Texture* anim_smk {};
   SDL_Rect anim_smk_rect[6] {};
@@ -57,16 +74,20 @@ struct Textures
   SDL_Texture* anim_pilot_angel {};
   SDL_Rect anim_pilot_angel_rect[4] {};
   SDL_Texture* anim_pilot_fall_red {};
+  SDL_Rect anim_pilot_fall_red_rect[2] {};
   SDL_Texture* anim_pilot_fall_blue {};
-  SDL_Rect anim_pilot_fall_rect[2] {};
+  SDL_Rect anim_pilot_fall_blue_rect[2] {};
   SDL_Texture* anim_pilot_run_red {};
+  SDL_Rect anim_pilot_run_red_rect[3] {};
   SDL_Texture* anim_pilot_run_blue {};
-  SDL_Rect anim_pilot_run_rect[3] {};
+  SDL_Rect anim_pilot_run_blue_rect[3] {};
 
   SDL_Rect font_rect[95] {};
   SDL_Rect zeppelin_score_rect[20] {};
 
-  SDL_Texture** anim_background {};
+//  Resource cache id of the first frame,
+//  the rest of them follow in order
+  size_t anim_background {};
   size_t anim_background_frame_count {};
 
 
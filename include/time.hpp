@@ -23,4 +23,4 @@
 
 double countDelta();
 
-extern double deltaTime;
+extern thread_local double deltaTime;
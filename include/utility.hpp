@@ -31,6 +31,12 @@ bool initVitaFileSystem();
 #endif
 
 
+//  Prefix of the cached texture atlas files
+std::string get_atlas_cache_path();
+
+//  Chrome trace written on exit by profiler builds
+std::string get_trace_path();
+
 void settingsWrite();
 bool settingsParse( std::ifstream&, std::string& );
 void logVersionAndReadSettings();
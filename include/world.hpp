@@ -0,0 +1,77 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/fwd.hpp>
+#include <include/enums.hpp>
+#include <include/game_state.hpp>
+#include <include/simulation.hpp>
+#include <include/plane.hpp>
+#include <include/bullet.hpp>
+#include <include/cloud.hpp>
+#include <include/zeppelin.hpp>
+#include <include/effects.hpp>
+#include <include/ai_stuff.hpp>
+
+#include <map>
+#include <vector>
+
+
+//  Everything one running match owns. The game itself uses a
+//  single default world; the batch runner creates one per worker
+//  thread and binds it with bindWorld(), so that concurrent
+//  matches never share planes, bullets or AI state.
+
+struct World
+{
+  std::map <PLANE_TYPE, Plane> planes
+  {
+    {PLANE_TYPE::BLUE, {PLANE_TYPE::BLUE}},
+    {PLANE_TYPE::RED, {PLANE_TYPE::RED}},
+  };
+
+  Effects effects {};
+  BulletSpawner bullets {};
+  std::vector <Cloud> clouds {};
+  Zeppelin zeppelin {};
+
+  AiController aiController {};
+
+  GameState state {};
+
+  SimEventHandler eventHandler {};
+
+//  Set while rollback re-simulates past frames
+  bool isResimulating {};
+
+
+  World();
+
+  World( const World& ) = delete;
+  World& operator = ( const World& ) = delete;
+};
+
+
+World& world();
+
+//  Makes the given world current for the calling thread.
+//  nullptr restores the default world
+void bindWorld( World* );
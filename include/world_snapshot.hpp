@@ -0,0 +1,75 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <include/fwd.hpp>
+#include <include/enums.hpp>
+#include <include/timer.hpp>
+#include <include/plane.hpp>
+#include <include/bullet.hpp>
+#include <include/cloud.hpp>
+#include <include/zeppelin.hpp>
+#include <include/effects.hpp>
+#include <include/constants.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+//  Copy of everything that evolves during a match, stored in
+//  fixed-size arrays so that it can be taken every tick without
+//  touching the heap. AI state isn't captured: bots always run
+//  on the machine that owns them and never need rolling back.
+
+struct WorldSnapshot
+{
+//  Every bullet the pool can hold, dropping any would desync rollback
+  static constexpr size_t maxBullets {BulletSpawner::capacity};
+
+
+  Plane planes[2]
+  {
+    {PLANE_TYPE::BLUE},
+    {PLANE_TYPE::RED},
+  };
+
+  Bullet bullets[maxBullets] {};
+  uint16_t bulletCount {};
+
+  Effects effects {};
+
+  Cloud clouds[constants::cloud::count] {};
+  uint8_t cloudCount {};
+
+  Zeppelin zeppelin {};
+
+  bool isRoundFinished {};
+
+
+  WorldSnapshot() = default;
+
+  void save( const World& );
+  void restore( World& ) const;
+};
+
+static_assert(std::is_trivially_copyable_v <WorldSnapshot>);
+static_assert(WorldSnapshot::maxBullets <= UINT16_MAX);
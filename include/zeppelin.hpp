@@ -35,5 +35,3 @@ public:
   void Draw();
   void Respawn();
 };
-
-extern class Zeppelin zeppelin;
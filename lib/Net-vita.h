@@ -29,12 +29,13 @@
 #endif
 
 // Standard C++ includes
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <iomanip>
 #include <sstream>
-#include <list>
 #include <vector>
 #include <include/utility.hpp>
 
@@ -422,6 +423,47 @@ namespace net
       return received_bytes;
     }
 
+    // Batched I/O, one datagram per entry.
+    // On receive "size" holds the buffer capacity and is replaced by the received size.
+    // The Vita network stack has no sendmmsg/recvmmsg, so these loop over single datagrams
+    static constexpr int batch_size = 32;
+
+    struct Datagram
+    {
+      Address address;
+      unsigned char * data;
+      int size;
+    };
+
+    // Returns number of datagrams sent, stops at the first failure
+    int SendBatch( const Datagram datagrams[], int count )
+    {
+      int sent = 0;
+
+      while ( sent < count && Send( datagrams[sent].address, datagrams[sent].data, datagrams[sent].size ) )
+        ++sent;
+
+      return sent;
+    }
+
+    // Returns number of datagrams received, 0 once the socket is drained
+    int ReceiveBatch( Datagram datagrams[], int count )
+    {
+      int received = 0;
+
+      while ( received < count )
+      {
+        const int bytes = Receive( datagrams[received].address, datagrams[received].data, datagrams[received].size );
+
+        if ( bytes <= 0 )
+          break;
+
+        datagrams[received++].size = bytes;
+      }
+
+      return received;
+    }
+
   private:
     int socketHandle;
   };
@@ -481,6 +523,8 @@ namespace net
         bool connected = IsConnected();
         ClearData();
         socket.Close();
+        received_count = 0;
+        received_index = 0;
         running = false;
         if ( connected )
           OnDisconnect();
@@ -580,65 +624,81 @@ namespace net
     {
       assert( running );
 
-      if ( address.GetAddress() == 0 )
-        return false;
+      send_buffer.resize( size + 4 );
+      memcpy( &send_buffer[4], data, size );
 
-      static std::vector <uint8_t> packet {};
-      packet.resize(size + 4);
-      packet[0] = (unsigned char) ( protocolId >> 24 );
-      packet[1] = (unsigned char) ( ( protocolId >> 16 ) & 0xFF );
-      packet[2] = (unsigned char) ( ( protocolId >> 8 ) & 0xFF );
-      packet[3] = (unsigned char) ( ( protocolId ) & 0xFF );
-      memcpy( &packet[4], data, size );
-
-      return socket.Send( address, packet.data(), size + 4 );
+      return SendDatagram( size + 4 );
     }
 
-    virtual int ReceivePacket( unsigned char data[], const int size )
+    // next payload from the connected address, NULL once the socket is drained
+    //  + points into the receive arena, valid until the next call
+    virtual const unsigned char * ReceivePacket( int & size )
     {
       assert( running );
 
-      Address sender;
-      static std::vector <uint8_t> packet {};
-      packet.resize(size + 4);
+      while ( true )
+      {
+        if ( received_index == received_count )
+        {
+          received_index = 0;
+          received_count = ReceiveBatch();
 
-      int bytes_read = socket.Receive( sender, packet.data(), size + 4 );
-      if ( bytes_read == 0 )
-        return 0;
+          if ( received_count == 0 )
+            return NULL;
+        }
 
-      if ( bytes_read <= 4 )
-        return 0;
+        const Socket::Datagram & datagram = received[received_index++];
 
-      if ( packet[0] != (unsigned char) ( protocolId >> 24 ) ||
-           packet[1] != (unsigned char) ( ( protocolId >> 16 ) & 0xFF ) ||
-           packet[2] != (unsigned char) ( ( protocolId >> 8 ) & 0xFF ) ||
-           packet[3] != (unsigned char) ( protocolId & 0xFF ) )
-        return 0;
+        if ( datagram.size <= 4 )
+          continue;
 
-      if ( mode == Server && !IsConnected() )
-      {
-        state = Connected;
-        address = sender;
-        log_message( "NETWORK: New client connected from ", address.ToString(), "\n" );
-        OnConnect();
-      }
+        const unsigned char * packet = datagram.data;
 
-      if ( sender == address )
-      {
-        if ( mode == Client && state == Connecting )
+        if ( packet[0] != (unsigned char) ( protocolId >> 24 ) ||
+             packet[1] != (unsigned char) ( ( protocolId >> 16 ) & 0xFF ) ||
+             packet[2] != (unsigned char) ( ( protocolId >> 8 ) & 0xFF ) ||
+             packet[3] != (unsigned char) ( protocolId & 0xFF ) )
+          continue;
+
+        if ( mode == Server && !IsConnected() )
         {
-          log_message( "NETWORK: Successfully connected to server!\n" );
           state = Connected;
+          address = datagram.address;
+          log_message( "NETWORK: New client connected from ", address.ToString(), "\n" );
           OnConnect();
         }
 
-        timeoutAccumulator = 0.0f;
-        memcpy( data, &packet[4], bytes_read - 4 );
+        if ( datagram.address == address )
+        {
+          if ( mode == Client && state == Connecting )
+          {
+            log_message( "NETWORK: Successfully connected to server!\n" );
+            state = Connected;
+            OnConnect();
+          }
+
+          timeoutAccumulator = 0.0f;
 
-        return bytes_read - 4;
+          size = datagram.size - 4;
+          return packet + 4;
+        }
       }
+    }
+
+    // copies the next payload into "data", returns 0 once the socket is drained
+    int ReceivePacket( unsigned char data[], const int size )
+    {
+      int payload_size = 0;
+      const unsigned char * payload = ReceivePacket( payload_size );
+
+      if ( payload == NULL )
+        return 0;
 
-      return 0;
+      if ( payload_size > size )
+        payload_size = size;
+
+      memcpy( data, payload, payload_size );
+      return payload_size;
     }
 
     int GetHeaderSize() const
@@ -647,6 +707,22 @@ namespace net
     }
 
   protected:
+    // datagram being sent, each layer writes its header in place after the protocol id
+    std::vector <unsigned char> send_buffer;
+
+    bool SendDatagram( const int size )
+    {
+      if ( address.GetAddress() == 0 )
+        return false;
+
+      send_buffer[0] = (unsigned char) ( protocolId >> 24 );
+      send_buffer[1] = (unsigned char) ( ( protocolId >> 16 ) & 0xFF );
+      send_buffer[2] = (unsigned char) ( ( protocolId >> 8 ) & 0xFF );
+      send_buffer[3] = (unsigned char) ( ( protocolId ) & 0xFF );
+
+      return socket.Send( address, send_buffer.data(), size );
+    }
+
     virtual void OnStart()		{}
     virtual void OnStop()		{}
     virtual void OnConnect()    {}
@@ -678,13 +754,34 @@ namespace net
     State state;
     float timeoutAccumulator;
     Address address;
+
+    // larger datagrams are truncated, no game packet comes close
+    static constexpr int max_datagram_size = 1200;
+
+    std::vector <unsigned char> receive_arena;
+    Socket::Datagram received[Socket::batch_size];
+    int received_count = 0;
+    int received_index = 0;
+
+    int ReceiveBatch()
+    {
+      receive_arena.resize( Socket::batch_size * max_datagram_size );
+
+      for ( int i = 0; i < Socket::batch_size; ++i )
+      {
+        received[i].data = &receive_arena[i * max_datagram_size];
+        received[i].size = max_datagram_size;
+      }
+
+      return socket.ReceiveBatch( received, Socket::batch_size );
+    }
   };
 
   // reliability system
   struct PacketData
   {
     unsigned int sequence;			// packet sequence number
-    float time;					    // time offset since packet was sent or received (depending on context)
+    double time;					// time the packet was sent or received at (depending on context)
     int size;						// packet size in bytes
   };
 
@@ -698,74 +795,170 @@ namespace net
            ( ( s2 > s1 ) && ( s2 - s1 > half_sequence ) );
   }
 
+  // Number of sequences from s2 up to s1, accounting for wrap-around
+  inline unsigned int sequence_difference( unsigned int s1, unsigned int s2, unsigned int max_sequence ) noexcept
+  {
+    return s1 >= s2 ? s1 - s2 : max_sequence - s2 + s1 + 1;
+  }
+
+  inline unsigned int sequence_next( unsigned int sequence, unsigned int max_sequence ) noexcept
+  {
+    return sequence < max_sequence ? sequence + 1 : 0;
+  }
+
+  inline unsigned int sequence_previous( unsigned int sequence, unsigned int count, unsigned int max_sequence ) noexcept
+  {
+    return sequence >= count ? sequence - count : max_sequence - ( count - sequence - 1 );
+  }
+
   // Packet queue optimized for PS Vita memory constraints
-  // Maintains packets in sequence order, handling sequence wrap-around correctly
-  class PacketQueue : public std::list<PacketData>
+  // Fixed-size ring buffer indexed by sequence modulo its capacity:
+  // insert, lookup and erase are O(1) and never allocate.
+  // Holds packets of at most "capacity" consecutive sequences, older ones
+  // must be popped before inserting past that. Sequences map to distinct
+  // slots as long as ( max_sequence + 1 ) is a multiple of capacity
+  class PacketQueue
   {
   public:
+    static constexpr unsigned int capacity = 256;
+
+    PacketQueue() noexcept
+    {
+      clear();
+    }
+
+    void clear() noexcept
+    {
+      for ( auto& slot : valid )
+        slot = false;
+      count = 0;
+      first = 0;
+      last = 0;
+    }
+
+    bool empty() const noexcept
+    {
+      return count == 0;
+    }
+
+    unsigned int size() const noexcept
+    {
+      return count;
+    }
+
     // Check if a packet with given sequence number exists in the queue
-    // Optimized linear search - suitable for typical game network packet counts
     bool exists( unsigned int sequence ) const noexcept
     {
-      for ( const auto& packet : *this )
-        if ( packet.sequence == sequence )
-          return true;
-      return false;
+      const unsigned int index = sequence % capacity;
+      return valid[index] && entries[index].sequence == sequence;
+    }
+
+    PacketData* find( unsigned int sequence ) noexcept
+    {
+      return exists( sequence ) ? &entries[sequence % capacity] : nullptr;
     }
 
-    // Insert packet data maintaining sequence order
-    // Uses optimized insertion strategy: check ends first, then search middle
-    void insert_sorted( const PacketData& p, unsigned int max_sequence )
+    // Oldest packet
+    const PacketData& front() const noexcept
+    {
+      return entries[first % capacity];
+    }
+
+    // Most recent packet
+    const PacketData& back() const noexcept
+    {
+      return entries[last % capacity];
+    }
+
+    // Check if inserting a sequence keeps the queue within capacity
+    bool fits( unsigned int sequence, unsigned int max_sequence ) const noexcept
     {
       if ( empty() )
+        return true;
+
+      const unsigned int oldest = sequence_more_recent( first, sequence, max_sequence ) ? sequence : first;
+      const unsigned int newest = sequence_more_recent( sequence, last, max_sequence ) ? sequence : last;
+      return sequence_difference( newest, oldest, max_sequence ) < capacity;
+    }
+
+    void insert( const PacketData& p, unsigned int max_sequence ) noexcept
+    {
+      assert( !exists( p.sequence ) ); // Duplicate sequences not allowed
+      assert( fits( p.sequence, max_sequence ) );
+
+      const unsigned int index = p.sequence % capacity;
+      entries[index] = p;
+      valid[index] = true;
+
+      if ( count++ == 0 )
       {
-        push_back( p );
+        first = p.sequence;
+        last = p.sequence;
         return;
       }
 
-      // Fast path: check if packet belongs at the beginning
-      if ( !sequence_more_recent( p.sequence, front().sequence, max_sequence ) )
-      {
-        push_front( p );
+      if ( sequence_more_recent( first, p.sequence, max_sequence ) )
+        first = p.sequence;
+
+      if ( sequence_more_recent( p.sequence, last, max_sequence ) )
+        last = p.sequence;
+    }
+
+    void erase( unsigned int sequence, unsigned int max_sequence ) noexcept
+    {
+      if ( !exists( sequence ) )
         return;
-      }
 
-      // Fast path: check if packet belongs at the end
-      if ( sequence_more_recent( p.sequence, back().sequence, max_sequence ) )
-      {
-        push_back( p );
+      valid[sequence % capacity] = false;
+
+      if ( --count == 0 )
         return;
-      }
 
-      // Slower path: find correct position in middle
-      for ( auto itor = begin(); itor != end(); ++itor )
-      {
-        assert( itor->sequence != p.sequence ); // Duplicate sequences not allowed
-        if ( sequence_more_recent( itor->sequence, p.sequence, max_sequence ) )
-        {
-          insert( itor, p );
-          return;
-        }
-      }
+      // Skip holes, so that front and back stay valid
+      if ( sequence == first )
+        while ( !exists( first ) )
+          first = sequence_next( first, max_sequence );
+
+      if ( sequence == last )
+        while ( !exists( last ) )
+          last = sequence_previous( last, 1, max_sequence );
+    }
+
+    void pop_front( unsigned int max_sequence ) noexcept
+    {
+      erase( first, max_sequence );
     }
 
-    // Debug function to verify queue is properly sorted
+    // Debug function to verify queue bookkeeping
     // Only compiled in debug builds to avoid performance impact
     void verify_sorted( unsigned int max_sequence ) const
     {
 #ifdef _DEBUG
-      auto prev = end();
-      for ( auto itor = begin(); itor != end(); ++itor )
+      if ( empty() )
+        return;
+
+      assert( exists( first ) );
+      assert( exists( last ) );
+      assert( sequence_difference( last, first, max_sequence ) < capacity );
+
+      unsigned int found = 0;
+      for ( unsigned int sequence = first; ; sequence = sequence_next( sequence, max_sequence ) )
       {
-        if ( prev != end() )
-        {
-          assert( prev->sequence != itor->sequence );
-          assert( sequence_more_recent( itor->sequence, prev->sequence, max_sequence ) );
-        }
-        prev = itor;
+        if ( exists( sequence ) )
+          ++found;
+        if ( sequence == last )
+          break;
       }
+      assert( found == count );
 #endif
     }
+
+  private:
+    PacketData entries[capacity];
+    bool valid[capacity];
+    unsigned int count;
+    unsigned int first; // Sequence of the oldest packet
+    unsigned int last;  // Sequence of the most recent packet
   };
 
   class ReliabilitySystem
@@ -789,30 +982,42 @@ namespace net
       recv_packets = 0;
       lost_packets = 0;
       acked_packets = 0;
+      sent_bytes = 0;
       sent_bandwidth = 0.0f;
       acked_bandwidth = 0.0f;
       rtt = 0.0f;
       rtt_maximum = 1.0f;
+      time = 0.0;
     }
 
     void PacketSent( int size )
     {
       if ( sent_queue.exists( local_sequence ) )
-      {
         log_message( "NETWORK: local sequence ", std::to_string(local_sequence), " exists\n" );
-        for ( PacketQueue::iterator itor = sent_queue.begin(); itor != sent_queue.end(); ++itor )
-        {
-          log_message( "NETWORK: + ", std::to_string(itor->sequence), "\n" );
-        }
-      }
+
       assert( !sent_queue.exists( local_sequence ) );
       assert( !pending_ack_queue.exists( local_sequence ) );
       PacketData data;
       data.sequence = local_sequence;
-      data.time = 0.0f;
+      data.time = time;
       data.size = size;
-      sent_queue.push_back( data );
-      pending_ack_queue.push_back( data );
+
+      // Make room when sending faster than the queues can hold
+      while ( !sent_queue.fits( local_sequence, max_sequence ) )
+      {
+        sent_bytes -= sent_queue.front().size;
+        sent_queue.pop_front( max_sequence );
+      }
+
+      while ( !pending_ack_queue.fits( local_sequence, max_sequence ) )
+      {
+        pending_ack_queue.pop_front( max_sequence );
+        lost_packets++;
+      }
+
+      sent_queue.insert( data, max_sequence );
+      pending_ack_queue.insert( data, max_sequence );
+      sent_bytes += size;
       sent_packets++;
       local_sequence++;
       if ( local_sequence > max_sequence )
@@ -824,11 +1029,22 @@ namespace net
       recv_packets++;
       if ( received_queue.exists( sequence ) )
         return;
+
+      if ( !received_queue.fits( sequence, max_sequence ) )
+      {
+        // Too old to be acknowledged anyway
+        if ( !sequence_more_recent( sequence, received_queue.back().sequence, max_sequence ) )
+          return;
+
+        while ( !received_queue.fits( sequence, max_sequence ) )
+          received_queue.pop_front( max_sequence );
+      }
+
       PacketData data;
       data.sequence = sequence;
-      data.time = 0.0f;
+      data.time = time;
       data.size = size;
-      received_queue.insert_sorted( data, max_sequence );
+      received_queue.insert( data, max_sequence );
       if ( sequence_more_recent( sequence, remote_sequence, max_sequence ) )
         remote_sequence = sequence;
     }
@@ -838,15 +1054,22 @@ namespace net
       return generate_ack_bits( remote_sequence, received_queue, max_sequence );
     }
 
+    // Process acknowledgment packet to update RTT and move packets from pending to acked
+    // Each acknowledged sequence is looked up directly instead of scanning the pending queue
     void ProcessAck( unsigned int ack, unsigned int ack_bits )
     {
-      process_ack( ack, ack_bits, pending_ack_queue, acked_queue, acks, acked_packets, rtt, max_sequence );
+      // Oldest first, so that RTT is smoothed in sending order
+      for ( int bit_index = 31; bit_index >= 0; --bit_index )
+        if ( ack_bits & (1U << bit_index) )
+          PacketAcked( sequence_previous( ack, bit_index + 1, max_sequence ) );
+
+      PacketAcked( ack );
     }
 
     void Update( const double deltaTime )
     {
       acks.clear();
-      AdvanceQueueTime( deltaTime );
+      time += deltaTime;
       UpdateQueues();
       UpdateStats();
     }
@@ -865,109 +1088,18 @@ namespace net
              ( ( s2 > s1 ) && ( s2 - s1 > max_sequence/2 ) );
     }
 
-    // Calculate bit index for sequence number in acknowledgment bitfield
-    // Returns the bit position (0-31) for a sequence in the 32-bit ack_bits field
-    // Returns -1 if sequence shouldn't be represented in the bitfield
-    static int bit_index_for_sequence( unsigned int sequence, unsigned int ack, unsigned int max_sequence ) noexcept
-    {
-      // Sequence equal to ack is handled separately, not in bitfield
-      if ( sequence == ack )
-        return -1;
-
-      // Calculate bit index based on sequence age relative to ack
-      // This handles wrap-around correctly for sequence numbers
-      if ( !sequence_more_recent( sequence, ack, max_sequence ) )
-      {
-        // Sequence is older than ack, calculate its bit position
-        if ( ack >= sequence )
-        {
-          const unsigned int diff = ack - sequence;
-          return diff <= 32 ? static_cast<int>(diff - 1) : -1;
-        }
-        else
-        {
-          // Handle wrap-around case
-          const unsigned int diff = (max_sequence - sequence) + ack + 1;
-          return diff <= 32 ? static_cast<int>(diff - 1) : -1;
-        }
-      }
-      
-      // Sequence is newer than ack, shouldn't be in bitfield
-      return -1;
-    }
-
     // Generate 32-bit acknowledgment bitfield for reliable packet delivery
     // Each bit represents whether a packet sequence was received (1) or not (0)
     // Bit 0 = ack-1, Bit 1 = ack-2, etc. (up to 32 sequences back)
     static unsigned int generate_ack_bits( unsigned int ack, const PacketQueue& received_queue, unsigned int max_sequence ) noexcept
     {
       unsigned int ack_bits = 0;
-      
-      // Iterate through received packets to build acknowledgment bitfield
-      for ( const auto& packet : received_queue )
-      {
-        // Skip packets that are the ack sequence itself or newer
-        if ( packet.sequence == ack || sequence_more_recent( packet.sequence, ack, max_sequence ) )
-          continue;
 
-        // Calculate bit position for this sequence
-        const int bit_index = bit_index_for_sequence( packet.sequence, ack, max_sequence );
-        if ( bit_index >= 0 && bit_index <= 31 )
-        {
+      for ( int bit_index = 0; bit_index < 32; ++bit_index )
+        if ( received_queue.exists( sequence_previous( ack, bit_index + 1, max_sequence ) ) )
           ack_bits |= (1U << bit_index);
-        }
-      }
-      
-      return ack_bits;
-    }
-
-    // Process acknowledgment packet to update RTT and move packets from pending to acked
-    // This is the core of the reliability system - handles both direct acks and bitfield acks
-    static void process_ack( unsigned int ack, unsigned int ack_bits,
-                           PacketQueue& pending_ack_queue, PacketQueue& acked_queue,
-                           std::vector<unsigned int>& acks, unsigned int& acked_packets,
-                           float& rtt, unsigned int max_sequence )
-    {
-      if ( pending_ack_queue.empty() )
-        return;
-
-      // Process all packets in pending acknowledgment queue
-      auto itor = pending_ack_queue.begin();
-      while ( itor != pending_ack_queue.end() )
-      {
-        bool packet_acked = false;
 
-        // Check if this packet is directly acknowledged
-        if ( itor->sequence == ack )
-        {
-          packet_acked = true;
-        }
-        // Check if packet is acknowledged via bitfield (for older packets)
-        else if ( !sequence_more_recent( itor->sequence, ack, max_sequence ) )
-        {
-          const int bit_index = bit_index_for_sequence( itor->sequence, ack, max_sequence );
-          if ( bit_index >= 0 && bit_index <= 31 )
-          {
-            packet_acked = (ack_bits & (1U << bit_index)) != 0;
-          }
-        }
-
-        if ( packet_acked )
-        {
-          // Update RTT using exponential smoothing (10% of new sample)
-          rtt += ( itor->time - rtt ) * 0.1f;
-
-          // Move packet from pending to acked queue
-          acked_queue.insert_sorted( *itor, max_sequence );
-          acks.push_back( itor->sequence );
-          ++acked_packets;
-          itor = pending_ack_queue.erase( itor );
-        }
-        else
-        {
-          ++itor;
-        }
-      }
+      return ack_bits;
     }
 
     unsigned int GetLocalSequence() const
@@ -1037,72 +1169,85 @@ namespace net
     }
 
   private:
-    void AdvanceQueueTime( float deltaTime )
+    void PacketAcked( unsigned int sequence )
     {
-      for ( PacketQueue::iterator itor = sent_queue.begin(); itor != sent_queue.end(); ++itor )
-        itor->time += deltaTime;
+      const PacketData* packet = pending_ack_queue.find( sequence );
+      if ( packet == nullptr )
+        return;
+
+      const PacketData data = *packet;
+      pending_ack_queue.erase( sequence, max_sequence );
 
-      for ( PacketQueue::iterator itor = received_queue.begin(); itor != received_queue.end(); ++itor )
-        itor->time += deltaTime;
+      // Update RTT using exponential smoothing (10% of new sample)
+      rtt += ( static_cast<float>( time - data.time ) - rtt ) * 0.1f;
 
-      for ( PacketQueue::iterator itor = pending_ack_queue.begin(); itor != pending_ack_queue.end(); ++itor )
-        itor->time += deltaTime;
+      // Move packet from pending to acked queue
+      while ( !acked_queue.fits( sequence, max_sequence ) )
+        acked_queue.pop_front( max_sequence );
 
-      for ( PacketQueue::iterator itor = acked_queue.begin(); itor != acked_queue.end(); ++itor )
-        itor->time += deltaTime;
+      acked_queue.insert( data, max_sequence );
+      acks.push_back( sequence );
+      ++acked_packets;
     }
 
     void UpdateQueues()
     {
       const float epsilon = 0.001f;
 
-      while ( sent_queue.size() && sent_queue.front().time > rtt_maximum + epsilon )
+      while ( sent_queue.size() && time - sent_queue.front().time > rtt_maximum + epsilon )
       {
-        sent_queue.pop_front();
+        sent_bytes -= sent_queue.front().size;
+        sent_queue.pop_front( max_sequence );
       }
 
       if ( received_queue.size() )
       {
         const unsigned int latest_sequence = received_queue.back().sequence;
-        const unsigned int minimum_sequence = latest_sequence >= 34 ? ( latest_sequence - 34 ) : max_sequence - ( 34 - latest_sequence );
+        const unsigned int minimum_sequence = sequence_previous( latest_sequence, 34, max_sequence );
         while ( received_queue.size() && ( !sequence_more_recent( received_queue.front().sequence, minimum_sequence, max_sequence ) ) )
         {
-          received_queue.pop_front();
+          received_queue.pop_front( max_sequence );
         }
       }
 
-      while ( acked_queue.size() && acked_queue.front().time > rtt_maximum * 2 - epsilon )
+      while ( acked_queue.size() && time - acked_queue.front().time > rtt_maximum * 2 - epsilon )
       {
-        acked_queue.pop_front();
+        acked_queue.pop_front( max_sequence );
       }
 
-      while ( pending_ack_queue.size() && pending_ack_queue.front().time > rtt_maximum + epsilon )
+      while ( pending_ack_queue.size() && time - pending_ack_queue.front().time > rtt_maximum + epsilon )
       {
-        pending_ack_queue.pop_front();
+        pending_ack_queue.pop_front( max_sequence );
         lost_packets++;
       }
     }
 
     // Update bandwidth statistics based on recent packet history
-    // Calculates both sent and acknowledged bandwidth for network monitoring
+    // Sent byte count is kept up to date as packets enter and leave the sent queue
     void UpdateStats() noexcept
     {
-      // Calculate total bytes sent within the RTT window
-      int total_sent_bytes = 0;
-      for ( const auto& packet : sent_queue )
-        total_sent_bytes += packet.size;
-
       // Calculate bytes that were acknowledged within reasonable time
+      // Acked packets are ordered by send time, so the older ones come first
       int total_acked_bytes = 0;
-      for ( const auto& packet : acked_queue )
+      if ( !acked_queue.empty() )
       {
-        if ( packet.time >= rtt_maximum )
-          total_acked_bytes += packet.size;
+        for ( unsigned int sequence = acked_queue.front().sequence; ; sequence = sequence_next( sequence, max_sequence ) )
+        {
+          const PacketData* packet = acked_queue.find( sequence );
+          if ( packet != nullptr )
+          {
+            if ( time - packet->time < rtt_maximum )
+              break;
+            total_acked_bytes += packet->size;
+          }
+          if ( sequence == acked_queue.back().sequence )
+            break;
+        }
       }
 
       // Convert to bandwidth (bytes per second, then to kilobits per second)
       const float time_window = rtt_maximum > 0.0f ? rtt_maximum : 1.0f;
-      sent_bandwidth = static_cast<float>(total_sent_bytes) / time_window;
+      sent_bandwidth = static_cast<float>(sent_bytes) / time_window;
       acked_bandwidth = static_cast<float>(total_acked_bytes) / time_window;
     }
 
@@ -1118,10 +1263,12 @@ namespace net
     unsigned int recv_packets;
     unsigned int lost_packets;
     unsigned int acked_packets;
+    int sent_bytes;
     float sent_bandwidth;
     float acked_bandwidth;
     float rtt;
     float rtt_maximum;
+    double time; // Time since reset, packet times are relative to it
   };
 
   class ReliableConnection : public Connection
@@ -1144,50 +1291,55 @@ namespace net
     bool SendPacket( const unsigned char data[], int size )
     {
       const int header = 12;
-      static std::vector <uint8_t> packet {};
-      packet.resize(header + size);
+      const int offset = Connection::GetHeaderSize() + header;
+      send_buffer.resize( offset + size );
 
       unsigned int seq = reliabilitySystem.GetLocalSequence();
       unsigned int ack = reliabilitySystem.GetRemoteSequence();
       unsigned int ack_bits = reliabilitySystem.GenerateAckBits();
 
-      WriteHeader( packet.data(), seq, ack, ack_bits );
-      memcpy( packet.data() + header, data, size );
+      WriteHeader( &send_buffer[Connection::GetHeaderSize()], seq, ack, ack_bits );
+      memcpy( &send_buffer[offset], data, size );
 
-      if ( !Connection::SendPacket( packet.data(), size + header ) )
+      if ( !SendDatagram( offset + size ) )
         return false;
 
       reliabilitySystem.PacketSent( size );
       return true;
     }
 
-    int ReceivePacket( unsigned char data[], int size )
+    using Connection::ReceivePacket;
+
+    // skips packets older than the most recent one received
+    const unsigned char * ReceivePacket( int & size )
     {
       const int header = 12;
-      static std::vector <uint8_t> packet {};
-      packet.resize(header + size);
 
-      int received_bytes = Connection::ReceivePacket( packet.data(), size + header );
+      while ( true )
+      {
+        int received_bytes = 0;
+        const unsigned char * packet = Connection::ReceivePacket( received_bytes );
 
-      if ( received_bytes == 0 )
-        return 0;
+        if ( packet == NULL )
+          return NULL;
 
-      if ( received_bytes <= header )
-        return 0;
+        if ( received_bytes <= header )
+          continue;
 
-      unsigned int packet_sequence = 0;
-      unsigned int packet_ack = 0;
-      unsigned int packet_ack_bits = 0;
+        unsigned int packet_sequence = 0;
+        unsigned int packet_ack = 0;
+        unsigned int packet_ack_bits = 0;
 
-      ReadHeader( packet.data(), packet_sequence, packet_ack, packet_ack_bits );
-      reliabilitySystem.PacketReceived( packet_sequence, received_bytes - header );
-      reliabilitySystem.ProcessAck( packet_ack, packet_ack_bits );
+        ReadHeader( packet, packet_sequence, packet_ack, packet_ack_bits );
+        reliabilitySystem.PacketReceived( packet_sequence, received_bytes - header );
+        reliabilitySystem.ProcessAck( packet_ack, packet_ack_bits );
 
-      if ( packet_sequence != reliabilitySystem.GetRemoteSequence() )
-        return 0;
+        if ( packet_sequence != reliabilitySystem.GetRemoteSequence() )
+          continue;
 
-      memcpy( data, packet.data() + header, received_bytes - header );
-      return received_bytes - header;
+        size = received_bytes - header;
+        return packet + header;
+      }
     }
 
     void Update( const double deltaTime )
@@ -1254,9 +1406,30 @@ namespace net
     ReliabilitySystem reliabilitySystem;	// reliability system: manages sequence numbers and acks, tracks network stats etc.
   };
 
+  // flow control
+  //  + Good/Bad mode only tells whether the connection is stable enough to play
+  //  + send rate drops by a factor whenever rtt, packet loss or acked bandwidth exceed
+  //    the policy, at most once per round trip, and creeps back up while all of them are good
+  //  + full state goes out with every packet at the top rate only, and with fewer
+  //    and fewer of them as the send rate drops towards its minimum
+
   class FlowControl
   {
   public:
+    struct Policy
+    {
+      float rtt_good = 100.0f;            // milliseconds
+      float rtt_bad = 250.0f;
+      float loss_good = 2.0f;             // percent of sent packets
+      float loss_bad = 10.0f;
+      float max_bandwidth = 0.0f;         // acked kbit/s, zero for unlimited
+      float max_send_rate = 60.0f;        // packets per second
+      float min_send_rate = 30.0f;
+      float send_rate_increase = 5.0f;    // packets per second, every second
+      float send_rate_decrease = 0.75f;
+      unsigned int max_state_interval = 4;
+    };
+
     FlowControl()
     {
       log_message( "NETWORK: Flow control initialized!\n" );
@@ -1269,15 +1442,77 @@ namespace net
       penalty_time = 4.0f;
       good_conditions_time = 0.0f;
       penalty_reduction_accumulator = 0.0f;
+
+      send_rate = policy.max_send_rate;
+      decrease_cooldown = 0.0f;
+      state_interval = 1;
+      packets_since_state = 0;
+
+      loss = 0.0f;
+      loss_time = 0.0f;
+      loss_sent_packets = 0;
+      loss_lost_packets = 0;
+    }
+
+    void SetPolicy( const Policy & policy )
+    {
+      this->policy = policy;
+      send_rate = std::min( std::max( send_rate, policy.min_send_rate ), policy.max_send_rate );
+      UpdateStateInterval();
+    }
+
+    const Policy & GetPolicy() const
+    {
+      return policy;
+    }
+
+    void Update( const ReliabilitySystem & reliability, const double deltaTime )
+    {
+      const float rtt = reliability.GetRoundTripTime() * 1000.0f;
+
+      UpdateLoss( reliability, deltaTime );
+      UpdateSendRate( rtt, reliability.GetAckedBandwidth(), deltaTime );
+      UpdateMode( rtt, deltaTime );
+    }
+
+    bool IsConnectionStable() const
+    {
+      return mode == Good;
     }
 
-    void Update( const float rtt, const double deltaTime )
+    float GetSendRate() const
     {
-      const float RTT_Threshold = 250.0f;
+      return send_rate;
+    }
+
+    float GetPacketLoss() const
+    {
+      return loss;
+    }
+
+    unsigned int GetStateInterval() const
+    {
+      return state_interval;
+    }
+
+    // call once for every packet sent, tells whether it carries the full state
+    bool ShouldSendState()
+    {
+      if ( ++packets_since_state < state_interval )
+        return false;
+
+      packets_since_state = 0;
+      return true;
+    }
+
+  private:
+    void UpdateMode( const float rtt, const double deltaTime )
+    {
+      const bool isBad = rtt > policy.rtt_bad || loss > policy.loss_bad;
 
       if ( mode == Good )
       {
-        if ( rtt > RTT_Threshold )
+        if ( isBad )
         {
           log_message( "NETWORK: Dropping to bad mode!\n" );
           mode = Bad;
@@ -1310,7 +1545,7 @@ namespace net
 
       if ( mode == Bad )
       {
-        if ( rtt <= RTT_Threshold )
+        if ( !isBad )
           good_conditions_time += deltaTime;
         else
           good_conditions_time = 0.0f;
@@ -1326,22 +1561,96 @@ namespace net
       }
     }
 
-    bool IsConnectionStable() const
+    // lost packets are only counted a second after they were sent,
+    // so loss is measured over whole seconds
+    void UpdateLoss( const ReliabilitySystem & reliability, const double deltaTime )
     {
-      return mode == Good;
+      const unsigned int sent_packets = reliability.GetSentPackets();
+      const unsigned int lost_packets = reliability.GetLostPackets();
+
+      if ( sent_packets < loss_sent_packets || lost_packets < loss_lost_packets )
+      {
+        loss_sent_packets = sent_packets;
+        loss_lost_packets = lost_packets;
+      }
+
+      loss_time += deltaTime;
+
+      if ( loss_time < 1.0f )
+        return;
+
+      loss_time = 0.0f;
+
+      const unsigned int sent = sent_packets - loss_sent_packets;
+      const unsigned int lost = lost_packets - loss_lost_packets;
+
+      loss_sent_packets = sent_packets;
+      loss_lost_packets = lost_packets;
+
+      if ( sent == 0 )
+        return;
+
+      const float sample = 100.0f * std::min( lost, sent ) / sent;
+      loss += ( sample - loss ) * 0.5f;
+    }
+
+    void UpdateSendRate( const float rtt, const float acked_bandwidth, const double deltaTime )
+    {
+      const bool isOverBandwidth =
+        policy.max_bandwidth > 0.0f && acked_bandwidth > policy.max_bandwidth;
+
+      decrease_cooldown -= deltaTime;
+
+      if ( rtt > policy.rtt_bad || loss > policy.loss_bad || isOverBandwidth )
+      {
+        if ( decrease_cooldown > 0.0f )
+          return;
+
+        decrease_cooldown = std::max( rtt, 100.0f ) / 1000.0f;
+        send_rate = std::max( send_rate * policy.send_rate_decrease, policy.min_send_rate );
+      }
+      else if ( rtt < policy.rtt_good && loss < policy.loss_good )
+        send_rate = std::min( send_rate + float( policy.send_rate_increase * deltaTime ), policy.max_send_rate );
+
+      UpdateStateInterval();
+    }
+
+    void UpdateStateInterval()
+    {
+      const float range = policy.max_send_rate - policy.min_send_rate;
+
+      const float congestion =
+        range > 0.0f
+        ? ( policy.max_send_rate - send_rate ) / range
+        : 0.0f;
+
+      const unsigned int max_interval = std::max( policy.max_state_interval, 1u );
+
+      state_interval = 1 + (unsigned int) std::lround( congestion * ( max_interval - 1 ) );
     }
 
-  private:
     enum Mode
     {
       Good,
       Bad
     };
 
+    Policy policy;
+
     Mode mode;
     float penalty_time;
     float good_conditions_time;
     float penalty_reduction_accumulator;
+
+    float send_rate;
+    float decrease_cooldown;
+    unsigned int state_interval;
+    unsigned int packets_since_state;
+
+    float loss;
+    float loss_time;
+    unsigned int loss_sent_packets;
+    unsigned int loss_lost_packets;
   };
 
 } // namespace net
@@ -24,18 +24,23 @@
   #include <unistd.h>
   #include <arpa/inet.h>
   #include <netdb.h>
+  #include <sys/socket.h>
 
 #else
   static_assert(false, "Net.h is incompatible with your system");
 
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <fstream>
 #include <iomanip>
+#include <random>
 #include <sstream>
-#include <list>
 #include <vector>
 
 #include <include/utility.hpp>
@@ -234,6 +239,174 @@ namespace net
   }
 
 
+  // link conditioner, degrades outgoing traffic of a socket to test the netcode on a bad network
+  //  + every datagram is delayed by "latency" plus a random "jitter", both in milliseconds
+  //  + "loss" and "duplicate" percent of datagrams are dropped or sent twice
+  //  + "reorder" percent of datagrams are held back by another "reorder_delay" milliseconds
+  //  + config files hold one "key value" pair per line, '#' starts a comment
+
+  class LinkConditioner
+  {
+  public:
+
+    struct Config
+    {
+      float latency = 0.0f;
+      float jitter = 0.0f;
+      float loss = 0.0f;
+      float duplicate = 0.0f;
+      float reorder = 0.0f;
+      float reorder_delay = 50.0f;
+    };
+
+    LinkConditioner( unsigned int seed = std::random_device{}() )
+      : random( seed )
+    {
+    }
+
+    void SetConfig( const Config & config )
+    {
+      this->config = config;
+    }
+
+    const Config & GetConfig() const
+    {
+      return config;
+    }
+
+    bool LoadConfig( const std::string & filename )
+    {
+      std::ifstream file( filename );
+
+      if ( !file.is_open() )
+      {
+        log_message( "NETWORK: Failed to open link conditioner config '", filename, "'\n" );
+        return false;
+      }
+
+      Config loaded = config;
+      std::string line;
+
+      while ( std::getline( file, line ) )
+      {
+        std::istringstream stream( line.substr( 0, line.find( '#' ) ) );
+        std::string key;
+        float value = 0.0f;
+
+        if ( !( stream >> key ) )
+          continue;
+
+        if ( !( stream >> value ) || value < 0.0f )
+        {
+          log_message( "NETWORK: Bad link conditioner value of '", key, "'\n" );
+          return false;
+        }
+
+        if ( key == "latency" )
+          loaded.latency = value;
+        else if ( key == "jitter" )
+          loaded.jitter = value;
+        else if ( key == "loss" )
+          loaded.loss = value;
+        else if ( key == "duplicate" )
+          loaded.duplicate = value;
+        else if ( key == "reorder" )
+          loaded.reorder = value;
+        else if ( key == "reorder_delay" )
+          loaded.reorder_delay = value;
+        else
+        {
+          log_message( "NETWORK: Unknown link conditioner key '", key, "'\n" );
+          return false;
+        }
+      }
+
+      config = loaded;
+      return true;
+    }
+
+    // queues copies of the datagram to be sent later, or none at all
+    void Enqueue( const Address & destination, const void * data, int size )
+    {
+      if ( Chance( config.loss ) )
+        return;
+
+      const int copies = Chance( config.duplicate ) ? 2 : 1;
+
+      for ( int i = 0; i < copies; ++i )
+      {
+        float delay = config.latency + config.jitter * Random();
+
+        if ( Chance( config.reorder ) )
+          delay += config.reorder_delay;
+
+        Pending pending;
+        pending.time = Now() + delay / 1000.0;
+        pending.address = destination;
+        pending.data.assign( (const unsigned char*) data, (const unsigned char*) data + size );
+
+        queue.push_back( std::move( pending ) );
+        std::push_heap( queue.begin(), queue.end(), Later );
+      }
+    }
+
+    // takes the next datagram due to be sent, returns false if none is due yet
+    bool Dequeue( Address & destination, std::vector <unsigned char> & data )
+    {
+      if ( queue.empty() || queue.front().time > Now() )
+        return false;
+
+      std::pop_heap( queue.begin(), queue.end(), Later );
+
+      destination = queue.back().address;
+      data.swap( queue.back().data );
+      queue.pop_back();
+
+      return true;
+    }
+
+    void Clear()
+    {
+      queue.clear();
+    }
+
+  private:
+
+    struct Pending
+    {
+      double time;
+      Address address;
+      std::vector <unsigned char> data;
+    };
+
+    static bool Later( const Pending & lhs, const Pending & rhs )
+    {
+      return lhs.time > rhs.time;
+    }
+
+    static double Now()
+    {
+      return std::chrono::duration <double> (
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    float Random()
+    {
+      return std::uniform_real_distribution <float> ( 0.0f, 1.0f ) ( random );
+    }
+
+    bool Chance( float percent )
+    {
+      return percent > 0.0f && Random() * 100.0f < percent;
+    }
+
+    Config config;
+    std::mt19937 random;
+    std::vector <Pending> queue;		// heap ordered by send time, earliest first
+  };
+
+  // socket
+
   class Socket
   {
   public:
@@ -241,6 +414,7 @@ namespace net
     Socket()
     {
       socketHandle = 0;
+      conditioner = NULL;
     }
 
     ~Socket()
@@ -321,6 +495,15 @@ namespace net
       return socketHandle != 0;
     }
 
+    // conditions outgoing traffic until reset to NULL, must outlive the socket
+    void SetConditioner( LinkConditioner * conditioner )
+    {
+      if ( this->conditioner != NULL )
+        this->conditioner->Clear();
+
+      this->conditioner = conditioner;
+    }
+
     bool Send( const Address & destination, const void * data, int size )
     {
       assert( data );
@@ -329,17 +512,14 @@ namespace net
       if ( socketHandle == 0 )
         return false;
 
-      assert( destination.GetAddress() != 0 );
-      assert( destination.GetPort() != 0 );
-
-      sockaddr_in address;
-      address.sin_family = AF_INET;
-      address.sin_addr.s_addr = htonl( destination.GetAddress() );
-      address.sin_port = htons( (unsigned short) destination.GetPort() );
-
-      int sent_bytes = sendto( socketHandle, (const char*)data, size, 0, (sockaddr*)&address, sizeof(sockaddr_in) );
+      if ( conditioner != NULL )
+      {
+        conditioner->Enqueue( destination, data, size );
+        SendConditioned();
+        return true;
+      }
 
-      return sent_bytes == size;
+      return SendTo( destination, data, size );
     }
 
     int Receive( Address & sender, void * data, int size )
@@ -350,6 +530,9 @@ namespace net
       if ( socketHandle == 0 )
         return false;
 
+      if ( conditioner != NULL )
+        SendConditioned();
+
       #if PLATFORM == PLATFORM_WINDOWS
         typedef int socklen_t;
       #endif
@@ -376,9 +559,179 @@ namespace net
     }
 
 
+    // batched io, one datagram per entry
+    //  + on receive "size" holds the buffer capacity and is replaced by the received size
+    //  + linux moves a whole batch per syscall, other systems fall back to one datagram at a time
+
+    static constexpr int batch_size = 32;
+
+    struct Datagram
+    {
+      Address address;
+      unsigned char * data;
+      int size;
+    };
+
+    // returns number of datagrams sent, stops at the first failure
+    int SendBatch( const Datagram datagrams[], int count )
+    {
+      if ( socketHandle == 0 )
+        return 0;
+
+      #if defined(__linux__)
+
+        if ( conditioner != NULL )
+          return SendEach( datagrams, count );
+
+        int sent = 0;
+
+        while ( sent < count )
+        {
+          sockaddr_in addresses[batch_size];
+          iovec vectors[batch_size];
+          mmsghdr messages[batch_size];
+
+          const int batch = std::min( count - sent, batch_size );
+
+          for ( int i = 0; i < batch; ++i )
+          {
+            const Datagram & datagram = datagrams[sent + i];
+
+            assert( datagram.address.GetAddress() != 0 );
+            assert( datagram.address.GetPort() != 0 );
+
+            addresses[i] = {};
+            addresses[i].sin_family = AF_INET;
+            addresses[i].sin_addr.s_addr = htonl( datagram.address.GetAddress() );
+            addresses[i].sin_port = htons( (unsigned short) datagram.address.GetPort() );
+
+            vectors[i].iov_base = datagram.data;
+            vectors[i].iov_len = datagram.size;
+
+            messages[i] = {};
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+          }
+
+          const int result = sendmmsg( socketHandle, messages, batch, 0 );
+
+          if ( result <= 0 )
+            break;
+
+          sent += result;
+        }
+
+        return sent;
+
+      #else
+
+        return SendEach( datagrams, count );
+
+      #endif
+    }
+
+    // returns number of datagrams received, 0 once the socket is drained
+    int ReceiveBatch( Datagram datagrams[], int count )
+    {
+      if ( socketHandle == 0 )
+        return 0;
+
+      if ( conditioner != NULL )
+        SendConditioned();
+
+      #if defined(__linux__)
+
+        sockaddr_in addresses[batch_size];
+        iovec vectors[batch_size];
+        mmsghdr messages[batch_size];
+
+        const int batch = std::min( count, batch_size );
+
+        for ( int i = 0; i < batch; ++i )
+        {
+          vectors[i].iov_base = datagrams[i].data;
+          vectors[i].iov_len = datagrams[i].size;
+
+          messages[i] = {};
+          messages[i].msg_hdr.msg_name = &addresses[i];
+          messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+          messages[i].msg_hdr.msg_iov = &vectors[i];
+          messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int result = recvmmsg( socketHandle, messages, batch, MSG_DONTWAIT, NULL );
+
+        if ( result <= 0 )
+          return 0;
+
+        for ( int i = 0; i < result; ++i )
+        {
+          datagrams[i].address = Address( ntohl( addresses[i].sin_addr.s_addr ), ntohs( addresses[i].sin_port ) );
+          datagrams[i].size = messages[i].msg_len;
+        }
+
+        return result;
+
+      #else
+
+        int received = 0;
+
+        while ( received < count )
+        {
+          const int bytes = Receive( datagrams[received].address, datagrams[received].data, datagrams[received].size );
+
+          if ( bytes <= 0 )
+            break;
+
+          datagrams[received++].size = bytes;
+        }
+
+        return received;
+
+      #endif
+    }
+
   private:
 
+    bool SendTo( const Address & destination, const void * data, int size )
+    {
+      assert( destination.GetAddress() != 0 );
+      assert( destination.GetPort() != 0 );
+
+      sockaddr_in address;
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl( destination.GetAddress() );
+      address.sin_port = htons( (unsigned short) destination.GetPort() );
+
+      int sent_bytes = sendto( socketHandle, (const char*)data, size, 0, (sockaddr*)&address, sizeof(sockaddr_in) );
+
+      return sent_bytes == size;
+    }
+
+    int SendEach( const Datagram datagrams[], int count )
+    {
+      int sent = 0;
+
+      while ( sent < count && Send( datagrams[sent].address, datagrams[sent].data, datagrams[sent].size ) )
+        ++sent;
+
+      return sent;
+    }
+
+    // sends every conditioned datagram that is due
+    void SendConditioned()
+    {
+      Address destination;
+
+      while ( conditioner->Dequeue( destination, conditioned ) )
+        SendTo( destination, conditioned.data(), conditioned.size() );
+    }
+
     int socketHandle;
+    LinkConditioner * conditioner;
+    std::vector <unsigned char> conditioned;
   };
 
   // connection
@@ -438,6 +791,8 @@ namespace net
         bool connected = IsConnected();
         ClearData();
         socket.Close();
+        received_count = 0;
+        received_index = 0;
         running = false;
         if ( connected )
           OnDisconnect();
@@ -537,65 +892,81 @@ namespace net
     {
       assert( running );
 
-      if ( address.GetAddress() == 0 )
-        return false;
-
-      static std::vector <uint8_t> packet {};
-      packet.resize(size + 4);
-      packet[0] = (unsigned char) ( protocolId >> 24 );
-      packet[1] = (unsigned char) ( ( protocolId >> 16 ) & 0xFF );
-      packet[2] = (unsigned char) ( ( protocolId >> 8 ) & 0xFF );
-      packet[3] = (unsigned char) ( ( protocolId ) & 0xFF );
-      memcpy( &packet[4], data, size );
+      send_buffer.resize( size + 4 );
+      memcpy( &send_buffer[4], data, size );
 
-      return socket.Send( address, packet.data(), size + 4 );
+      return SendDatagram( size + 4 );
     }
 
-    virtual int ReceivePacket( unsigned char data[], const int size )
+    // next payload from the connected address, NULL once the socket is drained
+    //  + points into the receive arena, valid until the next call
+    virtual const unsigned char * ReceivePacket( int & size )
     {
       assert( running );
 
-      Address sender;
-      static std::vector <uint8_t> packet {};
-      packet.resize(size + 4);
+      while ( true )
+      {
+        if ( received_index == received_count )
+        {
+          received_index = 0;
+          received_count = ReceiveBatch();
 
-      int bytes_read = socket.Receive( sender, packet.data(), size + 4 );
-      if ( bytes_read == 0 )
-        return 0;
+          if ( received_count == 0 )
+            return NULL;
+        }
 
-      if ( bytes_read <= 4 )
-        return 0;
+        const Socket::Datagram & datagram = received[received_index++];
 
-      if ( packet[0] != (unsigned char) ( protocolId >> 24 ) ||
-           packet[1] != (unsigned char) ( ( protocolId >> 16 ) & 0xFF ) ||
-           packet[2] != (unsigned char) ( ( protocolId >> 8 ) & 0xFF ) ||
-           packet[3] != (unsigned char) ( protocolId & 0xFF ) )
-        return 0;
+        if ( datagram.size <= 4 )
+          continue;
 
-      if ( mode == Server && !IsConnected() )
-      {
-        state = Connected;
-        address = sender;
-        log_message( "NETWORK: New client connected from ", address.ToString(), "\n" );
-        OnConnect();
-      }
+        const unsigned char * packet = datagram.data;
 
-      if ( sender == address )
-      {
-        if ( mode == Client && state == Connecting )
+        if ( packet[0] != (unsigned char) ( protocolId >> 24 ) ||
+             packet[1] != (unsigned char) ( ( protocolId >> 16 ) & 0xFF ) ||
+             packet[2] != (unsigned char) ( ( protocolId >> 8 ) & 0xFF ) ||
+             packet[3] != (unsigned char) ( protocolId & 0xFF ) )
+          continue;
+
+        if ( mode == Server && !IsConnected() )
         {
-          log_message( "NETWORK: Successfully connected to server!\n" );
           state = Connected;
+          address = datagram.address;
+          log_message( "NETWORK: New client connected from ", address.ToString(), "\n" );
           OnConnect();
         }
 
-        timeoutAccumulator = 0.0f;
-        memcpy( data, &packet[4], bytes_read - 4 );
+        if ( datagram.address == address )
+        {
+          if ( mode == Client && state == Connecting )
+          {
+            log_message( "NETWORK: Successfully connected to server!\n" );
+            state = Connected;
+            OnConnect();
+          }
+
+          timeoutAccumulator = 0.0f;
 
-        return bytes_read - 4;
+          size = datagram.size - 4;
+          return packet + 4;
+        }
       }
+    }
+
+    // copies the next payload into "data", returns 0 once the socket is drained
+    int ReceivePacket( unsigned char data[], const int size )
+    {
+      int payload_size = 0;
+      const unsigned char * payload = ReceivePacket( payload_size );
 
-      return 0;
+      if ( payload == NULL )
+        return 0;
+
+      if ( payload_size > size )
+        payload_size = size;
+
+      memcpy( data, payload, payload_size );
+      return payload_size;
     }
 
     int GetHeaderSize() const
@@ -605,6 +976,22 @@ namespace net
 
   protected:
 
+    // datagram being sent, each layer writes its header in place after the protocol id
+    std::vector <unsigned char> send_buffer;
+
+    bool SendDatagram( const int size )
+    {
+      if ( address.GetAddress() == 0 )
+        return false;
+
+      send_buffer[0] = (unsigned char) ( protocolId >> 24 );
+      send_buffer[1] = (unsigned char) ( ( protocolId >> 16 ) & 0xFF );
+      send_buffer[2] = (unsigned char) ( ( protocolId >> 8 ) & 0xFF );
+      send_buffer[3] = (unsigned char) ( ( protocolId ) & 0xFF );
+
+      return socket.Send( address, send_buffer.data(), size );
+    }
+
     virtual void OnStart()		{}
     virtual void OnStop()		{}
     virtual void OnConnect()    {}
@@ -637,15 +1024,36 @@ namespace net
     State state;
     float timeoutAccumulator;
     Address address;
+
+    // larger datagrams are truncated, no game packet comes close
+    static constexpr int max_datagram_size = 1200;
+
+    std::vector <unsigned char> receive_arena;
+    Socket::Datagram received[Socket::batch_size];
+    int received_count = 0;
+    int received_index = 0;
+
+    int ReceiveBatch()
+    {
+      receive_arena.resize( Socket::batch_size * max_datagram_size );
+
+      for ( int i = 0; i < Socket::batch_size; ++i )
+      {
+        received[i].data = &receive_arena[i * max_datagram_size];
+        received[i].size = max_datagram_size;
+      }
+
+      return socket.ReceiveBatch( received, Socket::batch_size );
+    }
   };
 
-  // packet queue to store information about sent and received packets sorted in sequence order
+  // packet queue to store information about sent and received packets, indexed by sequence modulo its capacity
   //  + we define ordering using the "sequence_more_recent" function, this works provided there is a large gap when sequence wrap occurs
 
   struct PacketData
   {
     unsigned int sequence;			// packet sequence number
-    float time;					    // time offset since packet was sent or received (depending on context)
+    double time;					// time the packet was sent or received at (depending on context)
     int size;						// packet size in bytes
   };
 
@@ -654,62 +1062,160 @@ namespace net
     return ( s1 > s2 ) && ( s1 - s2 <= max_sequence/2 ) || ( s2 > s1 ) && ( s2 - s1 > max_sequence/2 );
   }
 
-  class PacketQueue : public std::list<PacketData>
+  // number of sequences from s2 up to s1, accounting for wrap around
+  inline unsigned int sequence_difference( unsigned int s1, unsigned int s2, unsigned int max_sequence )
+  {
+    return s1 >= s2 ? s1 - s2 : max_sequence - s2 + s1 + 1;
+  }
+
+  inline unsigned int sequence_next( unsigned int sequence, unsigned int max_sequence )
+  {
+    return sequence < max_sequence ? sequence + 1 : 0;
+  }
+
+  inline unsigned int sequence_previous( unsigned int sequence, unsigned int count, unsigned int max_sequence )
+  {
+    return sequence >= count ? sequence - count : max_sequence - ( count - sequence - 1 );
+  }
+
+  //  + insert, lookup and erase are O(1) and never allocate
+  //  + holds packets of at most "capacity" consecutive sequences, older ones must be popped before inserting past that
+  //  + sequences map to distinct slots as long as ( max_sequence + 1 ) is a multiple of capacity
+
+  class PacketQueue
   {
   public:
 
-    bool exists( unsigned int sequence )
+    static const unsigned int capacity = 256;
+
+    PacketQueue()
     {
-      for ( iterator itor = begin(); itor != end(); ++itor )
-        if ( itor->sequence == sequence )
-          return true;
-      return false;
+      clear();
+    }
+
+    void clear()
+    {
+      for ( unsigned int i = 0; i < capacity; ++i )
+        valid[i] = false;
+      count = 0;
+      first = 0;
+      last = 0;
+    }
+
+    bool empty() const
+    {
+      return count == 0;
+    }
+
+    unsigned int size() const
+    {
+      return count;
+    }
+
+    bool exists( unsigned int sequence ) const
+    {
+      const unsigned int index = sequence % capacity;
+      return valid[index] && entries[index].sequence == sequence;
+    }
+
+    PacketData * find( unsigned int sequence )
+    {
+      return exists( sequence ) ? &entries[sequence % capacity] : NULL;
+    }
+
+    // oldest packet
+    const PacketData & front() const
+    {
+      assert( !empty() );
+      return entries[first % capacity];
+    }
+
+    // most recent packet
+    const PacketData & back() const
+    {
+      assert( !empty() );
+      return entries[last % capacity];
     }
 
-    void insert_sorted( const PacketData & p, unsigned int max_sequence )
+    bool fits( unsigned int sequence, unsigned int max_sequence ) const
     {
       if ( empty() )
+        return true;
+      const unsigned int oldest = sequence_more_recent( first, sequence, max_sequence ) ? sequence : first;
+      const unsigned int newest = sequence_more_recent( sequence, last, max_sequence ) ? sequence : last;
+      return sequence_difference( newest, oldest, max_sequence ) < capacity;
+    }
+
+    void insert( const PacketData & p, unsigned int max_sequence )
+    {
+      assert( !exists( p.sequence ) );
+      assert( fits( p.sequence, max_sequence ) );
+      const unsigned int index = p.sequence % capacity;
+      assert( !valid[index] );
+      entries[index] = p;
+      valid[index] = true;
+      if ( count == 0 )
       {
-        push_back( p );
+        first = p.sequence;
+        last = p.sequence;
       }
       else
       {
-        if ( !sequence_more_recent( p.sequence, front().sequence, max_sequence ) )
-        {
-          push_front( p );
-        }
-        else if ( sequence_more_recent( p.sequence, back().sequence, max_sequence ) )
-        {
-          push_back( p );
-        }
-        else
-        {
-          for ( PacketQueue::iterator itor = begin(); itor != end(); itor++ )
-          {
-            assert( itor->sequence != p.sequence );
-            if ( sequence_more_recent( itor->sequence, p.sequence, max_sequence ) )
-            {
-              insert( itor, p );
-              break;
-            }
-          }
-        }
+        if ( sequence_more_recent( first, p.sequence, max_sequence ) )
+          first = p.sequence;
+        if ( sequence_more_recent( p.sequence, last, max_sequence ) )
+          last = p.sequence;
       }
+      count++;
+    }
+
+    void erase( unsigned int sequence, unsigned int max_sequence )
+    {
+      if ( !exists( sequence ) )
+        return;
+      valid[sequence % capacity] = false;
+      if ( --count == 0 )
+        return;
+      // skip holes, so that front and back stay valid
+      if ( sequence == first )
+        while ( !exists( first ) )
+          first = sequence_next( first, max_sequence );
+      if ( sequence == last )
+        while ( !exists( last ) )
+          last = sequence_previous( last, 1, max_sequence );
+    }
+
+    void pop_front( unsigned int max_sequence )
+    {
+      erase( first, max_sequence );
     }
 
-    void verify_sorted( unsigned int max_sequence )
+    void verify_sorted( unsigned int max_sequence ) const
     {
-      PacketQueue::iterator prev = end();
-      for ( PacketQueue::iterator itor = begin(); itor != end(); itor++ )
+      if ( empty() )
+        return;
+      assert( exists( first ) );
+      assert( exists( last ) );
+      assert( sequence_difference( last, first, max_sequence ) < capacity );
+      unsigned int found = 0;
+      for ( unsigned int sequence = first; ; sequence = sequence_next( sequence, max_sequence ) )
       {
-        assert( itor->sequence <= max_sequence );
-        if ( prev != end() )
-        {
-          assert( sequence_more_recent( itor->sequence, prev->sequence, max_sequence ) );
-          prev = itor;
-        }
+        assert( sequence <= max_sequence );
+        if ( exists( sequence ) )
+          found++;
+        if ( sequence == last )
+          break;
       }
+      assert( found == count );
     }
+
+  private:
+
+    PacketData entries[capacity];
+    bool valid[capacity];
+    unsigned int count;
+    unsigned int first;					// sequence of the oldest packet
+    unsigned int last;					// sequence of the most recent packet
   };
 
   // reliability system to support reliable connection
@@ -738,28 +1244,38 @@ namespace net
       recv_packets = 0;
       lost_packets = 0;
       acked_packets = 0;
+      sent_bytes = 0;
       sent_bandwidth = 0.0f;
       acked_bandwidth = 0.0f;
       rtt = 0.0f;
       rtt_maximum = 1.0f;
+      time = 0.0;
     }
 
     void PacketSent( int size )
     {
       if ( sentQueue.exists( local_sequence ) )
-      {
-          log_message( "NETWORK: Local sequence " + std::to_string(local_sequence) + " exists\n" );
-        for ( PacketQueue::iterator itor = sentQueue.begin(); itor != sentQueue.end(); ++itor )
-            log_message( " + " + std::to_string(itor->sequence) + "\n" );
-      }
+        log_message( "NETWORK: Local sequence " + std::to_string(local_sequence) + " exists\n" );
       assert( !sentQueue.exists( local_sequence ) );
       assert( !pendingAckQueue.exists( local_sequence ) );
       PacketData data;
       data.sequence = local_sequence;
-      data.time = 0.0f;
+      data.time = time;
       data.size = size;
-      sentQueue.push_back( data );
-      pendingAckQueue.push_back( data );
+      // make room when sending faster than the queues can hold
+      while ( !sentQueue.fits( local_sequence, max_sequence ) )
+      {
+        sent_bytes -= sentQueue.front().size;
+        sentQueue.pop_front( max_sequence );
+      }
+      while ( !pendingAckQueue.fits( local_sequence, max_sequence ) )
+      {
+        pendingAckQueue.pop_front( max_sequence );
+        lost_packets++;
+      }
+      sentQueue.insert( data, max_sequence );
+      pendingAckQueue.insert( data, max_sequence );
+      sent_bytes += size;
       sent_packets++;
       local_sequence++;
       if ( local_sequence > max_sequence )
@@ -771,11 +1287,19 @@ namespace net
       recv_packets++;
       if ( receivedQueue.exists( sequence ) )
         return;
+      if ( !receivedQueue.fits( sequence, max_sequence ) )
+      {
+        // too old to be acked anyway
+        if ( !sequence_more_recent( sequence, receivedQueue.back().sequence, max_sequence ) )
+          return;
+        while ( !receivedQueue.fits( sequence, max_sequence ) )
+          receivedQueue.pop_front( max_sequence );
+      }
       PacketData data;
       data.sequence = sequence;
-      data.time = 0.0f;
+      data.time = time;
       data.size = size;
-      receivedQueue.push_back( data );
+      receivedQueue.insert( data, max_sequence );
       if ( sequence_more_recent( sequence, remote_sequence, max_sequence ) )
         remote_sequence = sequence;
     }
@@ -787,13 +1311,17 @@ namespace net
 
     void ProcessAck( unsigned int ack, unsigned int ack_bits )
     {
-      process_ack( ack, ack_bits, pendingAckQueue, ackedQueue, acks, acked_packets, rtt, max_sequence );
+      // oldest first, so that rtt is smoothed in sending order
+      for ( int bit_index = 31; bit_index >= 0; --bit_index )
+        if ( ( ack_bits >> bit_index ) & 1 )
+          PacketAcked( sequence_previous( ack, bit_index + 1, max_sequence ) );
+      PacketAcked( ack );
     }
 
     void Update( const double deltaTime )
     {
       acks.clear();
-      AdvanceQueueTime( deltaTime );
+      time += deltaTime;
       UpdateQueues();
       UpdateStats();
     }
@@ -813,76 +1341,16 @@ namespace net
       return ( s1 > s2 ) && ( s1 - s2 <= max_sequence/2 ) || ( s2 > s1 ) && ( s2 - s1 > max_sequence/2 );
     }
 
-    static int bit_index_for_sequence( unsigned int sequence, unsigned int ack, unsigned int max_sequence )
-    {
-      assert( sequence != ack );
-      assert( !sequence_more_recent( sequence, ack, max_sequence ) );
-      if ( sequence > ack )
-      {
-        assert( ack < 33 );
-        assert( max_sequence >= sequence );
-        return ack + ( max_sequence - sequence );
-      }
-      else
-      {
-        assert( ack >= 1 );
-        assert( sequence <= ack - 1 );
-        return ack - 1 - sequence;
-      }
-    }
-
+    // bit n acks sequence ( ack - n - 1 )
     static unsigned int generate_ack_bits( unsigned int ack, const PacketQueue & received_queue, unsigned int max_sequence )
     {
       unsigned int ack_bits = 0;
-      for ( PacketQueue::const_iterator itor = received_queue.begin(); itor != received_queue.end(); itor++ )
-      {
-        if ( itor->sequence == ack || sequence_more_recent( itor->sequence, ack, max_sequence ) )
-          break;
-        int bit_index = bit_index_for_sequence( itor->sequence, ack, max_sequence );
-        if ( bit_index <= 31 )
-          ack_bits |= 1 << bit_index;
-      }
+      for ( int bit_index = 0; bit_index < 32; ++bit_index )
+        if ( received_queue.exists( sequence_previous( ack, bit_index + 1, max_sequence ) ) )
+          ack_bits |= 1u << bit_index;
       return ack_bits;
     }
 
-    static void process_ack( unsigned int ack, unsigned int ack_bits,
-                 PacketQueue & pending_ack_queue, PacketQueue & acked_queue,
-                 std::vector<unsigned int> & acks, unsigned int & acked_packets,
-                 float & rtt, unsigned int max_sequence )
-    {
-      if ( pending_ack_queue.empty() )
-        return;
-
-      PacketQueue::iterator itor = pending_ack_queue.begin();
-      while ( itor != pending_ack_queue.end() )
-      {
-        bool acked = false;
-
-        if ( itor->sequence == ack )
-        {
-          acked = true;
-        }
-        else if ( !sequence_more_recent( itor->sequence, ack, max_sequence ) )
-        {
-          int bit_index = bit_index_for_sequence( itor->sequence, ack, max_sequence );
-          if ( bit_index <= 31 )
-            acked = ( ack_bits >> bit_index ) & 1;
-        }
-
-        if ( acked )
-        {
-          rtt += ( itor->time - rtt ) * 0.1f;
-
-          acked_queue.insert_sorted( *itor, max_sequence );
-          acks.push_back( itor->sequence );
-          acked_packets++;
-          itor = pending_ack_queue.erase( itor );
-        }
-        else
-          ++itor;
-      }
-    }
-
     // data accessors
 
     unsigned int GetLocalSequence() const
@@ -948,64 +1416,73 @@ namespace net
 
   protected:
 
-    void AdvanceQueueTime( float deltaTime )
+    void PacketAcked( unsigned int sequence )
     {
-      for ( PacketQueue::iterator itor = sentQueue.begin(); itor != sentQueue.end(); itor++ )
-        itor->time += deltaTime;
-
-      for ( PacketQueue::iterator itor = receivedQueue.begin(); itor != receivedQueue.end(); itor++ )
-        itor->time += deltaTime;
+      const PacketData * packet = pendingAckQueue.find( sequence );
+      if ( packet == NULL )
+        return;
+      const PacketData data = *packet;
+      pendingAckQueue.erase( sequence, max_sequence );
 
-      for ( PacketQueue::iterator itor = pendingAckQueue.begin(); itor != pendingAckQueue.end(); itor++ )
-        itor->time += deltaTime;
+      rtt += ( float( time - data.time ) - rtt ) * 0.1f;
 
-      for ( PacketQueue::iterator itor = ackedQueue.begin(); itor != ackedQueue.end(); itor++ )
-        itor->time += deltaTime;
+      while ( !ackedQueue.fits( sequence, max_sequence ) )
+        ackedQueue.pop_front( max_sequence );
+      ackedQueue.insert( data, max_sequence );
+      acks.push_back( sequence );
+      acked_packets++;
     }
 
     void UpdateQueues()
     {
       const float epsilon = 0.001f;
 
-      while ( sentQueue.size() && sentQueue.front().time > rtt_maximum + epsilon )
-        sentQueue.pop_front();
+      while ( sentQueue.size() && time - sentQueue.front().time > rtt_maximum + epsilon )
+      {
+        sent_bytes -= sentQueue.front().size;
+        sentQueue.pop_front( max_sequence );
+      }
 
       if ( receivedQueue.size() )
       {
         const unsigned int latest_sequence = receivedQueue.back().sequence;
-        const unsigned int minimum_sequence = latest_sequence >= 34 ? ( latest_sequence - 34 ) : max_sequence - ( 34 - latest_sequence );
+        const unsigned int minimum_sequence = sequence_previous( latest_sequence, 34, max_sequence );
         while ( receivedQueue.size() && !sequence_more_recent( receivedQueue.front().sequence, minimum_sequence, max_sequence ) )
-          receivedQueue.pop_front();
+          receivedQueue.pop_front( max_sequence );
       }
 
-      while ( ackedQueue.size() && ackedQueue.front().time > rtt_maximum * 2 - epsilon )
-        ackedQueue.pop_front();
+      while ( ackedQueue.size() && time - ackedQueue.front().time > rtt_maximum * 2 - epsilon )
+        ackedQueue.pop_front( max_sequence );
 
-      while ( pendingAckQueue.size() && pendingAckQueue.front().time > rtt_maximum + epsilon )
+      while ( pendingAckQueue.size() && time - pendingAckQueue.front().time > rtt_maximum + epsilon )
       {
-        pendingAckQueue.pop_front();
+        pendingAckQueue.pop_front( max_sequence );
         lost_packets++;
       }
     }
 
+    // sent byte count is kept up to date as packets enter and leave sentQueue
+    //  + acked packets are ordered by send time, so the ones older than rtt_maximum come first
     void UpdateStats()
     {
-      int sent_bytes_per_second = 0;
-      for ( PacketQueue::iterator itor = sentQueue.begin(); itor != sentQueue.end(); ++itor )
-        sent_bytes_per_second += itor->size;
-      int acked_packets_per_second = 0;
       int acked_bytes_per_second = 0;
-      for ( PacketQueue::iterator itor = ackedQueue.begin(); itor != ackedQueue.end(); ++itor )
+      if ( ackedQueue.size() )
       {
-        if ( itor->time >= rtt_maximum )
+        for ( unsigned int sequence = ackedQueue.front().sequence; ; sequence = sequence_next( sequence, max_sequence ) )
         {
-          acked_packets_per_second++;
-          acked_bytes_per_second += itor->size;
+          const PacketData * packet = ackedQueue.find( sequence );
+          if ( packet != NULL )
+          {
+            if ( time - packet->time < rtt_maximum )
+              break;
+            acked_bytes_per_second += packet->size;
+          }
+          if ( sequence == ackedQueue.back().sequence )
+            break;
         }
       }
-      sent_bytes_per_second /= rtt_maximum;
       acked_bytes_per_second /= rtt_maximum;
-      sent_bandwidth = sent_bytes_per_second * ( 8 / 1000.0f );
+      sent_bandwidth = sent_bytes / rtt_maximum * ( 8 / 1000.0f );
       acked_bandwidth = acked_bytes_per_second * ( 8 / 1000.0f );
     }
 
@@ -1020,16 +1497,20 @@ namespace net
     unsigned int lost_packets;			// total number of packets lost
     unsigned int acked_packets;			// total number of packets acked
 
+    int sent_bytes;						// total size of packets in sentQueue
+
     float sent_bandwidth;				// approximate sent bandwidth over the last second
     float acked_bandwidth;				// approximate acked bandwidth over the last second
     float rtt;							// estimated round trip time
     float rtt_maximum;					// maximum expected round trip time (hard coded to one second for the moment)
 
+    double time;						// time since reset, packet times are relative to it
+
     std::vector<unsigned int> acks;		// acked packets from last set of packet receives. cleared each update!
 
     PacketQueue sentQueue;				// sent packets used to calculate sent bandwidth (kept until rtt_maximum)
-    PacketQueue pendingAckQueue;		// sent packets which have not been acked yet (kept until rtt_maximum * 2 )
-    PacketQueue receivedQueue;			// received packets for determining acks to send (kept up to most recent recv sequence - 32)
+    PacketQueue pendingAckQueue;		// sent packets which have not been acked yet (kept until rtt_maximum)
+    PacketQueue receivedQueue;			// received packets for determining acks to send (kept up to most recent recv sequence - 34)
     PacketQueue ackedQueue;				// acked packets (kept until rtt_maximum * 2)
   };
 
@@ -1056,50 +1537,55 @@ namespace net
     bool SendPacket( const unsigned char data[], int size )
     {
       const int header = 12;
-      static std::vector <uint8_t> packet {};
-      packet.resize(header + size);
+      const int offset = Connection::GetHeaderSize() + header;
+      send_buffer.resize( offset + size );
 
       unsigned int seq = reliabilitySystem.GetLocalSequence();
       unsigned int ack = reliabilitySystem.GetRemoteSequence();
       unsigned int ack_bits = reliabilitySystem.GenerateAckBits();
 
-      WriteHeader( packet.data(), seq, ack, ack_bits );
-      memcpy( packet.data() + header, data, size );
+      WriteHeader( &send_buffer[Connection::GetHeaderSize()], seq, ack, ack_bits );
+      memcpy( &send_buffer[offset], data, size );
 
-      if ( !Connection::SendPacket( packet.data(), size + header ) )
+      if ( !SendDatagram( offset + size ) )
         return false;
 
       reliabilitySystem.PacketSent( size );
       return true;
     }
 
-    int ReceivePacket( unsigned char data[], int size )
+    using Connection::ReceivePacket;
+
+    // skips packets older than the most recent one received
+    const unsigned char * ReceivePacket( int & size )
     {
       const int header = 12;
-      static std::vector <uint8_t> packet {};
-      packet.resize(header + size);
 
-      int received_bytes = Connection::ReceivePacket( packet.data(), size + header );
+      while ( true )
+      {
+        int received_bytes = 0;
+        const unsigned char * packet = Connection::ReceivePacket( received_bytes );
 
-      if ( received_bytes == 0 )
-        return 0;
+        if ( packet == NULL )
+          return NULL;
 
-      if ( received_bytes <= header )
-        return 0;
+        if ( received_bytes <= header )
+          continue;
 
-      unsigned int packet_sequence = 0;
-      unsigned int packet_ack = 0;
-      unsigned int packet_ack_bits = 0;
+        unsigned int packet_sequence = 0;
+        unsigned int packet_ack = 0;
+        unsigned int packet_ack_bits = 0;
 
-      ReadHeader( packet.data(), packet_sequence, packet_ack, packet_ack_bits );
-      reliabilitySystem.PacketReceived( packet_sequence, received_bytes - header );
-      reliabilitySystem.ProcessAck( packet_ack, packet_ack_bits );
+        ReadHeader( packet, packet_sequence, packet_ack, packet_ack_bits );
+        reliabilitySystem.PacketReceived( packet_sequence, received_bytes - header );
+        reliabilitySystem.ProcessAck( packet_ack, packet_ack_bits );
 
-      if ( packet_sequence != reliabilitySystem.GetRemoteSequence() )
-        return 0;
+        if ( packet_sequence != reliabilitySystem.GetRemoteSequence() )
+          continue;
 
-      memcpy( data, packet.data() + header, received_bytes - header );
-      return received_bytes - header;
+        size = received_bytes - header;
+        return packet + header;
+      }
     }
 
     void Update( const double deltaTime )
@@ -1170,10 +1656,31 @@ namespace net
   };
 
 
+    // flow control
+    //  + Good/Bad mode only tells whether the connection is stable enough to play
+    //  + send rate drops by a factor whenever rtt, packet loss or acked bandwidth exceed
+    //    the policy, at most once per round trip, and creeps back up while all of them are good
+    //  + full state goes out with every packet at the top rate only, and with fewer
+    //    and fewer of them as the send rate drops towards its minimum
+
     class FlowControl
     {
     public:
 
+        struct Policy
+        {
+            float rtt_good = 100.0f;            // milliseconds
+            float rtt_bad = 250.0f;
+            float loss_good = 2.0f;             // percent of sent packets
+            float loss_bad = 10.0f;
+            float max_bandwidth = 0.0f;         // acked kbit/s, zero for unlimited
+            float max_send_rate = 60.0f;        // packets per second
+            float min_send_rate = 30.0f;
+            float send_rate_increase = 5.0f;    // packets per second, every second
+            float send_rate_decrease = 0.75f;
+            unsigned int max_state_interval = 4;
+        };
+
         FlowControl()
         {
             log_message( "NETWORK: Flow control initialized!\n" );
@@ -1186,15 +1693,78 @@ namespace net
             penalty_time = 4.0f;
             good_conditions_time = 0.0f;
             penalty_reduction_accumulator = 0.0f;
+
+            send_rate = policy.max_send_rate;
+            decrease_cooldown = 0.0f;
+            state_interval = 1;
+            packets_since_state = 0;
+
+            loss = 0.0f;
+            loss_time = 0.0f;
+            loss_sent_packets = 0;
+            loss_lost_packets = 0;
+        }
+
+        void SetPolicy( const Policy & policy )
+        {
+            this->policy = policy;
+            send_rate = std::min( std::max( send_rate, policy.min_send_rate ), policy.max_send_rate );
+            UpdateStateInterval();
+        }
+
+        const Policy & GetPolicy() const
+        {
+            return policy;
+        }
+
+        void Update( const ReliabilitySystem & reliability, const double deltaTime )
+        {
+            const float rtt = reliability.GetRoundTripTime() * 1000.0f;
+
+            UpdateLoss( reliability, deltaTime );
+            UpdateSendRate( rtt, reliability.GetAckedBandwidth(), deltaTime );
+            UpdateMode( rtt, deltaTime );
         }
 
-        void Update( const float rtt, const double deltaTime )
+        bool IsConnectionStable() const
+        {
+            return mode == Good;
+        }
+
+        float GetSendRate() const
+        {
+            return send_rate;
+        }
+
+        float GetPacketLoss() const
+        {
+            return loss;
+        }
+
+        unsigned int GetStateInterval() const
+        {
+            return state_interval;
+        }
+
+        // call once for every packet sent, tells whether it carries the full state
+        bool ShouldSendState()
+        {
+            if ( ++packets_since_state < state_interval )
+                return false;
+
+            packets_since_state = 0;
+            return true;
+        }
+
+    private:
+
+        void UpdateMode( const float rtt, const double deltaTime )
         {
-            const float RTT_Threshold = 250.0f;
+            const bool isBad = rtt > policy.rtt_bad || loss > policy.loss_bad;
 
             if ( mode == Good )
             {
-                if ( rtt > RTT_Threshold )
+                if ( isBad )
                 {
                     log_message( "NETWORK: Dropping to bad mode!\n" );
                     mode = Bad;
@@ -1231,7 +1801,7 @@ namespace net
 
             if ( mode == Bad )
             {
-                if ( rtt <= RTT_Threshold )
+                if ( !isBad )
                     good_conditions_time += deltaTime;
                 else
                     good_conditions_time = 0.0f;
@@ -1247,12 +1817,73 @@ namespace net
             }
         }
 
-        bool IsConnectionStable() const
+        // lost packets are only counted a second after they were sent,
+        // so loss is measured over whole seconds
+        void UpdateLoss( const ReliabilitySystem & reliability, const double deltaTime )
         {
-            return mode == Good;
+            const unsigned int sent_packets = reliability.GetSentPackets();
+            const unsigned int lost_packets = reliability.GetLostPackets();
+
+            if ( sent_packets < loss_sent_packets || lost_packets < loss_lost_packets )
+            {
+                loss_sent_packets = sent_packets;
+                loss_lost_packets = lost_packets;
+            }
+
+            loss_time += deltaTime;
+
+            if ( loss_time < 1.0f )
+                return;
+
+            loss_time = 0.0f;
+
+            const unsigned int sent = sent_packets - loss_sent_packets;
+            const unsigned int lost = lost_packets - loss_lost_packets;
+
+            loss_sent_packets = sent_packets;
+            loss_lost_packets = lost_packets;
+
+            if ( sent == 0 )
+                return;
+
+            const float sample = 100.0f * std::min( lost, sent ) / sent;
+            loss += ( sample - loss ) * 0.5f;
         }
 
-    private:
+        void UpdateSendRate( const float rtt, const float acked_bandwidth, const double deltaTime )
+        {
+            const bool isOverBandwidth =
+                policy.max_bandwidth > 0.0f && acked_bandwidth > policy.max_bandwidth;
+
+            decrease_cooldown -= deltaTime;
+
+            if ( rtt > policy.rtt_bad || loss > policy.loss_bad || isOverBandwidth )
+            {
+                if ( decrease_cooldown > 0.0f )
+                    return;
+
+                decrease_cooldown = std::max( rtt, 100.0f ) / 1000.0f;
+                send_rate = std::max( send_rate * policy.send_rate_decrease, policy.min_send_rate );
+            }
+            else if ( rtt < policy.rtt_good && loss < policy.loss_good )
+                send_rate = std::min( send_rate + float( policy.send_rate_increase * deltaTime ), policy.max_send_rate );
+
+            UpdateStateInterval();
+        }
+
+        void UpdateStateInterval()
+        {
+            const float range = policy.max_send_rate - policy.min_send_rate;
+
+            const float congestion =
+                range > 0.0f
+                ? ( policy.max_send_rate - send_rate ) / range
+                : 0.0f;
+
+            const unsigned int max_interval = std::max( policy.max_state_interval, 1u );
+
+            state_interval = 1 + (unsigned int) std::lround( congestion * ( max_interval - 1 ) );
+        }
 
         enum Mode
         {
@@ -1260,10 +1891,22 @@ namespace net
             Bad
         };
 
+        Policy policy;
+
         Mode mode;
         float penalty_time;
         float good_conditions_time;
         float penalty_reduction_accumulator;
+
+        float send_rate;
+        float decrease_cooldown;
+        unsigned int state_interval;
+        unsigned int packets_since_state;
+
+        float loss;
+        float loss_time;
+        unsigned int loss_sent_packets;
+        unsigned int loss_lost_packets;
     };
 }
 
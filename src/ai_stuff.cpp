@@ -19,17 +19,14 @@
 */
 
 #include <include/ai_stuff.hpp>
-#include <include/biplanes.hpp>
-#include <include/controls.hpp>
-#include <include/sdl.hpp>
 #include <include/time.hpp>
 #include <include/constants.hpp>
 #include <include/game_state.hpp>
 #include <include/math.hpp>
 #include <include/plane.hpp>
+#include <include/world.hpp>
 #include <include/bullet.hpp>
-#include <include/render.hpp>
-#include <include/utility.hpp>
+#include <include/profiler.hpp>
 
 #include <lib/SDL_Vector.h>
 #include <lib/godot_math.hpp>
@@ -73,7 +70,7 @@ isPlaneStalling(
     groundSegment[0], groundSegment[1],
     &groundContactPoint );
 
-  const std::vector <SDL_Vector> barnBox
+  const SDL_Vector barnBox[]
   {
     {barn::planeCollisionX, constants::plane::groundCollision},
     {barn::planeCollisionX, barn::planeCollisionY},
@@ -117,7 +114,7 @@ isAboutToCrash(
   namespace barn = constants::barn;
 
 
-  const float dir = self.dir() * M_PI / 180.f;
+  const auto dir = direction_vector(self.dir());
 
   const auto speed = 0.5f * std::clamp(
     self.speed() * constants::tickRate,
@@ -128,8 +125,8 @@ isAboutToCrash(
 
   const SDL_Vector probeEnd
   {
-    probeStart.x + speed * std::sin(dir),
-    probeStart.y - speed * std::cos(dir),
+    probeStart.x + speed * dir.x,
+    probeStart.y + speed * dir.y,
   };
 
   SDL_Vector closestContact {};
@@ -155,7 +152,7 @@ isAboutToCrash(
   }
 
 
-  const std::vector <SDL_Vector> barnBox
+  const SDL_Vector barnBox[]
   {
     {barn::planeCollisionX, plane::groundCollision},
     {barn::planeCollisionX, barn::planeCollisionY},
@@ -187,14 +184,14 @@ isSafeToJump(
   namespace plane = constants::plane;
   namespace pilot = constants::pilot;
 
-  const float jumpDir = self.jumpDir() * M_PI / 180.f;
+  const auto jumpDir = direction_vector(self.jumpDir());
 
   const SDL_Vector probeStart {self.x(), self.y()};
 
   const SDL_Vector probeEnd
   {
     probeStart.x,
-    probeStart.y - 0.5f * pilot::ejectSpeed * std::cos(jumpDir),
+    probeStart.y + 0.5f * pilot::ejectSpeed * jumpDir.y,
   };
 
 
@@ -213,10 +210,32 @@ isSafeToJump(
 }
 
 
+//  Stable and allocation-free sort by key
+//  for the few elements the AI deals with
+template <typename Iterator>
+static void
+insertionSort(
+  const Iterator first,
+  const Iterator last )
+{
+  const auto compareKeys =
+  [] ( const auto& lhs, const auto& rhs )
+  {
+    return lhs.first < rhs.first;
+  };
+
+  for ( auto iter = first; iter != last; ++iter )
+    std::rotate(
+      std::upper_bound(first, iter, *iter, compareKeys),
+      iter, std::next(iter) );
+}
+
+
 ContextMap::ContextMap(
   const size_t slotCount )
-  : mValues(slotCount)
+  : mSize{slotCount}
 {
+  assert(slotCount <= maxSlots);
 }
 
 void
@@ -224,7 +243,7 @@ ContextMap::write(
   const size_t slot,
   const float value )
 {
-  assert(slot < mValues.size());
+  assert(slot < mSize);
 
   mValues[slot] = value;
 }
@@ -233,7 +252,7 @@ float&
 ContextMap::operator [] (
   const size_t slot )
 {
-  assert(slot < mValues.size());
+  assert(slot < mSize);
 
   return mValues[slot];
 }
@@ -242,7 +261,7 @@ float
 ContextMap::operator [] (
   const size_t slot ) const
 {
-  assert(slot < mValues.size());
+  assert(slot < mSize);
 
   return mValues[slot];
 }
@@ -250,7 +269,7 @@ ContextMap::operator [] (
 void
 ContextMap::reinit()
 {
-  std::fill(mValues.begin(), mValues.end(), 0.f);
+  std::fill(mValues.begin(), mValues.begin() + mSize, 0.f);
 }
 
 void
@@ -258,44 +277,44 @@ ContextMap::normalize()
 {
   const auto max = maxValue();
 
-  for ( size_t i {}; i < mValues.size(); ++i )
+  for ( size_t i {}; i < mSize; ++i )
     mValues[i] /= max;
 }
 
 size_t
 ContextMap::size() const
 {
-  return mValues.size();
+  return mSize;
 }
 
 float
 ContextMap::minValue() const
 {
-  assert(mValues.empty() == false);
+  assert(mSize > 0);
 
   return *std::min_element(
     mValues.cbegin(),
-    mValues.cend() );
+    mValues.cbegin() + mSize );
 }
 
 float
 ContextMap::maxValue() const
 {
-  assert(mValues.empty() == false);
+  assert(mSize > 0);
 
   return *std::max_element(
     mValues.cbegin(),
-    mValues.cend() );
+    mValues.cbegin() + mSize );
 }
 
 size_t
 ContextMap::minValueSlot() const
 {
-  assert(mValues.empty() == false);
+  assert(mSize > 0);
 
   const auto lowestValueIter = std::min_element(
     mValues.cbegin(),
-    mValues.cend() );
+    mValues.cbegin() + mSize );
 
   return std::distance(
     mValues.cbegin(),
@@ -305,11 +324,11 @@ ContextMap::minValueSlot() const
 size_t
 ContextMap::maxValueSlot() const
 {
-  assert(mValues.empty() == false);
+  assert(mSize > 0);
 
   const auto highestValueIter = std::max_element(
     mValues.cbegin(),
-    mValues.cend() );
+    mValues.cbegin() + mSize );
 
   return std::distance(
     mValues.cbegin(),
@@ -320,11 +339,11 @@ ContextMap
 ContextMap::operator - (
   const ContextMap& other ) const
 {
-  assert(mValues.size() == other.mValues.size());
+  assert(mSize == other.mSize);
 
   ContextMap result {*this};
 
-  for ( size_t i {}; i < mValues.size(); ++i )
+  for ( size_t i {}; i < mSize; ++i )
     result.mValues[i] -= other.mValues[i];
 
   return result;
@@ -335,12 +354,12 @@ ContextMap::mask(
   const ContextMap& other,
   const float threshold ) const
 {
-  assert(mValues.empty() == false);
-  assert(mValues.size() == mValues.size());
+  assert(mSize > 0);
+  assert(mSize == other.mSize);
 
   ContextMap result {*this};
 
-  for ( size_t i {}; i < mValues.size(); ++i )
+  for ( size_t i {}; i < mSize; ++i )
     if ( other.mValues[i] > threshold )
       result.mValues[i] = {};
 
@@ -354,8 +373,8 @@ ContextMap::sum(
   const int8_t dir ) const
 {
   assert(dir != 0);
-  assert(firstSlot < mValues.size());
-  assert(lastSlot < mValues.size());
+  assert(firstSlot < mSize);
+  assert(lastSlot < mSize);
 
   float cost {};
 
@@ -364,9 +383,9 @@ ContextMap::sum(
     cost += mValues[slot];
 
     if ( slot == 0 && dir < 0 )
-      slot = mValues.size() - 1;
+      slot = mSize - 1;
 
-    else if ( slot == mValues.size() - 1 && dir > 0 )
+    else if ( slot == mSize - 1 && dir > 0 )
       slot = 0;
 
     else
@@ -383,17 +402,17 @@ ContextMap::countSlotDistance(
   const int8_t dir ) const
 {
   assert(dir != 0);
-  assert(firstSlot < mValues.size());
-  assert(lastSlot < mValues.size());
+  assert(firstSlot < mSize);
+  assert(lastSlot < mSize);
 
   size_t steps {};
 
   for ( size_t slot {firstSlot}; slot != lastSlot; )
   {
     if ( slot == 0 && dir < 0 )
-      slot = mValues.size() - 1;
+      slot = mSize - 1;
 
-    else if ( slot == mValues.size() - 1 && dir > 0 )
+    else if ( slot == mSize - 1 && dir > 0 )
       slot = 0;
 
     else
@@ -406,6 +425,55 @@ ContextMap::countSlotDistance(
 }
 
 
+void
+AiActionList::push_back(
+  const AiAction action )
+{
+  if ( std::find(cbegin(), cend(), action) != cend() )
+    return;
+
+  assert(mCount < mActions.size());
+
+  mActions[mCount++] = action;
+}
+
+AiAction*
+AiActionList::begin()
+{
+  return mActions.data();
+}
+
+AiAction*
+AiActionList::end()
+{
+  return mActions.data() + mCount;
+}
+
+const AiAction*
+AiActionList::begin() const
+{
+  return mActions.data();
+}
+
+const AiAction*
+AiActionList::end() const
+{
+  return mActions.data() + mCount;
+}
+
+const AiAction*
+AiActionList::cbegin() const
+{
+  return begin();
+}
+
+const AiAction*
+AiActionList::cend() const
+{
+  return end();
+}
+
+
 AiTemperature::AiTemperature(
 const Weights& sensitivity,
   const float value )
@@ -428,13 +496,7 @@ AiTemperature::update(
   if ( std::abs(valueDiff) < std::numeric_limits <float>::epsilon() )
     return;
 
-
-//  static std::minstd_rand0 eng {std::random_device{}()};
-//  static std::mt19937 eng {std::random_device{}()};
-//  static std::uniform_real_distribution <float> distr {0.25f, 1.f};
-
-//  const auto randomFactor = distr(eng);
-  const auto randomFactor = 1.f;
+  const auto randomFactor = world().aiController.randomFactor();
 
   mValue += factor * weight * randomFactor * std::copysign(1.f, valueDiff);
   mValue = std::clamp(mValue, 0.f, 1.f);
@@ -554,9 +616,9 @@ public:
   void update(
     const Plane& self,
     const Plane& opponent,
-    const std::vector <Bullet>& opponentBullets ) override;
+    const BulletSelection& opponentBullets ) override;
 
-  std::vector <AiAction> actions() const override;
+  AiActionList actions() const override;
 };
 
 AiStatePlane::AiStatePlane(
@@ -635,7 +697,7 @@ void
 AiStatePlane::update(
   const Plane& self,
   const Plane& opponent,
-  const std::vector <Bullet>& opponentBullets )
+  const BulletSelection& opponentBullets )
 {
   namespace barn = constants::barn;
   namespace pilot = constants::pilot;
@@ -667,14 +729,14 @@ AiStatePlane::update(
 
   for ( size_t i {}; i < plane::directionCount; ++i )
   {
-    const float dir = (i * plane::pitchStep) * M_PI / 180.f;
+    const auto& dir = pitch_direction(i);
 
     const SDL_Vector probeStart {self.x(), self.y()};
 
     const SDL_Vector probeEnd
     {
-      probeStart.x + speed * std::sin(dir),
-      probeStart.y - speed * std::cos(dir),
+      probeStart.x + speed * dir.x,
+      probeStart.y + speed * dir.y,
     };
 
     {
@@ -702,7 +764,7 @@ AiStatePlane::update(
     }
 
     {
-      const std::vector <SDL_Vector> barnBox
+      const SDL_Vector barnBox[]
       {
         {barn::planeCollisionX, plane::groundCollision},
         {barn::planeCollisionX, barn::planeCollisionY},
@@ -732,8 +794,10 @@ AiStatePlane::update(
   }
 
 
-  for ( auto& bullet : opponentBullets )
+  for ( size_t i {}; i < opponentBullets.size(); ++i )
   {
+    const auto bullet = opponentBullets[i];
+
     const SDL_Vector selfPathStart
     {
       self.x(),
@@ -755,32 +819,34 @@ AiStatePlane::update(
 //    line5 = bottomLeft -> topRight
 //    line6 = bottomRight -> topLeft
 
-    const float bulletDirLeft = (bullet.dir() - 90.f) * M_PI / 180.f;
-    const float bulletDirRight = (bullet.dir() + 90.f) * M_PI / 180.f;
-    const float bulletDir = bullet.dir() * M_PI / 180.f;
+    const auto bulletDir = direction_vector(bullet.dir());
+
+//  Perpendiculars of the bullet path, rotated by -90 and 90 degrees
+    const Direction bulletDirLeft {bulletDir.y, -bulletDir.x};
+    const Direction bulletDirRight {-bulletDir.y, bulletDir.x};
 
     const SDL_Vector bulletPathLeftStart
     {
-      bullet.x() + plane::hitboxRadius * std::sin(bulletDirLeft),
-      bullet.y() - plane::hitboxRadius * std::cos(bulletDirLeft),
+      bullet.x() + plane::hitboxRadius * bulletDirLeft.x,
+      bullet.y() + plane::hitboxRadius * bulletDirLeft.y,
     };
 
     const SDL_Vector bulletPathLeftEnd
     {
-      bulletPathLeftStart.x + constants::bullet::speed * std::sin(bulletDir),
-      bulletPathLeftStart.y - constants::bullet::speed * std::cos(bulletDir),
+      bulletPathLeftStart.x + constants::bullet::speed * bulletDir.x,
+      bulletPathLeftStart.y + constants::bullet::speed * bulletDir.y,
     };
 
     const SDL_Vector bulletPathRightStart
     {
-      bullet.x() + plane::hitboxRadius * std::sin(bulletDirRight),
-      bullet.y() - plane::hitboxRadius * std::cos(bulletDirRight),
+      bullet.x() + plane::hitboxRadius * bulletDirRight.x,
+      bullet.y() + plane::hitboxRadius * bulletDirRight.y,
     };
 
     const SDL_Vector bulletPathRightEnd
     {
-      bulletPathRightStart.x + constants::bullet::speed * std::sin(bulletDir),
-      bulletPathRightStart.y - constants::bullet::speed * std::cos(bulletDir),
+      bulletPathRightStart.x + constants::bullet::speed * bulletDir.x,
+      bulletPathRightStart.y + constants::bullet::speed * bulletDir.y,
     };
 
     SDL_Vector contactPoint {};
@@ -821,7 +887,7 @@ AiStatePlane::update(
   }
 
 
-  std::vector <AiAction> actions {};
+  AiActionList actions {};
 
   const SDL_Vector pos {self.x(), self.y()};
   const SDL_Vector opponentPos {opponent.pilot.x(), opponent.pilot.y()};
@@ -834,17 +900,24 @@ AiStatePlane::update(
   const auto opponentDistanceR = get_distance_between_points(pos, opponentPosR);
 
 
-  std::multimap <float, SDL_Vector> opponentPositionsSorted
+  std::pair <float, SDL_Vector> opponentPositionsSorted[]
   {
     {opponentDistance, opponentPos},
     {opponentDistanceL, opponentPosL},
     {opponentDistanceR, opponentPosR},
   };
-  opponentPositionsSorted.erase(--opponentPositionsSorted.end());
+
+  insertionSort(
+    std::begin(opponentPositionsSorted),
+    std::end(opponentPositionsSorted) );
+
+//  Farthest position is never a target
+  size_t opponentPositionsFirst {};
+  const size_t opponentPositionsLast {2};
 
 
   const auto [opponentShortestDistance, opponentShortestPos] =
-    *opponentPositionsSorted.begin();
+    opponentPositionsSorted[0];
 
   const auto dirToOpponentAbsolute = get_angle_to_point(
     pos, opponentShortestPos );
@@ -862,12 +935,14 @@ AiStatePlane::update(
   const auto isCrashing = isAboutToCrash(self);
 
   if ( isOpponentBehind == true && isStalling == true )
-    opponentPositionsSorted.erase(opponentPositionsSorted.begin());
+    ++opponentPositionsFirst;
 
 
   if ( opponent.isDead() == false )
-    for ( const auto& [distance, position] : opponentPositionsSorted )
+    for ( size_t i = opponentPositionsFirst; i < opponentPositionsLast; ++i )
     {
+      const auto& [distance, position] = opponentPositionsSorted[i];
+
       const auto dirToTargetAbsolute = get_angle_to_point(
         pos, position );
 
@@ -1047,13 +1122,21 @@ AiStatePlane::update(
   }
   else
   {
-    std::multimap <float, size_t> sortedInterestDirs {};
+    std::pair <float, size_t> sortedInterestDirs[ContextMap::maxSlots] {};
 
     for ( size_t i {}; i < filteredMap.size(); ++i )
-      sortedInterestDirs.insert({filteredMap[i], i});
+      sortedInterestDirs[i] = {filteredMap[i], i};
+
+    const auto sortedInterestDirsEnd =
+      std::begin(sortedInterestDirs) + filteredMap.size();
 
-    while ( sortedInterestDirs.size() > 2 )
-      sortedInterestDirs.erase(sortedInterestDirs.begin());
+    insertionSort(
+      std::begin(sortedInterestDirs),
+      sortedInterestDirsEnd );
+
+//  Only two most interesting directions are considered
+    const auto sortedInterestDirsBegin =
+      sortedInterestDirsEnd - std::min(filteredMap.size(), size_t{2});
 
     const auto pathStartLeft = std::clamp(
       selfDirIndex - size_t{1},
@@ -1067,8 +1150,10 @@ AiStatePlane::update(
     float highestDangerSumLeft {0.f};
     float highestDangerSumRight {0.f};
 
-    for ( auto&& [interest, slot] : sortedInterestDirs )
+    for ( auto iter = sortedInterestDirsBegin; iter != sortedInterestDirsEnd; ++iter )
     {
+      const auto& [interest, slot] = *iter;
+
       if ( slot == selfDirIndex )
         continue;
 
@@ -1195,9 +1280,10 @@ AiStatePlane::update(
       bool allowJump =
         gameState().features.oneShotKills == false;
 
-      for ( const auto& bullet : opponentBullets )
+      for ( size_t i {}; i < opponentBullets.size(); ++i )
       {
-        const float bulletDir = bullet.dir() * M_PI / 180.0;
+        const auto bullet = opponentBullets[i];
+        const auto bulletDir = direction_vector(bullet.dir());
 
         const auto bulletPathLength =
           0.5f * constants::bullet::speed;
@@ -1210,8 +1296,8 @@ AiStatePlane::update(
 
         const SDL_Vector bulletPathEnd
         {
-          bullet.x() + bulletPathLength * std::sin(bulletDir),
-          bullet.y() - bulletPathLength * std::cos(bulletDir),
+          bullet.x() + bulletPathLength * bulletDir.x,
+          bullet.y() + bulletPathLength * bulletDir.y,
         };
 
         const bool willCollide = segment_intersects_circle(
@@ -1282,9 +1368,6 @@ AiStatePlane::update(
   }
 
 
-  std::sort(actions.begin(), actions.end());
-  actions.erase(std::unique(actions.begin(), actions.end()), actions.end());
-
 
   if ( false && self.canTurn() == true && self.type() == PLANE_TYPE::RED )
   {
@@ -1334,12 +1417,12 @@ AiStatePlane::update(
   }
 }
 
-std::vector <AiAction>
+AiActionList
 AiStatePlane::actions() const
 {
   const float threshold = 0.95f;
 
-  std::vector <AiAction> actions {};
+  AiActionList actions {};
 
   for ( auto& [action, temperature] : mActions )
     if ( temperature >= threshold )
@@ -1357,9 +1440,9 @@ public:
   void update(
     const Plane& self,
     const Plane& opponent,
-    const std::vector <Bullet>& opponentBullets ) override;
+    const BulletSelection& opponentBullets ) override;
 
-  std::vector <AiAction> actions() const override;
+  AiActionList actions() const override;
 };
 
 AiStatePilot::AiStatePilot(
@@ -1410,7 +1493,7 @@ void
 AiStatePilot::update(
   const Plane& self,
   const Plane& opponent,
-  const std::vector <Bullet>& opponentBullets )
+  const BulletSelection& opponentBullets )
 {
   namespace pilot = constants::pilot;
   namespace chute = pilot::chute;
@@ -1454,7 +1537,7 @@ AiStatePilot::update(
 
   const auto runDistance = std::abs(pilotSpeed.x) * constants::tickRate * timeToAvoidBullet;
 
-//  const std::vector <SDL_Vector> pilotHitbox
+//  const SDL_Vector pilotHitbox[]
 //  {
 //    {pilotPos.x - 0.5f * pilot::sizeX + runDistance * (runDistance < 0.f), pilotPos.y + 0.5f * pilot::sizeY},
 //    {pilotPos.x - 0.5f * pilot::sizeX + runDistance * (runDistance < 0.f), pilotPos.y - 0.5f * pilot::sizeY},
@@ -1462,7 +1545,7 @@ AiStatePilot::update(
 //    {pilotPos.x + 0.5f * pilot::sizeX + runDistance * (runDistance > 0.f), pilotPos.y + 0.5f * pilot::sizeY},
 //  };
 
-  const std::vector <SDL_Vector> pilotHitbox
+  const SDL_Vector pilotHitbox[]
   {
     {pilotPos.x - 0.5f * pilot::sizeX - runDistance, pilotPos.y + 0.5f * pilot::sizeY},
     {pilotPos.x - 0.5f * pilot::sizeX - runDistance, pilotPos.y - 0.5f * pilot::sizeY},
@@ -1472,9 +1555,10 @@ AiStatePilot::update(
 
 //  Avoid bullets
   if ( botDifficulty > DIFFICULTY::MEDIUM )
-    for ( const auto& bullet : opponentBullets )
+    for ( size_t i {}; i < opponentBullets.size(); ++i )
     {
-      const float bulletDir = bullet.dir() * M_PI / 180.f;
+      const auto bullet = opponentBullets[i];
+      const auto bulletDir = direction_vector(bullet.dir());
       const auto bulletSpeed = constants::bullet::speed;
 
       const SDL_Vector bulletPathStart
@@ -1485,8 +1569,8 @@ AiStatePilot::update(
 
       const SDL_Vector bulletPathEnd
       {
-        bullet.x() + bulletSpeed * timeToAvoidBullet * std::sin(bulletDir),
-        bullet.y() - bulletSpeed * timeToAvoidBullet * std::cos(bulletDir),
+        bullet.x() + bulletSpeed * timeToAvoidBullet * bulletDir.x,
+        bullet.y() + bulletSpeed * timeToAvoidBullet * bulletDir.y,
       };
 
       SDL_Vector contactPoint {};
@@ -1522,7 +1606,7 @@ AiStatePilot::update(
 //  Avoid opponent's LoS
   if ( opponent.canShoot() == true && botDifficulty > DIFFICULTY::HARD )
   {
-    const float bulletDir = opponent.dir() * M_PI / 180.f;
+    const auto bulletDir = direction_vector(opponent.dir());
     const auto bulletSpeed = constants::bullet::speed;
 
     const auto bulletOffset = opponent.bulletSpawnOffset();
@@ -1535,8 +1619,8 @@ AiStatePilot::update(
 
     const SDL_Vector bulletPathEnd
     {
-      bulletPathStart.x + bulletSpeed * timeToAvoidBullet * std::sin(bulletDir),
-      bulletPathStart.y - bulletSpeed * timeToAvoidBullet * std::cos(bulletDir),
+      bulletPathStart.x + bulletSpeed * timeToAvoidBullet * bulletDir.x,
+      bulletPathStart.y + bulletSpeed * timeToAvoidBullet * bulletDir.y,
     };
 
     SDL_Vector contactPoint {};
@@ -1584,7 +1668,7 @@ AiStatePilot::update(
   }
 
 
-  std::vector <AiAction> actions {};
+  AiActionList actions {};
 
   const auto filteredMap = mInterestMap - mDangerMap;
 
@@ -1627,9 +1711,6 @@ AiStatePilot::update(
   }
 
 
-  std::sort(actions.begin(), actions.end());
-  actions.erase(std::unique(actions.begin(), actions.end()), actions.end());
-
   for ( auto& [action, temperature] : mActions )
   {
     const bool actionFound = std::find(
@@ -1645,12 +1726,12 @@ AiStatePilot::update(
   }
 }
 
-std::vector <AiAction>
+AiActionList
 AiStatePilot::actions() const
 {
   const float threshold = 0.7f;
 
-  std::vector <AiAction> actions {};
+  AiActionList actions {};
 
   for ( auto& [action, temperature] : mActions )
     if ( temperature >= threshold )
@@ -1667,10 +1748,35 @@ AiController::init()
     controller.init();
 }
 
+void
+AiController::setSeed(
+  const uint32_t seed )
+{
+  mRandom.seed(seed);
+  mIsRandomized = true;
+}
+
+float
+AiController::randomFactor()
+{
+  if ( mIsRandomized == false )
+    return 1.f;
+
+//  Standard distributions differ between libraries,
+//  this gives the same sequence everywhere
+  const float unit =
+    static_cast <float> (mRandom() - mRandom.min()) /
+    (mRandom.max() - mRandom.min());
+
+  return 0.25f + 0.75f * unit;
+}
+
 void
 AiController::update()
 {
-  for ( auto& [planeType, plane] : planes )
+  PROFILE_ZONE("AiController::update");
+
+  for ( auto& [planeType, plane] : world().planes )
   {
     if ( plane.isBot() == false && gameState().debug.ai == false )
       continue;
@@ -1685,11 +1791,15 @@ AiController::update()
 
 
     const auto& opponentPlane =
-      planes.at(static_cast <PLANE_TYPE> (!plane.type()));
+      world().planes.at(static_cast <PLANE_TYPE> (!plane.type()));
+
+    auto& opponentBullets = mOpponentBullets.at(plane.type());
 
-    const auto opponentBullets = bullets.GetClosestBullets(
+    world().bullets.GetClosestBullets(
       plane.x(), plane.y(),
-      plane.type() );
+      plane.type(),
+      constants::ai::trackedBullets,
+      opponentBullets );
 
     stateController.update(
       plane, opponentPlane,
@@ -1707,19 +1817,6 @@ AiController::update()
   }
 }
 
-void
-AiController::drawDebugLayer() const
-{
-  for ( auto& [planeType, plane] : planes )
-  {
-    auto& stateController = mStateController.at(plane.type());
-
-    if ( plane.isDead() == false )
-      stateController.drawDebugLayer(plane);
-  }
-}
-
-
 AiStateController::~AiStateController()
 {
   for ( const auto state : mStates )
@@ -1747,7 +1844,7 @@ void
 AiStateController::update(
   const Plane& self,
   const Plane& opponent,
-  const std::vector <Bullet>& opponentBullets )
+  const BulletSelection& opponentBullets )
 {
   assert(mStates.empty() == false);
   assert(mCurrentState != nullptr );
@@ -1766,15 +1863,6 @@ AiStateController::update(
       });
 }
 
-void
-AiStateController::drawDebugLayer(
-  const Plane& self ) const
-{
-  assert(mCurrentState != nullptr );
-
-  mCurrentState->drawDebugLayer(self);
-}
-
 const AiState*
 AiStateController::currentState() const
 {
@@ -1792,248 +1880,17 @@ void
 AiState::update(
   const Plane& self,
   const Plane& opponent,
-  const std::vector <Bullet>& opponentBullets )
+  const BulletSelection& opponentBullets )
 {
   mTemperature.update(0.f);
 }
 
-std::vector <AiAction>
+AiActionList
 AiState::actions() const
 {
   return {};
 }
 
-void
-AiState::drawDebugLayer(
-  const Plane& self ) const
-{
-  namespace plane = constants::plane;
-  namespace aiDebug = constants::ai::debug;
-  namespace aiColors = constants::colors::debug::ai;
-  namespace collisionColors = constants::colors::debug::collisions;
-
-
-  assert(mDangerMap.size() == mInterestMap.size());
-
-  for ( size_t i {}; i < mInterestMap.size(); ++i )
-  {
-    float dir {};
-
-    if ( self.hasJumped() == true )
-      dir = (-90.f + i * 180.f) * M_PI / 180.f;
-    else
-      dir = (i * plane::pitchStep) * M_PI / 180.f;
-
-
-    const SDL_Vector pos {self.pilot.x(), self.pilot.y()};
-
-    if ( mDangerMap[i] != 0.f )
-    {
-      const SDL_Vector target
-      {
-        pos.x + aiDebug::dangerMagnitude * mDangerMap[i] * std::sin(dir),
-        pos.y - aiDebug::dangerMagnitude * mDangerMap[i] * std::cos(dir),
-      };
-
-      setRenderColor(aiColors::danger);
-      SDL_RenderDrawLine(
-        gRenderer,
-        toWindowSpaceX(self.pilot.x()) - 2,
-        toWindowSpaceY(self.pilot.y()) - 2,
-        toWindowSpaceX(target.x) - 2,
-        toWindowSpaceY(target.y) - 2 );
-    }
-
-
-    if ( mInterestMap[i] != 0.f )
-    {
-      const SDL_Vector target
-      {
-        pos.x + aiDebug::interestMagnitude * mInterestMap[i] * std::sin(dir),
-        pos.y - aiDebug::interestMagnitude * mInterestMap[i] * std::cos(dir),
-      };
-
-      setRenderColor(aiColors::interest);
-      SDL_RenderDrawLine(
-        gRenderer,
-        toWindowSpaceX(self.pilot.x()) + 2,
-        toWindowSpaceY(self.pilot.y()) + 2,
-        toWindowSpaceX(target.x) + 2,
-        toWindowSpaceY(target.y) + 2 );
-    }
-
-
-    const auto heat = mInterestMap[i] - mDangerMap[i];
-
-    if ( heat > 0.f )
-    {
-      const SDL_Vector target
-      {
-        pos.x + aiDebug::heatMagnitude * heat * std::sin(dir),
-        pos.y - aiDebug::heatMagnitude * heat * std::cos(dir),
-      };
-
-      setRenderColor(aiColors::seek);
-      SDL_RenderDrawLine(
-        gRenderer,
-        toWindowSpaceX(self.pilot.x()),
-        toWindowSpaceY(self.pilot.y()),
-        toWindowSpaceX(target.x),
-        toWindowSpaceY(target.y) );
-    }
-  }
-
-
-  for ( auto& [action, temperature] : mActions )
-  {
-    SDL_FRect actionBox
-    {
-      aiDebug::actionGridOffsetX,
-      aiDebug::actionGridOffsetY,
-      aiDebug::actionBoxSizeX,
-      aiDebug::actionBoxSizeY,
-    };
-
-    switch(action)
-    {
-      case AiAction::Accelerate:
-      {
-        actionBox.x += 1.f * aiDebug::actionBoxStepX;
-        actionBox.y += 0.f * aiDebug::actionBoxStepY;
-
-        break;
-      }
-
-      case AiAction::Decelerate:
-      {
-        actionBox.x += 1.f * aiDebug::actionBoxStepX;
-        actionBox.y += 1.f * aiDebug::actionBoxStepY;
-
-        break;
-      }
-
-      case AiAction::TurnLeft:
-      {
-          actionBox.x += 0.f * aiDebug::actionBoxStepX;
-          actionBox.y += 1.f * aiDebug::actionBoxStepY;
-
-          break;
-      }
-
-      case AiAction::TurnRight:
-      {
-          actionBox.x += 2.f * aiDebug::actionBoxStepX;
-          actionBox.y += 1.f * aiDebug::actionBoxStepY;
-
-          break;
-      }
-
-      case AiAction::Shoot:
-      {
-          actionBox.x += 2.f * aiDebug::actionBoxStepX;
-          actionBox.y += 0.f * aiDebug::actionBoxStepY;
-
-          break;
-      }
-
-      case AiAction::Jump:
-      {
-          actionBox.x += 0.f * aiDebug::actionBoxStepX;
-          actionBox.y += 0.f * aiDebug::actionBoxStepY;
-
-          break;
-      }
-
-      default:
-        assert(false);
-    }
-
-    actionBox.x += self.pilot.x();
-    actionBox.y += self.pilot.y();
-
-    const auto actionGridRightBorder =
-      self.pilot.x() + aiDebug::actionGridOffsetX + 3.f * aiDebug::actionBoxStepX;
-
-    if ( actionGridRightBorder > 1.f )
-      actionBox.x -= actionGridRightBorder - 1.f;
-
-    const auto actionGridTopBorder =
-      self.pilot.y() + aiDebug::actionGridOffsetY;
-
-    if ( actionGridTopBorder < 0.f )
-      actionBox.y -= actionGridTopBorder;
-
-    actionBox =
-    {
-      toWindowSpaceX(actionBox.x),
-      toWindowSpaceY(actionBox.y),
-      scaleToScreenX(actionBox.w),
-      scaleToScreenY(actionBox.h),
-    };
-
-
-    setRenderColor(aiColors::actionBox);
-    SDL_RenderDrawRectF( gRenderer, &actionBox );
-
-
-    if ( temperature <= 0.f )
-      continue;
-
-    SDL_BlendMode currentBlendMode {};
-    SDL_GetRenderDrawBlendMode(
-      gRenderer,
-      &currentBlendMode );
-
-    SDL_SetRenderDrawBlendMode(
-      gRenderer,
-      SDL_BLENDMODE_BLEND );
-
-    auto actionBoxColor = aiColors::actionBox;
-    actionBoxColor.a *= temperature;
-
-    setRenderColor(actionBoxColor);
-    SDL_RenderFillRectF( gRenderer, &actionBox );
-
-    SDL_SetRenderDrawBlendMode(
-      gRenderer,
-      currentBlendMode );
-  }
-
-
-  if ( self.hasJumped() == false )
-  {
-    namespace barn = constants::barn;
-
-    setRenderColor(aiColors::planeSpeedVector);
-    SDL_RenderDrawLine(
-      gRenderer,
-      toWindowSpaceX(self.x()) + 4,
-      toWindowSpaceY(self.y()) + 4,
-      toWindowSpaceX(self.x() + self.speedVector().x * constants::tickRate) + 4,
-      toWindowSpaceY(self.y() + self.speedVector().y * constants::tickRate) + 4 );
-
-    const auto gravity = (self.maxSpeed() - self.speed());
-
-    setRenderColor(aiColors::planeGravityVector);
-    SDL_RenderDrawLine(
-      gRenderer,
-      toWindowSpaceX(self.x()) + 4,
-      toWindowSpaceY(self.y()) + 4,
-      toWindowSpaceX(self.x()) + 4,
-      toWindowSpaceY(self.y() + gravity) + 4 );
-
-    return;
-  }
-
-  setRenderColor(aiColors::pilotSpeedVector);
-  SDL_RenderDrawLine(
-    gRenderer,
-    toWindowSpaceX(self.pilot.x()) + 4,
-    toWindowSpaceY(self.pilot.y()) + 4,
-    toWindowSpaceX(self.pilot.x() + self.pilot.speedVec().x * constants::tickRate) + 4,
-    toWindowSpaceY(self.pilot.y() + self.pilot.speedVec().y * constants::tickRate) + 4 );
-}
-
 void
 AiState::setTemperature(
   const float newTemperature )
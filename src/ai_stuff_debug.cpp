@@ -0,0 +1,283 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/ai_stuff.hpp>
+#include <include/sdl.hpp>
+#include <include/constants.hpp>
+#include <include/plane.hpp>
+#include <include/world.hpp>
+#include <include/render.hpp>
+#include <include/math.hpp>
+
+#include <lib/SDL_Vector.h>
+
+#include <cmath>
+#include <cassert>
+
+
+void
+AiController::drawDebugLayer() const
+{
+  for ( auto& [planeType, plane] : world().planes )
+  {
+    auto& stateController = mStateController.at(plane.type());
+
+    if ( plane.isDead() == false )
+      stateController.drawDebugLayer(plane);
+  }
+}
+
+void
+AiStateController::drawDebugLayer(
+  const Plane& self ) const
+{
+  assert(mCurrentState != nullptr );
+
+  mCurrentState->drawDebugLayer(self);
+}
+
+void
+AiState::drawDebugLayer(
+  const Plane& self ) const
+{
+  namespace plane = constants::plane;
+  namespace aiDebug = constants::ai::debug;
+  namespace aiColors = constants::colors::debug::ai;
+  namespace collisionColors = constants::colors::debug::collisions;
+
+
+  assert(mDangerMap.size() == mInterestMap.size());
+
+  for ( size_t i {}; i < mInterestMap.size(); ++i )
+  {
+    const auto dir =
+      self.hasJumped() == true
+      ? direction_vector(-90.f + i * 180.f)
+      : pitch_direction(i);
+
+
+    const SDL_Vector pos {self.pilot.x(), self.pilot.y()};
+
+    if ( mDangerMap[i] != 0.f )
+    {
+      const SDL_Vector target
+      {
+        pos.x + aiDebug::dangerMagnitude * mDangerMap[i] * dir.x,
+        pos.y + aiDebug::dangerMagnitude * mDangerMap[i] * dir.y,
+      };
+
+      setRenderColor(aiColors::danger);
+      SDL_RenderDrawLine(
+        gRenderer,
+        toWindowSpaceX(self.pilot.x()) - 2,
+        toWindowSpaceY(self.pilot.y()) - 2,
+        toWindowSpaceX(target.x) - 2,
+        toWindowSpaceY(target.y) - 2 );
+    }
+
+
+    if ( mInterestMap[i] != 0.f )
+    {
+      const SDL_Vector target
+      {
+        pos.x + aiDebug::interestMagnitude * mInterestMap[i] * dir.x,
+        pos.y + aiDebug::interestMagnitude * mInterestMap[i] * dir.y,
+      };
+
+      setRenderColor(aiColors::interest);
+      SDL_RenderDrawLine(
+        gRenderer,
+        toWindowSpaceX(self.pilot.x()) + 2,
+        toWindowSpaceY(self.pilot.y()) + 2,
+        toWindowSpaceX(target.x) + 2,
+        toWindowSpaceY(target.y) + 2 );
+    }
+
+
+    const auto heat = mInterestMap[i] - mDangerMap[i];
+
+    if ( heat > 0.f )
+    {
+      const SDL_Vector target
+      {
+        pos.x + aiDebug::heatMagnitude * heat * dir.x,
+        pos.y + aiDebug::heatMagnitude * heat * dir.y,
+      };
+
+      setRenderColor(aiColors::seek);
+      SDL_RenderDrawLine(
+        gRenderer,
+        toWindowSpaceX(self.pilot.x()),
+        toWindowSpaceY(self.pilot.y()),
+        toWindowSpaceX(target.x),
+        toWindowSpaceY(target.y) );
+    }
+  }
+
+
+  for ( auto& [action, temperature] : mActions )
+  {
+    SDL_FRect actionBox
+    {
+      aiDebug::actionGridOffsetX,
+      aiDebug::actionGridOffsetY,
+      aiDebug::actionBoxSizeX,
+      aiDebug::actionBoxSizeY,
+    };
+
+    switch(action)
+    {
+      case AiAction::Accelerate:
+      {
+        actionBox.x += 1.f * aiDebug::actionBoxStepX;
+        actionBox.y += 0.f * aiDebug::actionBoxStepY;
+
+        break;
+      }
+
+      case AiAction::Decelerate:
+      {
+        actionBox.x += 1.f * aiDebug::actionBoxStepX;
+        actionBox.y += 1.f * aiDebug::actionBoxStepY;
+
+        break;
+      }
+
+      case AiAction::TurnLeft:
+      {
+          actionBox.x += 0.f * aiDebug::actionBoxStepX;
+          actionBox.y += 1.f * aiDebug::actionBoxStepY;
+
+          break;
+      }
+
+      case AiAction::TurnRight:
+      {
+          actionBox.x += 2.f * aiDebug::actionBoxStepX;
+          actionBox.y += 1.f * aiDebug::actionBoxStepY;
+
+          break;
+      }
+
+      case AiAction::Shoot:
+      {
+          actionBox.x += 2.f * aiDebug::actionBoxStepX;
+          actionBox.y += 0.f * aiDebug::actionBoxStepY;
+
+          break;
+      }
+
+      case AiAction::Jump:
+      {
+          actionBox.x += 0.f * aiDebug::actionBoxStepX;
+          actionBox.y += 0.f * aiDebug::actionBoxStepY;
+
+          break;
+      }
+
+      default:
+        assert(false);
+    }
+
+    actionBox.x += self.pilot.x();
+    actionBox.y += self.pilot.y();
+
+    const auto actionGridRightBorder =
+      self.pilot.x() + aiDebug::actionGridOffsetX + 3.f * aiDebug::actionBoxStepX;
+
+    if ( actionGridRightBorder > 1.f )
+      actionBox.x -= actionGridRightBorder - 1.f;
+
+    const auto actionGridTopBorder =
+      self.pilot.y() + aiDebug::actionGridOffsetY;
+
+    if ( actionGridTopBorder < 0.f )
+      actionBox.y -= actionGridTopBorder;
+
+    actionBox =
+    {
+      toWindowSpaceX(actionBox.x),
+      toWindowSpaceY(actionBox.y),
+      scaleToScreenX(actionBox.w),
+      scaleToScreenY(actionBox.h),
+    };
+
+
+    setRenderColor(aiColors::actionBox);
+    SDL_RenderDrawRectF( gRenderer, &actionBox );
+
+
+    if ( temperature <= 0.f )
+      continue;
+
+    SDL_BlendMode currentBlendMode {};
+    SDL_GetRenderDrawBlendMode(
+      gRenderer,
+      &currentBlendMode );
+
+    SDL_SetRenderDrawBlendMode(
+      gRenderer,
+      SDL_BLENDMODE_BLEND );
+
+    auto actionBoxColor = aiColors::actionBox;
+    actionBoxColor.a *= temperature;
+
+    setRenderColor(actionBoxColor);
+    SDL_RenderFillRectF( gRenderer, &actionBox );
+
+    SDL_SetRenderDrawBlendMode(
+      gRenderer,
+      currentBlendMode );
+  }
+
+
+  if ( self.hasJumped() == false )
+  {
+    namespace barn = constants::barn;
+
+    setRenderColor(aiColors::planeSpeedVector);
+    SDL_RenderDrawLine(
+      gRenderer,
+      toWindowSpaceX(self.x()) + 4,
+      toWindowSpaceY(self.y()) + 4,
+      toWindowSpaceX(self.x() + self.speedVector().x * constants::tickRate) + 4,
+      toWindowSpaceY(self.y() + self.speedVector().y * constants::tickRate) + 4 );
+
+    const auto gravity = (self.maxSpeed() - self.speed());
+
+    setRenderColor(aiColors::planeGravityVector);
+    SDL_RenderDrawLine(
+      gRenderer,
+      toWindowSpaceX(self.x()) + 4,
+      toWindowSpaceY(self.y()) + 4,
+      toWindowSpaceX(self.x()) + 4,
+      toWindowSpaceY(self.y() + gravity) + 4 );
+
+    return;
+  }
+
+  setRenderColor(aiColors::pilotSpeedVector);
+  SDL_RenderDrawLine(
+    gRenderer,
+    toWindowSpaceX(self.pilot.x()) + 4,
+    toWindowSpaceY(self.pilot.y()) + 4,
+    toWindowSpaceX(self.pilot.x() + self.pilot.speedVec().x * constants::tickRate) + 4,
+    toWindowSpaceY(self.pilot.y() + self.pilot.speedVec().y * constants::tickRate) + 4 );
+}
@@ -0,0 +1,379 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/asset_pack.hpp>
+#include <include/sdl.hpp>
+#include <include/utility.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#elif !defined(VITA_PLATFORM) && !defined(__EMSCRIPTEN__)
+  #define BIPLANES_ASSET_PACK_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+
+AssetPack::~AssetPack()
+{
+  Close();
+}
+
+bool
+AssetPack::Open(
+  const std::string& assetsRoot )
+{
+  Close();
+
+
+  const auto path = assetsRoot + ".bpak";
+
+  if ( Map(path) == false )
+    return false;
+
+
+  if ( Validate() == false )
+  {
+    log_message( "RESOURCES: Asset pack '" + path + "' is corrupted or outdated, ignoring it" );
+    Close();
+
+    return false;
+  }
+
+  mRoot = assetsRoot;
+
+  log_message( "RESOURCES: Using asset pack '" + path + "' with " +
+    std::to_string(mEntryCount) + " assets" );
+
+  return true;
+}
+
+void
+AssetPack::Close()
+{
+  Unmap();
+
+  mRoot.clear();
+  mEntries = {};
+  mEntryCount = {};
+}
+
+bool
+AssetPack::isOpen() const
+{
+  return mData != nullptr;
+}
+
+
+bool
+AssetPack::Map(
+  const std::string& path )
+{
+#if defined(_WIN32)
+
+  mFile = CreateFileA(
+    path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+
+  if ( mFile == INVALID_HANDLE_VALUE )
+  {
+    mFile = {};
+    return false;
+  }
+
+  LARGE_INTEGER fileSize {};
+  GetFileSizeEx(mFile, &fileSize);
+
+  mMapping = CreateFileMappingA(
+    mFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+
+  if ( mMapping != nullptr )
+    mData = static_cast <const uint8_t*> (
+      MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0) );
+
+  if ( mData == nullptr )
+  {
+    Unmap();
+    return false;
+  }
+
+  mSize = fileSize.QuadPart;
+
+#elif defined(BIPLANES_ASSET_PACK_MMAP)
+
+  const int file = open(path.c_str(), O_RDONLY);
+
+  if ( file < 0 )
+    return false;
+
+
+  struct stat fileStat {};
+
+  if ( fstat(file, &fileStat) != 0 || fileStat.st_size == 0 )
+  {
+    close(file);
+    return false;
+  }
+
+  void* const data = mmap(
+    nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0 );
+
+//  Mapping stays valid after the descriptor is closed
+  close(file);
+
+  if ( data == MAP_FAILED )
+    return false;
+
+  mData = static_cast <const uint8_t*> (data);
+  mSize = fileStat.st_size;
+
+#else
+
+//  No mmap here, but a single sequential read
+//  is still far cheaper than opening every asset
+  std::ifstream file {path, std::ios::binary | std::ios::ate};
+
+  if ( file.is_open() == false )
+    return false;
+
+  mBuffer.resize(file.tellg());
+  file.seekg(0);
+
+  if ( mBuffer.empty() == true ||
+       file.read(reinterpret_cast <char*> (mBuffer.data()), mBuffer.size()).fail() == true )
+  {
+    mBuffer.clear();
+    return false;
+  }
+
+  mData = mBuffer.data();
+  mSize = mBuffer.size();
+
+#endif
+
+  return true;
+}
+
+void
+AssetPack::Unmap()
+{
+#if defined(_WIN32)
+
+  if ( mData != nullptr )
+    UnmapViewOfFile(mData);
+
+  if ( mMapping != nullptr )
+    CloseHandle(mMapping);
+
+  if ( mFile != nullptr )
+    CloseHandle(mFile);
+
+  mMapping = {};
+  mFile = {};
+
+#elif defined(BIPLANES_ASSET_PACK_MMAP)
+
+  if ( mData != nullptr )
+    munmap(const_cast <uint8_t*> (mData), mSize);
+
+#else
+
+  mBuffer.clear();
+  mBuffer.shrink_to_fit();
+
+#endif
+
+  mData = {};
+  mSize = {};
+}
+
+bool
+AssetPack::Validate()
+{
+  AssetPackHeader header {};
+
+  if ( mSize < sizeof(header) )
+    return false;
+
+  std::memcpy(&header, mData, sizeof(header));
+
+  if (  std::memcmp(header.magic, AssetPackHeader{}.magic, sizeof(header.magic)) != 0 ||
+        header.version != version )
+    return false;
+
+
+  const uint64_t entriesSize =
+    uint64_t{header.entryCount} * sizeof(AssetPackEntry);
+
+  if ( sizeof(header) + entriesSize > mSize )
+    return false;
+
+
+  const auto entries = reinterpret_cast <const AssetPackEntry*> (
+    mData + sizeof(header) );
+
+  for ( uint32_t i {}; i < header.entryCount; ++i )
+  {
+    const auto& entry = entries[i];
+
+    if (  entry.name[sizeof(entry.name) - 1] != '\0' ||
+          entry.offset > mSize ||
+          entry.size > mSize - entry.offset )
+      return false;
+
+    if (  entry.type == ASSET_TYPE::IMAGE &&
+          uint64_t{entry.width} * entry.height * 4 != entry.size )
+      return false;
+
+//    Lookups rely on binary search
+    if ( i > 0 && std::strcmp(entries[i - 1].name, entry.name) >= 0 )
+      return false;
+  }
+
+  mEntries = entries;
+  mEntryCount = header.entryCount;
+
+  return true;
+}
+
+
+const AssetPackEntry*
+AssetPack::find(
+  const std::string& path ) const
+{
+  if ( isOpen() == false )
+    return nullptr;
+
+  if (  path.size() <= mRoot.size() + 1 ||
+        path.compare(0, mRoot.size(), mRoot) != 0 ||
+        path[mRoot.size()] != '/' )
+    return nullptr;
+
+
+  const auto name = path.c_str() + mRoot.size() + 1;
+
+  const auto entriesEnd = mEntries + mEntryCount;
+
+  const auto entry = std::lower_bound(
+    mEntries, entriesEnd, name,
+    [] ( const AssetPackEntry& lhs, const char* rhs )
+    {
+      return std::strcmp(lhs.name, rhs) < 0;
+    });
+
+  if ( entry == entriesEnd || std::strcmp(entry->name, name) != 0 )
+    return nullptr;
+
+  return entry;
+}
+
+SDL_Surface*
+AssetPack::LoadSurface(
+  const std::string& path ) const
+{
+  const auto entry = find(path);
+
+  if ( entry == nullptr || entry->type != ASSET_TYPE::IMAGE )
+    return nullptr;
+
+
+//  Surface never writes to its pixels, so a read-only mapping is fine
+  return SDL_CreateRGBSurfaceWithFormatFrom(
+    const_cast <uint8_t*> (mData + entry->offset),
+    entry->width,
+    entry->height,
+    32,
+    entry->width * 4,
+    SDL_PIXELFORMAT_RGBA32 );
+}
+
+Mix_Chunk*
+AssetPack::LoadSound(
+  const std::string& path ) const
+{
+  const auto entry = find(path);
+
+  if ( entry == nullptr || entry->type != ASSET_TYPE::SOUND )
+    return nullptr;
+
+
+  int sampleRate {};
+  uint16_t audioFormat {};
+  int channels {};
+
+//  Mixer isn't opened when sound is disabled
+  if ( Mix_QuerySpec(&sampleRate, &audioFormat, &channels) == 0 )
+    return nullptr;
+
+
+  auto samples = const_cast <uint8_t*> (mData + entry->offset);
+
+  if (  entry->sampleRate == static_cast <uint32_t> (sampleRate) &&
+        entry->audioFormat == audioFormat &&
+        entry->channels == channels )
+    return Mix_QuickLoad_RAW(samples, entry->size);
+
+
+  SDL_AudioCVT converter {};
+
+  if ( SDL_BuildAudioCVT(
+        &converter,
+        entry->audioFormat, entry->channels, entry->sampleRate,
+        audioFormat, channels, sampleRate ) < 0 )
+    return nullptr;
+
+
+  converter.len = entry->size;
+  converter.buf = static_cast <uint8_t*> (
+    SDL_malloc(converter.len * converter.len_mult) );
+
+  if ( converter.buf == nullptr )
+    return nullptr;
+
+  std::memcpy(converter.buf, samples, entry->size);
+
+  if ( SDL_ConvertAudio(&converter) != 0 )
+  {
+    SDL_free(converter.buf);
+    return nullptr;
+  }
+
+
+  auto* const chunk = Mix_QuickLoad_RAW(converter.buf, converter.len_cvt);
+
+  if ( chunk == nullptr )
+  {
+    SDL_free(converter.buf);
+    return nullptr;
+  }
+
+//  Let Mix_FreeChunk() free the converted samples
+  chunk->allocated = 1;
+
+  return chunk;
+}
@@ -0,0 +1,268 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Offline asset packer. Decodes every image and sound
+//  under the assets directory once, so that the game can
+//  load them straight from a single archive (see AssetPack).
+
+#define SDL_MAIN_HANDLED
+
+#include <include/asset_pack.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+namespace fs = std::filesystem;
+
+
+struct PackedAsset
+{
+  AssetPackEntry entry {};
+  std::vector <uint8_t> data {};
+};
+
+
+static bool
+decodeImage(
+  const fs::path& path,
+  PackedAsset& asset )
+{
+  auto* const loaded = IMG_Load(path.string().c_str());
+
+  if ( loaded == nullptr )
+    return false;
+
+  auto* const surface = SDL_ConvertSurfaceFormat(
+    loaded, SDL_PIXELFORMAT_RGBA32, 0 );
+
+  SDL_FreeSurface(loaded);
+
+  if ( surface == nullptr )
+    return false;
+
+
+  const size_t rowSize = surface->w * 4;
+
+  asset.entry.type = ASSET_TYPE::IMAGE;
+  asset.entry.width = surface->w;
+  asset.entry.height = surface->h;
+  asset.data.resize(rowSize * surface->h);
+
+  SDL_LockSurface(surface);
+
+//  Drop row padding, archive pixels are tightly packed
+  for ( int y {}; y < surface->h; ++y )
+    std::memcpy(
+      asset.data.data() + y * rowSize,
+      static_cast <const uint8_t*> (surface->pixels) + y * surface->pitch,
+      rowSize );
+
+  SDL_UnlockSurface(surface);
+  SDL_FreeSurface(surface);
+
+  return true;
+}
+
+static bool
+decodeSound(
+  const fs::path& path,
+  PackedAsset& asset )
+{
+  auto* const chunk = Mix_LoadWAV(path.string().c_str());
+
+  if ( chunk == nullptr )
+    return false;
+
+
+  int sampleRate {};
+  uint16_t audioFormat {};
+  int channels {};
+
+  Mix_QuerySpec(&sampleRate, &audioFormat, &channels);
+
+  asset.entry.type = ASSET_TYPE::SOUND;
+  asset.entry.sampleRate = sampleRate;
+  asset.entry.audioFormat = audioFormat;
+  asset.entry.channels = channels;
+  asset.data.assign(chunk->abuf, chunk->abuf + chunk->alen);
+
+  Mix_FreeChunk(chunk);
+
+  return true;
+}
+
+static bool
+writePack(
+  const fs::path& outputPath,
+  std::vector <PackedAsset>& assets )
+{
+  std::ofstream output {outputPath, std::ios::binary};
+
+  if ( output.is_open() == false )
+    return false;
+
+
+  AssetPackHeader header {};
+  header.version = AssetPack::version;
+  header.entryCount = assets.size();
+
+  const auto alignment = AssetPack::dataAlignment;
+
+  uint64_t offset =
+    sizeof(header) + assets.size() * sizeof(AssetPackEntry);
+
+  for ( auto& asset : assets )
+  {
+    offset = (offset + alignment - 1) / alignment * alignment;
+
+    asset.entry.offset = offset;
+    asset.entry.size = asset.data.size();
+
+    offset += asset.data.size();
+  }
+
+
+  output.write(reinterpret_cast <const char*> (&header), sizeof(header));
+
+  for ( const auto& asset : assets )
+    output.write(
+      reinterpret_cast <const char*> (&asset.entry),
+      sizeof(asset.entry) );
+
+  for ( const auto& asset : assets )
+  {
+    const std::vector <char> padding (
+      asset.entry.offset - static_cast <uint64_t> (output.tellp()) );
+
+    output.write(padding.data(), padding.size());
+    output.write(
+      reinterpret_cast <const char*> (asset.data.data()),
+      asset.data.size() );
+  }
+
+  return output.good();
+}
+
+int
+main(
+  int argc,
+  char* args[] )
+{
+  if ( argc != 3 )
+  {
+    std::printf(
+      "Usage: %s <assets directory> <output file>\n"
+      "The game looks for '<assets directory>.bpak', e.g. 'assets.bpak'\n",
+      args[0] );
+
+    return 1;
+  }
+
+
+  const fs::path assetsRoot {args[1]};
+  const fs::path outputPath {args[2]};
+
+//  Sounds are decoded by the mixer, which needs an audio device.
+//  Use the same output format as the game, so that it can play
+//  packed samples without converting them.
+  SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+
+  if (  SDL_Init(SDL_INIT_AUDIO) != 0 ||
+        Mix_OpenAudio( 44100, MIX_DEFAULT_FORMAT, 2, 2048 ) != 0 )
+  {
+    std::fprintf( stderr, "Failed to open audio: %s\n", SDL_GetError() );
+    return 1;
+  }
+
+
+  std::vector <fs::path> files {};
+
+  for ( const auto& file : fs::recursive_directory_iterator(assetsRoot) )
+    if ( file.is_regular_file() == true )
+      files.push_back(file.path());
+
+
+  std::vector <PackedAsset> assets {};
+
+  for ( const auto& file : files )
+  {
+    const auto extension = file.extension().string();
+    const auto name = file.lexically_relative(assetsRoot).generic_string();
+
+    PackedAsset asset {};
+
+    if ( name.size() >= sizeof(asset.entry.name) )
+    {
+      std::fprintf( stderr, "Skipping '%s': name is too long\n", name.c_str() );
+      continue;
+    }
+
+    bool isDecoded {};
+
+    if ( extension == ".png" )
+      isDecoded = decodeImage(file, asset);
+
+    else if ( extension == ".ogg" || extension == ".wav" )
+      isDecoded = decodeSound(file, asset);
+
+    else
+      continue;
+
+
+    if ( isDecoded == false )
+    {
+      std::fprintf( stderr, "Failed to decode '%s': %s\n",
+        name.c_str(), SDL_GetError() );
+      return 1;
+    }
+
+    std::strncpy(asset.entry.name, name.c_str(), sizeof(asset.entry.name) - 1);
+    assets.push_back(std::move(asset));
+  }
+
+  Mix_CloseAudio();
+  SDL_Quit();
+
+
+  std::sort(
+    assets.begin(), assets.end(),
+    [] ( const PackedAsset& lhs, const PackedAsset& rhs )
+    {
+      return std::strcmp(lhs.entry.name, rhs.entry.name) < 0;
+    });
+
+  if ( writePack(outputPath, assets) == false )
+  {
+    std::fprintf( stderr, "Failed to write '%s'\n",
+      outputPath.string().c_str() );
+    return 1;
+  }
+
+  std::printf( "Packed %zu assets into '%s'\n",
+    assets.size(), outputPath.string().c_str() );
+
+  return 0;
+}
@@ -0,0 +1,504 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/atlas.hpp>
+#include <include/asset_pack.hpp>
+#include <include/sdl.hpp>
+#include <include/utility.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+
+//  Bump whenever packing or the layout file changes
+static constexpr int cacheVersion {1};
+
+
+static std::string
+get_page_path(
+  const std::string& cachePath,
+  const size_t page )
+{
+  return cachePath + std::to_string(page) + ".png";
+}
+
+
+size_t
+TextureAtlas::Add(
+  const std::string& path )
+{
+  Image image {};
+  image.path = path;
+
+  std::error_code error {};
+
+  image.fileSize = std::filesystem::file_size(path, error);
+
+  const auto modificationTime =
+    std::filesystem::last_write_time(path, error);
+
+  if ( static_cast <bool> (error) == false )
+    image.modificationTime = modificationTime.time_since_epoch().count();
+
+
+  mImages.push_back(image);
+
+  return mImages.size() - 1;
+}
+
+void
+TextureAtlas::Prepare(
+  const std::string& cachePath,
+  const AssetPack& assetPack )
+{
+  FreeSurfaces();
+
+  mCachePath = cachePath;
+  mIsCacheEnabled = assetPack.isOpen() == false;
+  mIsCached = mIsCacheEnabled == true && LoadCacheLayout() == true;
+
+  if ( mIsCached == false )
+    mSurfaces.resize(mImages.size());
+
+  mErrors.resize(mSurfaces.size());
+}
+
+void
+TextureAtlas::Decode(
+  const size_t index,
+  const AssetPack& assetPack )
+{
+  if ( index >= mSurfaces.size() )
+    return;
+
+
+  if ( mIsCached == true )
+  {
+    mSurfaces[index] = IMG_Load( get_page_path(mCachePath, index).c_str() );
+
+    if ( mSurfaces[index] == nullptr )
+      mErrors[index] = IMG_GetError();
+
+    return;
+  }
+
+  mSurfaces[index] = LoadImage(index, assetPack, mErrors[index]);
+}
+
+void
+TextureAtlas::Upload(
+  const AssetPack& assetPack )
+{
+  if ( mIsCached == true )
+  {
+    for ( const auto page : mSurfaces )
+    {
+      SDL_Texture* texture {};
+
+      if ( page != nullptr )
+        texture = SDL_CreateTextureFromSurface(gRenderer, page);
+
+      mPages.push_back(texture);
+    }
+
+    FreeSurfaces();
+
+    const bool isComplete = std::all_of(
+      mPages.begin(), mPages.end(),
+      [] ( const SDL_Texture* page )
+      {
+        return page != nullptr;
+      });
+
+    if ( isComplete == true )
+    {
+      log_message( "RESOURCES: Loaded texture atlas from '" + mCachePath + "'" );
+      return;
+    }
+
+
+//    Stale or broken cache: decode every image right here
+    log_message( "RESOURCES: Can't load texture atlas from '" + mCachePath + "', repacking" );
+
+    for ( const auto page : mPages )
+      SDL_DestroyTexture(page);
+
+    mPages.clear();
+
+    mIsCached = false;
+    mSurfaces.resize(mImages.size());
+    mErrors.resize(mImages.size());
+
+    for ( size_t i {}; i < mImages.size(); ++i )
+      Decode(i, assetPack);
+  }
+
+
+  for ( size_t i {}; i < mSurfaces.size(); ++i )
+  {
+    if ( mSurfaces[i] != nullptr )
+      continue;
+
+    const auto& path = mImages[i].path;
+
+    log_message( "\n\nResources: Unable to load image '" + path + "'\nSDL_image Error: ", mErrors[i] );
+    show_warning( "Unable to load texture!", path );
+  }
+
+
+  const auto pages = Pack();
+
+  for ( const auto page : pages )
+  {
+    auto* const texture = SDL_CreateTextureFromSurface(gRenderer, page);
+
+    if ( texture == nullptr )
+      log_message( "\n\nSDL Error: Unable to create atlas texture\nSDL Error: ", SDL_GetError() );
+
+    mPages.push_back(texture);
+  }
+
+
+  const bool isComplete = std::all_of(
+    mImages.begin(), mImages.end(),
+    [] ( const Image& image )
+    {
+      return image.rect.w > 0;
+    });
+
+//  Don't cache missing images, so that they're reported again
+  if ( isComplete == true && mIsCacheEnabled == true )
+    SaveCache(pages);
+
+  for ( const auto page : pages )
+    SDL_FreeSurface(page);
+
+
+  log_message( "RESOURCES: Packed " + std::to_string(mImages.size()) +
+    " images into " + std::to_string(mPages.size()) + " atlas pages" );
+}
+
+void
+TextureAtlas::Unload()
+{
+  FreeSurfaces();
+
+  for ( const auto page : mPages )
+    SDL_DestroyTexture(page);
+
+  mPages.clear();
+  mImages.clear();
+}
+
+TextureAtlas::Region
+TextureAtlas::region(
+  const size_t image ) const
+{
+  if ( image >= mImages.size() )
+    return {};
+
+
+  const auto& instance = mImages[image];
+
+  if ( instance.page >= mPages.size() )
+    return {};
+
+  return {mPages[instance.page], instance.rect};
+}
+
+size_t
+TextureAtlas::pageCount() const
+{
+  return mPages.size();
+}
+
+size_t
+TextureAtlas::decodeCount() const
+{
+  return mSurfaces.size();
+}
+
+
+SDL_Surface*
+TextureAtlas::LoadImage(
+  const size_t image,
+  const AssetPack& assetPack,
+  std::string& error ) const
+{
+  const auto& path = mImages[image].path;
+
+  auto* surface = assetPack.LoadSurface(path);
+
+  if ( surface == nullptr )
+    surface = IMG_Load( path.c_str() );
+
+  if ( surface == nullptr )
+  {
+    error = IMG_GetError();
+    return nullptr;
+  }
+
+
+  auto* const converted =
+    SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+
+  SDL_FreeSurface(surface);
+
+  if ( converted == nullptr )
+    error = SDL_GetError();
+
+  return converted;
+}
+
+std::vector <SDL_Surface*>
+TextureAtlas::Pack()
+{
+//  Surfaces are consumed by the pages
+  std::vector <SDL_Surface*> surfaces {};
+  surfaces.swap(mSurfaces);
+  mErrors.clear();
+
+
+//  Shelf packing: tallest images go first,
+//  so that every shelf wastes as little height as possible
+  std::vector <size_t> order (mImages.size());
+  std::iota(order.begin(), order.end(), 0);
+
+  const auto imageHeight =
+  [&surfaces] ( const size_t i )
+  {
+    return surfaces[i] != nullptr ? surfaces[i]->h : 0;
+  };
+
+  std::stable_sort(
+    order.begin(), order.end(),
+    [&imageHeight] ( const size_t lhs, const size_t rhs )
+    {
+      return imageHeight(lhs) > imageHeight(rhs);
+    });
+
+
+  struct PageLayout
+  {
+    int width {};
+    int height {};
+
+    int shelfX {};
+    int shelfY {};
+    int shelfHeight {};
+  };
+
+  std::vector <PageLayout> layouts {};
+
+  for ( const auto i : order )
+  {
+    auto& image = mImages[i];
+    const auto surface = surfaces[i];
+
+    image.page = 0;
+    image.rect = {};
+
+    if ( surface == nullptr )
+      continue;
+
+
+    const int width = surface->w + padding;
+    const int height = surface->h + padding;
+
+    if ( layouts.empty() == true )
+      layouts.emplace_back();
+
+    auto* layout = &layouts.back();
+
+    if ( layout->shelfX + width > maxPageSize )
+    {
+      layout->shelfX = 0;
+      layout->shelfY += layout->shelfHeight;
+      layout->shelfHeight = 0;
+    }
+
+//    Images larger than a page get a page of their own
+    const bool isPageEmpty =
+      layout->shelfX == 0 &&
+      layout->shelfY == 0;
+
+    if (  layout->shelfY + height > maxPageSize &&
+          isPageEmpty == false )
+    {
+      layouts.emplace_back();
+      layout = &layouts.back();
+    }
+
+
+    image.page = layouts.size() - 1;
+    image.rect =
+    {
+      layout->shelfX,
+      layout->shelfY,
+      surface->w,
+      surface->h,
+    };
+
+    layout->shelfX += width;
+    layout->shelfHeight = std::max(layout->shelfHeight, height);
+
+    layout->width = std::max(layout->width, layout->shelfX);
+    layout->height = std::max(layout->height, layout->shelfY + layout->shelfHeight);
+  }
+
+
+  std::vector <SDL_Surface*> pages {};
+
+  for ( const auto& layout : layouts )
+    pages.push_back(SDL_CreateRGBSurfaceWithFormat(
+      0, layout.width, layout.height, 32, SDL_PIXELFORMAT_RGBA32 ));
+
+  for ( size_t i {}; i < mImages.size(); ++i )
+  {
+    const auto surface = surfaces[i];
+
+    if ( surface == nullptr )
+      continue;
+
+
+    const auto& image = mImages[i];
+    auto* const page = pages[image.page];
+
+    if ( page != nullptr )
+    {
+//      Copy alpha as is instead of blending with the empty page
+      auto destination = image.rect;
+
+      SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+      SDL_BlitSurface(surface, nullptr, page, &destination);
+    }
+
+    SDL_FreeSurface(surface);
+  }
+
+  return pages;
+}
+
+bool
+TextureAtlas::LoadCacheLayout()
+{
+  std::ifstream layout {mCachePath + ".txt"};
+
+  if ( layout.is_open() == false )
+    return false;
+
+
+  int version {};
+  size_t pageCount {};
+  size_t imageCount {};
+
+  layout >> version >> pageCount >> imageCount;
+
+  if (  layout.fail() == true ||
+        version != cacheVersion ||
+        imageCount != mImages.size() )
+    return false;
+
+
+  auto images = mImages;
+
+  for ( auto& image : images )
+  {
+    Image cached {};
+
+    layout
+      >> cached.fileSize
+      >> cached.modificationTime
+      >> cached.page
+      >> cached.rect.x >> cached.rect.y
+      >> cached.rect.w >> cached.rect.h
+      >> std::ws;
+
+    std::getline(layout, cached.path);
+
+    if (  layout.fail() == true ||
+          cached.path != image.path ||
+          cached.fileSize != image.fileSize ||
+          cached.modificationTime != image.modificationTime ||
+          cached.page >= pageCount )
+      return false;
+
+    image.page = cached.page;
+    image.rect = cached.rect;
+  }
+
+
+//  Pages are decoded later, like images are
+  mImages = std::move(images);
+  mSurfaces.resize(pageCount);
+
+  return true;
+}
+
+void
+TextureAtlas::SaveCache(
+  const std::vector <SDL_Surface*>& pages ) const
+{
+  for ( size_t i {}; i < pages.size(); ++i )
+  {
+    if (  pages[i] != nullptr &&
+          IMG_SavePNG(pages[i], get_page_path(mCachePath, i).c_str()) == 0 )
+      continue;
+
+    log_message( "RESOURCES: Can't write texture atlas to '" + mCachePath + "'" );
+    return;
+  }
+
+
+  std::ofstream layout {mCachePath + ".txt"};
+
+  if ( layout.is_open() == false )
+  {
+    log_message( "RESOURCES: Can't write texture atlas to '" + mCachePath + "'" );
+    return;
+  }
+
+
+  layout
+    << cacheVersion << ' '
+    << pages.size() << ' '
+    << mImages.size() << '\n';
+
+  for ( const auto& image : mImages )
+    layout
+      << image.fileSize << ' '
+      << image.modificationTime << ' '
+      << image.page << ' '
+      << image.rect.x << ' ' << image.rect.y << ' '
+      << image.rect.w << ' ' << image.rect.h << ' '
+      << image.path << '\n';
+}
+
+void
+TextureAtlas::FreeSurfaces()
+{
+  for ( const auto surface : mSurfaces )
+    SDL_FreeSurface(surface);
+
+  mSurfaces.clear();
+  mErrors.clear();
+}
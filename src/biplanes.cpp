@@ -23,10 +23,12 @@
 #include <include/time.hpp>
 #include <include/constants.hpp>
 #include <include/resources.hpp>
+#include <include/resource_cache.hpp>
 #include <include/game_state.hpp>
 #include <include/network.hpp>
 #include <include/network_data.hpp>
 #include <include/network_state.hpp>
+#include <include/rollback.hpp>
 #include <include/menu.hpp>
 #include <include/render.hpp>
 #include <include/plane.hpp>
@@ -42,6 +44,10 @@
 #include <include/utility.hpp>
 #include <include/variables.hpp>
 #include <include/ai_stuff.hpp>
+#include <include/simulation.hpp>
+#include <include/world.hpp>
+#include <include/profiler.hpp>
+#include <include/perf_hud.hpp>
 
 #if defined(__EMSCRIPTEN__)
   #include <emscripten/emscripten.h>
@@ -54,9 +60,16 @@
   #include <lib/Net.h>
 #endif
 
+#if !defined(__EMSCRIPTEN__)
+  #include <include/plane_smoothing.hpp>
+#endif
+
 #include <lib/picojson.h>
 #include <TimeUtils/Duration.hpp>
 
+#include <cstdlib>
+#include <cstring>
+
 using TimeUtils::Duration;
 
 
@@ -74,7 +87,10 @@ std::string MMAKE_PASSWORD {};
 
 static Duration packetSendTime {};
 
-const static int32_t ProtocolId {0x11223344};
+#if !defined(__EMSCRIPTEN__)
+static PlaneSmoothing remotePlaneSmoothing {};
+#endif
+
 const static float ConnectionTimeout {10.0f};
 
 
@@ -84,27 +100,6 @@ Sounds sounds {};
 
 Menu menu {};
 
-std::map <PLANE_TYPE, Plane> planes
-{
-  {PLANE_TYPE::BLUE, {PLANE_TYPE::BLUE}},
-  {PLANE_TYPE::RED, {PLANE_TYPE::RED}},
-};
-
-
-Effects effects {};
-BulletSpawner bullets {};
-std::vector <Cloud> clouds {};
-Zeppelin zeppelin {};
-
-AiController aiController {};
-
-
-GameState&
-gameState()
-{
-  static GameState state {};
-  return state;
-}
 
 NetworkState&
 networkState()
@@ -122,10 +117,103 @@ static bool focusChanged {false};
 #endif
 
 
+static void
+handleSimEvent(
+  const SimEvent& event )
+{
+//  Pilot falling sounds loop on a channel reserved per plane
+  const int loopChannel = event.plane;
+
+  switch (event.type)
+  {
+    case SIM_EVENT::SHOT_FIRED:
+      return panSound( playSound(sounds.shoot), event.x );
+
+    case SIM_EVENT::PLANE_HIT:
+      return panSound( playSound(sounds.hitPlane), event.x );
+
+    case SIM_EVENT::PLANE_EXPLODED:
+      return panSound( playSound(sounds.explosion), event.x );
+
+    case SIM_EVENT::BULLET_IMPACT:
+      return panSound( playSound(sounds.hitGround), event.x );
+
+    case SIM_EVENT::PILOT_BAILED:
+    {
+      stopSound(loopChannel);
+      return;
+    }
+
+    case SIM_EVENT::PILOT_FALLING:
+    case SIM_EVENT::PILOT_CHUTE_FALLING:
+    {
+      const auto soundToPlay =
+        event.type == SIM_EVENT::PILOT_CHUTE_FALLING
+        ? sounds.pilotChuteLoop
+        : sounds.pilotFallLoop;
+
+      loopSound(soundToPlay, loopChannel);
+      panSound(loopChannel, event.x);
+
+      return;
+    }
+
+    case SIM_EVENT::PILOT_FALL_ENDED:
+    {
+      Mix_FadeOutChannel(
+        loopChannel,
+        constants::audioFadeDuration );
+
+      return;
+    }
+
+    case SIM_EVENT::PILOT_CHUTE_HIT:
+      return panSound( playSound(sounds.hitChute), event.x );
+
+    case SIM_EVENT::PILOT_DIED:
+      return panSound( playSound(sounds.pilotDeath), event.x );
+
+    case SIM_EVENT::PILOT_RESCUED:
+      return panSound( playSound(sounds.pilotRescue), event.x );
+
+    case SIM_EVENT::ROUND_WON:
+    {
+      playSound(resourceCache().sound(sounds.victory));
+      menu.setMessage(event.message);
+
+      return;
+    }
+
+    case SIM_EVENT::ROUND_LOST:
+    {
+      playSound(resourceCache().sound(sounds.defeat));
+      menu.setMessage(event.message);
+
+      return;
+    }
+
+    case SIM_EVENT::TOTAL_STATS_UPDATED:
+    {
+      if ( gameState().output.stats == true )
+        stats_write();
+
+      return;
+    }
+
+    case SIM_EVENT::NETWORK_EVENT:
+      return eventPush(event.netEvent);
+
+    default:
+      return;
+  }
+}
+
+
 static double tickInterval {};
 
 static TimeUtils::Duration timePrevious {};
 static TimeUtils::Duration tickPrevious {};
+static TimeUtils::Duration framePrevious {};
 
 int
 main(
@@ -140,6 +228,8 @@ main(
 #endif
   logVersionAndReadSettings();
 
+  PROFILE_THREAD_NAME("main");
+
 
   if ( SDL_init(game.isVSyncEnabled, game.isAudioEnabled) != 0 )
   {
@@ -148,11 +238,7 @@ main(
     return 1;
   }
 
-  for ( auto& [planeType, plane] : planes )
-  {
-    plane.input.setPlane(&plane);
-    plane.pilot.setPlane(&plane);
-  }
+  setSimEventHandler(handleSimEvent);
 
 
 #if !defined(__EMSCRIPTEN__)
@@ -163,18 +249,36 @@ main(
     ProtocolId, ConnectionTimeout );
 
   network.flowControl = new net::FlowControl();
+  flowControlInit(*network.flowControl);
   network.matchmaker = new MatchMaker();
+
+#if !defined(VITA_PLATFORM)
+//  BIPLANES_NET_CONDITIONS=<config file> fakes a bad network
+  const auto netConditions = std::getenv("BIPLANES_NET_CONDITIONS");
+
+  if (  netConditions != nullptr &&
+        std::strcmp(netConditions, "") != 0 )
+  {
+    static net::LinkConditioner linkConditioner {};
+
+    if ( linkConditioner.LoadConfig(netConditions) == true )
+    {
+      network.connection->socket.SetConditioner(&linkConditioner);
+      log_message( "NETWORK: Conditioning outgoing traffic with ", netConditions, "\n" );
+    }
+  }
+#endif
 #endif
 
 
-  textures_load();
-  sounds_load();
+  resources_load_begin();
 
 
   tickInterval = 1.0 / constants::tickRate;
 
   timePrevious = TimeUtils::Now();
   tickPrevious = timePrevious + tickInterval;
+  framePrevious = timePrevious;
 
   log_message( "\nLOG: Reached main menu loop!\n\n" );
 
@@ -212,6 +316,8 @@ game_main_loop()
   TimeUtils::SleepUntil(tickPrevious + tickInterval);
 #endif
 
+  PROFILE_ZONE("game_main_loop");
+
   const auto currentTime = TimeUtils::Now();
 
   deltaTime = static_cast <double> (currentTime - timePrevious);
@@ -225,36 +331,48 @@ game_main_loop()
   const auto connection = network.connection;
 
   if ( connection->IsRunning() == true )
+  {
+    PROFILE_ZONE("ReliableConnection::Update");
     connection->Update(deltaTime);
+  }
 
   network.matchmaker->Update();
 #endif
 
 
-  while ( SDL_PollEvent(&windowEvent) != 0 )
   {
-    if ( windowEvent.type == SDL_QUIT )
+    PROFILE_ZONE("SDL_PollEvent");
+
+    while ( SDL_PollEvent(&windowEvent) != 0 )
     {
-      game.isExiting = true;
+      if ( windowEvent.type == SDL_QUIT )
+      {
+        game.isExiting = true;
 
 #if defined(__EMSCRIPTEN__)
-      game_shutdown();
+        game_shutdown();
 #endif
 
-      return;
-    }
+        return;
+      }
 
-    queryWindowSize();
-    readKeyboardInput();
+      queryWindowSize();
+      readKeyboardInput();
 
 #ifdef VITA_PLATFORM
-    readGamepadInput();
+      readGamepadInput();
 #endif
 
-    menu.UpdateControls();
+      menu.UpdateControls();
+    }
   }
 
 
+//  Intro screens show up while assets are still loading
+  resources_load_update();
+  resourceCache().Update();
+
+
   uint32_t ticks = 0;
 
   for ( ; currentTime >= tickPrevious + tickInterval;
@@ -282,14 +400,25 @@ game_main_loop()
   if ( ticks == 0 )
     return;
 
+  const auto frameTime = static_cast <double> (currentTime - framePrevious);
+  framePrevious = currentTime;
+
 
   if ( gameState().isRoundRunning == true )
   {
+    const auto tickBegin = TimeUtils::Now();
+
     if ( game.gameMode == GAME_MODE::HUMAN_VS_HUMAN )
       game_loop_mp();
     else
       game_loop_sp();
 
+    if ( game.debug.perfHud == true )
+      perf_hud_record(
+        frameTime,
+        static_cast <double> (TimeUtils::Now() - tickBegin),
+        ticks );
+
 //    this prevents sticky keys when next event poll returns nothing
     readKeyboardInput();
 
@@ -330,6 +459,15 @@ game_shutdown()
   if ( gameState().output.stats == true )
     stats_write();
 
+#if defined(BIPLANES_PROFILER_ENABLED)
+  const auto tracePath = get_trace_path();
+
+  if ( profiler_write_trace(tracePath) == true )
+    log_message( "EXIT: Profiler trace written to '", tracePath, "'\n" );
+  else
+    log_message( "EXIT: Failed to write profiler trace to '", tracePath, "'\n" );
+#endif
+
   stopSound(-1);
   sounds_unload();
   textures_unload();
@@ -340,35 +478,19 @@ game_shutdown()
 void
 game_reset()
 {
-  if ( clouds.empty() == true )
-  {
-    clouds.resize(8);
-
-    for ( uint8_t i = 0; i < clouds.size(); i++ )
-      clouds[i] = {static_cast <bool> (i % 2), i};
-  }
-
   eventsReset();
+  rollbackReset();
+  sim_reset();
 
-  for ( auto& [planeType, plane] : planes )
-  {
-    plane.Respawn();
-    plane.ResetScore();
-    plane.ResetStats();
-  }
-
-  for ( auto& [planeType, plane] : planes )
-    plane.ResetSpawnProtection();
-
-  zeppelin.Respawn();
-  bullets.Clear();
-
-  for ( auto& cloud : clouds )
-    cloud.Respawn();
-
-  effects.Clear();
+#if !defined(__EMSCRIPTEN__)
+  remotePlaneSmoothing.Reset();
+#endif
 
   Mix_HaltChannel(-1);
+
+//  Round end jingles are needed only later on
+  resourceCache().Prefetch(sounds.victory);
+  resourceCache().Prefetch(sounds.defeat);
 }
 
 bool
@@ -383,8 +505,8 @@ game_init_sp()
   network.isOpponentConnected = true;
   game_reset();
 
-  aiController = {};
-  aiController.init();
+  world().aiController = {};
+  world().aiController.init();
 
   log_message( "\nLOG: Singleplayer game initialized successfully!\n\n" );
 
@@ -457,8 +579,8 @@ game_init_mp()
 
   if ( gameState().debug.ai == true )
   {
-    aiController = {};
-    aiController.init();
+    world().aiController = {};
+    world().aiController.init();
   }
 
   log_message( "\nLOG: Multiplayer game initialized successfully!\n\n" );
@@ -473,6 +595,8 @@ game_init_mp()
 void
 game_loop_sp()
 {
+  PROFILE_ZONE("game_loop_sp");
+
   auto& game = gameState();
 
   if ( game.isPaused == true )
@@ -487,8 +611,8 @@ game_loop_sp()
   }
 
 
-  auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-  auto& planeRed = planes.at(PLANE_TYPE::RED);
+  auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+  auto& planeRed = world().planes.at(PLANE_TYPE::RED);
 
   switch (game.gameMode)
   {
@@ -524,18 +648,7 @@ game_loop_sp()
       break;
   }
 
-  aiController.update();
-
-
-  for ( auto& cloud : clouds )
-    cloud.Update();
-
-  for ( auto& [planeType, plane] : planes )
-    plane.Update();
-
-  zeppelin.Update();
-  bullets.Update();
-  effects.Update();
+  sim_tick();
 }
 
 void
@@ -543,6 +656,8 @@ game_loop_mp()
 {
 #if !defined(__EMSCRIPTEN__)
 
+  PROFILE_ZONE("game_loop_mp");
+
   auto& game = gameState();
   auto& network = networkState();
   const auto connection = network.connection;
@@ -569,7 +684,7 @@ game_loop_mp()
   if ( connection->IsConnected() == true )
   {
     network.flowControl->Update(
-      connection->GetReliabilitySystem().GetRoundTripTime() * 1000.0f,
+      connection->GetReliabilitySystem(),
       deltaTime );
 
     if ( network.connectionChanged == true )
@@ -618,25 +733,17 @@ game_loop_mp()
   }
 
 
-  network.sendCoordsTimer.Update();
-
-
 //  GET PACKET
   static Packet opponentData {};
-  uint8_t packet[sizeof(Packet)] {};
 
-  while ( connection->ReceivePacket( packet, sizeof(packet) ) > 0 )
+  while ( receivePacket(opponentData) == true )
   {
     if (  network.connectionChanged == false &&
           network.isOpponentConnected == false )
       network.connectionChanged = true;
 
-    const auto opponentDataPrev = opponentData;
-
-    memcpy( &opponentData, &packet, sizeof(opponentData) );
-
     if ( opponentData.disconnect == false )
-      processOpponentData(opponentData, opponentDataPrev);
+      processOpponentData(opponentData);
   }
 
 
@@ -646,9 +753,6 @@ game_loop_mp()
     opponentData = {};
   }
 
-  for ( auto& cloud : clouds )
-    cloud.Update();
-
 
 //  INPUT
   Controls controlsLocal {};
@@ -656,44 +760,28 @@ game_loop_mp()
   if ( game.isPaused == false )
     controlsLocal = getLocalControls();
 
-  auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-  auto& planeRed = planes.at(PLANE_TYPE::RED);
 
-  auto& localPlane =
-    planeBlue.isLocal() == true
-    ? planeBlue
-    : planeRed;
+//  SIMULATE
+  const bool isAheadOfOpponent =
+    network.isOpponentConnected == true &&
+    rollbackShouldStall(
+      connection->GetReliabilitySystem().GetRoundTripTime() );
 
-  auto& remotePlane =
-    planeBlue.isLocal() == false
-    ? planeBlue
-    : planeRed;
+  if ( isAheadOfOpponent == false )
+    rollbackAdvance(controlsLocal, network.isOpponentConnected);
 
-  processPlaneControls(localPlane, controlsLocal);
-  localPlane.Update();
+  const auto& planeRemote =
+    world().planes.at(PLANE_TYPE::BLUE).isLocal() == false
+    ? world().planes.at(PLANE_TYPE::BLUE)
+    : world().planes.at(PLANE_TYPE::RED);
 
-  if ( network.isOpponentConnected == true )
-  {
-    const Controls opponentControls
-    {
-      opponentData.pitch,
-      opponentData.throttle,
-    };
-
-    processPlaneControls(remotePlane, opponentControls);
-    remotePlane.Update();
-  }
-
-  if ( gameState().debug.ai == true )
-    aiController.update();
-
-  zeppelin.Update();
-  bullets.Update();
-  effects.Update();
+  remotePlaneSmoothing.Update(
+    planeRemote, rollbackFrame(),
+    static_cast <double> (timePrevious) );
 
 
 //  SEND PACKET
-  const Duration packetSendInterval = 1.0 / constants::packetSendRate;
+  const Duration packetSendInterval = 1.0 / network.flowControl->GetSendRate();
 
   if ( packetSendTime >= packetSendInterval )
   {
@@ -701,23 +789,29 @@ game_loop_mp()
       packetSendTime -= packetSendInterval;
 
     Packet localData {};
+    localData.waiting = network.isOpponentConnected == false;
 
-    localData << controlsLocal;
-    localData << localPlane.getNetworkData();
+    rollbackPackInputs(localData);
 
-    eventsPack(localData);
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
+    const auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+    const auto& planeRed = world().planes.at(PLANE_TYPE::RED);
 
-    memcpy( packet, &localData, sizeof(packet) );
+    const auto& localPlane =
+      planeBlue.isLocal() == true
+      ? planeBlue
+      : planeRed;
 
-    connection->SendPacket( packet, sizeof(packet) );
-    eventsNewTick();
-  }
+    if ( network.flowControl->ShouldSendState() == true )
+      localData << localPlane.getNetworkData();
+#endif
 
-  packetSendTime += deltaTime;
+    eventsPack(localData);
 
+    sendPacket(localData);
+  }
 
-  if ( network.sendCoordsTimer.isReady() == true )
-    network.sendCoordsTimer.Start();
+  packetSendTime += deltaTime;
 
 #endif
 }
@@ -727,14 +821,16 @@ game_loop_mp()
 void
 draw_game()
 {
+  PROFILE_ZONE("draw_game");
+
   draw_background();
 
-  zeppelin.Draw();
-  bullets.Draw();
+  world().zeppelin.Draw();
+  world().bullets.Draw();
 
 
-  const auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-  const auto& planeRed = planes.at(PLANE_TYPE::RED);
+  const auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+  const auto& planeRed = world().planes.at(PLANE_TYPE::RED);
 
   const auto& playerPlane =
     planeBlue.isLocal() == true && planeBlue.isBot() == false
@@ -749,8 +845,16 @@ draw_game()
 
   if ( networkState().isOpponentConnected == true )
   {
+#if !defined(__EMSCRIPTEN__)
+    const auto opponentDrawn = remotePlaneSmoothing.Apply(
+      opponentPlane, static_cast <double> (timePrevious) );
+
+    opponentDrawn.Draw();
+    opponentDrawn.pilot.Draw();
+#else
     opponentPlane.Draw();
     opponentPlane.pilot.Draw();
+#endif
   }
 
   playerPlane.Draw();
@@ -759,9 +863,9 @@ draw_game()
 
   draw_barn();
 
-  effects.Draw();
+  world().effects.Draw();
 
-  for ( auto& cloud : clouds )
+  for ( auto& cloud : world().clouds )
   {
     cloud.setOpaque();
 
@@ -792,10 +896,13 @@ draw_game()
     opponentPlane.DrawCollisionLayer();
     opponentPlane.pilot.DrawCollisionLayer();
 
-    for ( auto& cloud : clouds )
+    for ( auto& cloud : world().clouds )
       cloud.DrawCollisionLayer();
   }
 
   if ( gameState().debug.ai == true )
-    aiController.drawDebugLayer();
+    world().aiController.drawDebugLayer();
+
+  if ( gameState().debug.perfHud == true )
+    draw_perf_hud();
 }
@@ -19,261 +19,302 @@
 */
 
 #include <include/bullet.hpp>
-#include <include/sdl.hpp>
 #include <include/time.hpp>
 #include <include/constants.hpp>
 #include <include/game_state.hpp>
-#include <include/network.hpp>
+#include <include/simulation.hpp>
 #include <include/plane.hpp>
+#include <include/world.hpp>
 #include <include/effects.hpp>
-#include <include/sounds.hpp>
-#include <include/textures.hpp>
+#include <include/math.hpp>
+#include <include/profiler.hpp>
 
 #include <cmath>
 #include <algorithm>
 
 
-Bullet::Bullet(
-  const float planeX,
-  const float planeY,
-  const float planeDir,
-  const PLANE_TYPE firedBy )
-  : mX{planeX}
-  , mY{planeY}
-  , mDir{planeDir}
-  , mFiredBy{firedBy}
+float
+Bullet::x() const
+{
+  return mX;
+}
+
+float
+Bullet::y() const
+{
+  return mY;
+}
+
+float
+Bullet::dir() const
+{
+  return mDir;
+}
+
+PLANE_TYPE
+Bullet::firedBy() const
 {
+  return mFiredBy;
 }
 
+
 void
-Bullet::Update()
+BulletSpawner::SpawnBullet(
+  const float x,
+  const float y,
+  const float dir,
+  const PLANE_TYPE firedBy )
 {
-  namespace barn = constants::barn;
   namespace bullet = constants::bullet;
 
 
-  if ( mIsDead == true )
+  Bullet instance {};
+  instance.mX = x;
+  instance.mY = y;
+  instance.mDir = dir;
+  instance.mFiredBy = firedBy;
+
+  const auto direction = direction_vector(dir);
+
+  instance.mSpeedX = bullet::speed * direction.x;
+  instance.mSpeedY = bullet::speed * direction.y;
+
+  Insert(instance);
+}
+
+void
+BulletSpawner::Insert(
+  const Bullet& instance )
+{
+//  Pool is sized way above anything regular play
+//  produces, so running out only drops new bullets
+  if ( mCount >= capacity )
     return;
 
 
-  mX += bullet::speed * std::sin( mDir * M_PI / 180.0f ) * deltaTime;
-  mY -= bullet::speed * std::cos( mDir * M_PI / 180.0f ) * deltaTime;
+  mX[mCount] = instance.mX;
+  mY[mCount] = instance.mY;
+  mDir[mCount] = instance.mDir;
+  mSpeedX[mCount] = instance.mSpeedX;
+  mSpeedY[mCount] = instance.mSpeedY;
+  mFiredBy[mCount] = instance.mFiredBy;
 
+  ++mCount;
 
-  const bool collidesWithScreenBorder
-  {
-    mX > 1.0f ||
-    mX < 0.0f ||
-    mY < 0.0f
-  };
+  mHighWaterMark = std::max(mHighWaterMark, mCount);
+}
 
-  if ( collidesWithScreenBorder == true )
+void
+BulletSpawner::Remove(
+  const size_t index )
+{
+  const auto last = --mCount;
+
+  mX[index] = mX[last];
+  mY[index] = mY[last];
+  mDir[index] = mDir[last];
+  mSpeedX[index] = mSpeedX[last];
+  mSpeedY[index] = mSpeedY[last];
+  mFiredBy[index] = mFiredBy[last];
+}
+
+void
+BulletSpawner::Update()
+{
+  PROFILE_ZONE("BulletSpawner::Update");
+
+  const auto dt = deltaTime;
+
+//  No branches here, so this loop can be vectorized
+  for ( size_t i = 0; i < mCount; ++i )
   {
-    mX = std::clamp(mX, 0.0f, 1.0f);
+    mX[i] += mSpeedX[i] * dt;
+    mY[i] += mSpeedY[i] * dt;
+  }
 
-    mY = std::max(mY, 0.0f);
 
-    return Destroy();
+  size_t i {};
+
+  while ( i < mCount )
+  {
+    if ( CollisionsUpdate(i) == true )
+    {
+      Remove(i);
+      continue;
+    }
+
+    ++i;
   }
+}
+
+bool
+BulletSpawner::CollisionsUpdate(
+  const size_t index )
+{
+  namespace barn = constants::barn;
+  namespace bullet = constants::bullet;
+
+
+  const auto x = mX[index];
+  const auto y = mY[index];
+  const auto firedBy = mFiredBy[index];
+
+
+  const bool collidesWithScreenBorder
+  {
+    x > 1.0f ||
+    x < 0.0f ||
+    y < 0.0f
+  };
+
+  if ( collidesWithScreenBorder == true )
+    return true;
 
 
   const bool collidesWithSurface
   {
-    ( mX > barn::bulletCollisionX &&
-      mX < barn::bulletCollisionX + barn::bulletCollisionSizeX &&
-      mY > barn::bulletCollisionY ) ||
-      mY > bullet::groundCollision
+    ( x > barn::bulletCollisionX &&
+      x < barn::bulletCollisionX + barn::bulletCollisionSizeX &&
+      y > barn::bulletCollisionY ) ||
+      y > bullet::groundCollision
   };
 
   if ( collidesWithSurface == true )
   {
-    panSound( playSound(sounds.hitGround), mX );
+    simEventPush({SIM_EVENT::BULLET_IMPACT, firedBy, x});
 
-    effects.Spawn(new BulletImpact{mX, mY});
+    world().effects.SpawnBulletImpact(x, y);
 
-    return Destroy();
+    return true;
   }
 
   const auto& game = gameState();
 
+//  Hits on a plane are decided by its owner,
+//  and never from a re-simulated past
   if (  game.gameMode == GAME_MODE::HUMAN_VS_HUMAN &&
-        planes.at(mFiredBy).isLocal() == true )
-    return;
+        ( world().planes.at(firedBy).isLocal() == true ||
+          world().isResimulating == true ) )
+    return false;
 
 
-  Plane* planeShooter = &planes.at(PLANE_TYPE::BLUE);
-  Plane* planeTarget = &planes.at(PLANE_TYPE::RED);
+  Plane* planeShooter = &world().planes.at(PLANE_TYPE::BLUE);
+  Plane* planeTarget = &world().planes.at(PLANE_TYPE::RED);
 
-  if ( mFiredBy == PLANE_TYPE::RED )
+  if ( firedBy == PLANE_TYPE::RED )
     std::swap(planeShooter, planeTarget);
 
 
 //  HIT PLANE
-  if ( planeTarget->isHit(mX, mY) == true )
+  if ( planeTarget->isHit(x, y) == true )
   {
-    Destroy();
     planeTarget->Hit(*planeShooter);
 
-    return;
+    return true;
   }
 
 //  HIT CHUTE
-  if ( planeTarget->pilot.ChuteIsHit(mX, mY) == true )
+  if ( planeTarget->pilot.ChuteIsHit(x, y) == true )
   {
-    Destroy();
     planeTarget->pilot.ChuteHit(*planeShooter);
 
-    eventPush(EVENTS::HIT_CHUTE);
-    return;
+    simNetEventPush(EVENTS::HIT_CHUTE);
+    return true;
   }
 
 //  HIT PILOT
-  if ( planeTarget->pilot.isHit(mX, mY) == true )
+  if ( planeTarget->pilot.isHit(x, y) == true )
   {
-    Destroy();
     planeTarget->pilot.Kill(*planeShooter);
 
-    eventPush(EVENTS::HIT_PILOT);
-    return;
+    simNetEventPush(EVENTS::HIT_PILOT);
+    return true;
   }
-}
-
-void
-Bullet::Draw() const
-{
-  namespace bullet = constants::bullet;
 
-
-  if ( mIsDead == true )
-    return;
-
-
-  const SDL_FRect bulletRect
-  {
-    toWindowSpaceX(mX - 0.5f * bullet::sizeX),
-    toWindowSpaceY(mY - 0.5f * bullet::sizeY),
-    scaleToScreenX(bullet::sizeX),
-    scaleToScreenY(bullet::sizeY),
-  };
-
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.bullet,
-    nullptr,
-    &bulletRect );
+  return false;
 }
 
 void
-Bullet::Destroy()
-{
-  mIsDead = true;
-}
-
-bool
-Bullet::isDead() const
-{
-  return mIsDead;
-}
-
-float
-Bullet::x() const
+BulletSpawner::Clear()
 {
-  return mX;
+  mCount = 0;
+  mHighWaterMark = 0;
 }
 
-float
-Bullet::y() const
+size_t
+BulletSpawner::count() const
 {
-  return mY;
+  return mCount;
 }
 
-float
-Bullet::dir() const
+size_t
+BulletSpawner::highWaterMark() const
 {
-  return mDir;
+  return mHighWaterMark;
 }
 
-PLANE_TYPE
-Bullet::firedBy() const
+Bullet
+BulletSpawner::at(
+  const size_t index ) const
 {
-  return mFiredBy;
+  Bullet instance {};
+  instance.mX = mX[index];
+  instance.mY = mY[index];
+  instance.mDir = mDir[index];
+  instance.mSpeedX = mSpeedX[index];
+  instance.mSpeedY = mSpeedY[index];
+  instance.mFiredBy = mFiredBy[index];
+
+  return instance;
 }
 
-
 void
-BulletSpawner::SpawnBullet(
+BulletSpawner::GetClosestBullets(
   const float x,
   const float y,
-  const float dir,
-  const PLANE_TYPE firedBy )
+  const PLANE_TYPE target,
+  const size_t maxCount,
+  BulletSelection& result ) const
 {
-  mInstances.push_back(
-  {
-    x, y,
-    dir,
-    firedBy,
-  });
-}
+  result.mPool = this;
+  result.mCount = 0;
 
-void
-BulletSpawner::Update()
-{
-  size_t i {};
-
-  while ( i < mInstances.size() )
+  for ( size_t i = 0; i < mCount; ++i )
   {
-    mInstances[i].Update();
-
-    if ( mInstances[i].isDead() == true )
-    {
-      mInstances.erase(mInstances.begin() + i);
+    if ( mFiredBy[i] == target )
       continue;
-    }
 
-    ++i;
-  }
-}
+    const auto dx = mX[i] - x;
+    const auto dy = mY[i] - y;
 
-void
-BulletSpawner::Clear()
-{
-  mInstances.clear();
-}
+    result.mDistances[i] = dx * dx + dy * dy;
+    result.mIndices[result.mCount++] = i;
+  }
 
-void
-BulletSpawner::Draw() const
-{
-  for ( auto& bullet : mInstances )
-    bullet.Draw();
-}
 
-std::vector <Bullet>
-BulletSpawner::GetClosestBullets(
-  const float x,
-  const float y,
-  const PLANE_TYPE target ) const
-{
-  std::vector <Bullet> result {};
+  const auto first = result.mIndices;
+  const auto last = first + result.mCount;
+  const auto middle = first + std::min(result.mCount, maxCount);
 
-  for ( const auto& bullet : mInstances )
+  std::partial_sort(first, middle, last,
+  [&result] ( const uint16_t lhs, const uint16_t rhs )
   {
-    if ( bullet.firedBy() != target )
-      result.push_back(bullet);
-  }
+    return result.mDistances[lhs] < result.mDistances[rhs];
+  });
 
-  std::sort(result.begin(), result.end(),
-  [x, y] ( const Bullet& lhs, const Bullet& rhs )
-  {
-    const float distanceToLhs = sqrt(
-      pow( lhs.x() - x, 2 ) +
-      pow( lhs.y() - y, 2 ) );
+  result.mCount = middle - first;
+}
 
-    const float distanceToRhs = sqrt(
-      pow( rhs.x() - x, 2 ) +
-      pow( rhs.y() - y, 2 ) );
 
-    return distanceToLhs < distanceToRhs;
-  });
+size_t
+BulletSelection::size() const
+{
+  return mCount;
+}
 
-  return result;
+Bullet
+BulletSelection::operator [] (
+  const size_t index ) const
+{
+  return mPool->at(mIndices[index]);
 }
@@ -0,0 +1,49 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/bullet.hpp>
+#include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
+#include <include/constants.hpp>
+#include <include/textures.hpp>
+
+
+void
+BulletSpawner::Draw() const
+{
+  namespace bullet = constants::bullet;
+
+
+  for ( size_t i = 0; i < mCount; ++i )
+  {
+    const SDL_FRect bulletRect
+    {
+      toWindowSpaceX(mX[i] - 0.5f * bullet::sizeX),
+      toWindowSpaceY(mY[i] - 0.5f * bullet::sizeY),
+      scaleToScreenX(bullet::sizeX),
+      scaleToScreenY(bullet::sizeY),
+    };
+
+    sprite_batch_draw(
+      textures.bullet,
+      &textures.bullet_rect,
+      bulletRect );
+  }
+}
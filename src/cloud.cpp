@@ -19,11 +19,11 @@
 */
 
 #include <include/cloud.hpp>
-#include <include/sdl.hpp>
+#include <include/sdl_rect.hpp>
 #include <include/time.hpp>
 #include <include/constants.hpp>
-#include <include/game_state.hpp>
-#include <include/textures.hpp>
+#include <include/world.hpp>
+#include <include/profiler.hpp>
 
 
 Cloud::Cloud(
@@ -39,6 +39,8 @@ Cloud::Cloud(
 void
 Cloud::Update()
 {
+  PROFILE_ZONE("Cloud::Update");
+
   UpdateCoordinates();
   UpdateCollisionBox();
 }
@@ -53,7 +55,9 @@ Cloud::UpdateCoordinates()
     ? 1.0f
     : -1.0f;
 
-  mX += ( cloud::minSpeed + mId * cloud::speedRange / clouds.size() )
+  const auto cloudCount = world().clouds.size();
+
+  mX += ( cloud::minSpeed + mId * cloud::speedRange / cloudCount )
         * moveDir * deltaTime;
 
   if ( mDir == true )
@@ -84,15 +88,17 @@ Cloud::UpdateHeight()
     mDir == true
     ? 1.0f : -1.0f;
 
+  const auto cloudCount = world().clouds.size();
+
 
   mY += dir * 0.5f * cloud::sizeX;
 
 
   if ( mY > cloud::minHeight )
-    mY = cloud::maxHeight + dir * mId * cloud::heightRange / clouds.size();
+    mY = cloud::maxHeight + dir * mId * cloud::heightRange / cloudCount;
 
   if ( mY < cloud::maxHeight )
-    mY = cloud::minHeight + dir * mId * cloud::heightRange / clouds.size();
+    mY = cloud::minHeight + dir * mId * cloud::heightRange / cloudCount;
 }
 
 void
@@ -119,60 +125,6 @@ Cloud::isHit(
   return SDL_PointInFRect(&point, &mCollisionBox);
 }
 
-void
-Cloud::Draw()
-{
-  namespace cloud = constants::cloud;
-
-
-  const auto& features = gameState().features;
-
-  if ( features.extraClouds == false && mId >= 2 )
-    return;
-
-
-  auto* const cloudTexture =
-    mIsOpaque == true
-    ? textures.cloud_opaque
-    : textures.cloud;
-
-  const SDL_FRect cloudRect
-  {
-    toWindowSpaceX(mX - 0.5f * cloud::sizeX),
-    toWindowSpaceY(mY - 0.5f * cloud::sizeY),
-    scaleToScreenX(cloud::sizeX),
-    scaleToScreenY(cloud::sizeY),
-  };
-
-  SDL_RenderCopyF(
-    gRenderer,
-    cloudTexture,
-    nullptr,
-    &cloudRect );
-}
-
-void
-Cloud::DrawCollisionLayer()
-{
-  const auto& features = gameState().features;
-
-  if ( features.extraClouds == false && mId >= 2 )
-    return;
-
-
-  const SDL_FRect cloudHitbox
-  {
-    toWindowSpaceX(mCollisionBox.x),
-    toWindowSpaceY(mCollisionBox.y),
-    scaleToScreenX(mCollisionBox.w),
-    scaleToScreenY(mCollisionBox.h),
-  };
-
-  namespace colors = constants::colors::debug::collisions;
-  setRenderColor(colors::cloudToPlane);
-  SDL_RenderDrawRectF( gRenderer, &cloudHitbox );
-}
-
 void
 Cloud::setTransparent()
 {
@@ -190,17 +142,19 @@ Cloud::Respawn()
 {
   namespace cloud = constants::cloud;
 
+  const auto cloudCount = world().clouds.size();
+
 
   if ( mDir == true )
-    mX = cloud::spawnRightX + (clouds.size() - mId) * cloud::sizeY;
+    mX = cloud::spawnRightX + (cloudCount - mId) * cloud::sizeY;
   else
-    mX = cloud::spawnLeftX + (clouds.size() - mId) * cloud::sizeY;
+    mX = cloud::spawnLeftX + (cloudCount - mId) * cloud::sizeY;
 
 
   if ( mId % 2 )
-    mY = cloud::maxHeight + (clouds.size() + mId) / (float) clouds.size() * cloud::sizeY;
+    mY = cloud::maxHeight + (cloudCount + mId) / (float) cloudCount * cloud::sizeY;
   else
-    mY = cloud::minHeight - (clouds.size() + mId) / (float) clouds.size() * cloud::sizeY;
+    mY = cloud::minHeight - (cloudCount + mId) / (float) cloudCount * cloud::sizeY;
 
 
   mIsOpaque = true;
@@ -0,0 +1,85 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/cloud.hpp>
+#include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
+#include <include/constants.hpp>
+#include <include/game_state.hpp>
+#include <include/textures.hpp>
+
+
+void
+Cloud::Draw()
+{
+  namespace cloud = constants::cloud;
+
+
+  const auto& features = gameState().features;
+
+  if ( features.extraClouds == false && mId >= 2 )
+    return;
+
+
+  auto* const cloudTexture =
+    mIsOpaque == true
+    ? textures.cloud_opaque
+    : textures.cloud;
+
+  const auto& cloudTextureRect =
+    mIsOpaque == true
+    ? textures.cloud_opaque_rect
+    : textures.cloud_rect;
+
+  const SDL_FRect cloudRect
+  {
+    toWindowSpaceX(mX - 0.5f * cloud::sizeX),
+    toWindowSpaceY(mY - 0.5f * cloud::sizeY),
+    scaleToScreenX(cloud::sizeX),
+    scaleToScreenY(cloud::sizeY),
+  };
+
+  sprite_batch_draw(
+    cloudTexture,
+    &cloudTextureRect,
+    cloudRect );
+}
+
+void
+Cloud::DrawCollisionLayer()
+{
+  const auto& features = gameState().features;
+
+  if ( features.extraClouds == false && mId >= 2 )
+    return;
+
+
+  const SDL_FRect cloudHitbox
+  {
+    toWindowSpaceX(mCollisionBox.x),
+    toWindowSpaceY(mCollisionBox.y),
+    scaleToScreenX(mCollisionBox.w),
+    scaleToScreenY(mCollisionBox.h),
+  };
+
+  namespace colors = constants::colors::debug::collisions;
+  setRenderColor(colors::cloudToPlane);
+  SDL_RenderDrawRectF( gRenderer, &cloudHitbox );
+}
@@ -19,10 +19,10 @@
 */
 
 #include <include/effects.hpp>
-#include <include/sdl.hpp>
 #include <include/time.hpp>
 #include <include/constants.hpp>
-#include <include/textures.hpp>
+#include <include/math.hpp>
+#include <include/profiler.hpp>
 
 #include <cmath>
 
@@ -56,127 +56,28 @@ Effect::Update()
   }
 }
 
-void
-Effect::Draw() const
-{
-  if ( hasFinished() == false )
-    DrawImpl();
-}
-
 bool
 Effect::hasFinished() const
 {
   return mFrame >= mFrameCount;
 }
 
-
-Effects::~Effects()
-{
-  Clear();
-}
-
-void
-Effects::Spawn(
-  Effect* effect )
-{
-  mEffects.push_back(effect);
-}
-
-void
-Effects::Clear()
-{
-  for ( const auto effect : mEffects )
-    delete effect;
-
-  mEffects.clear();
-}
-
-void
-Effects::Update()
-{
-  size_t i {};
-
-  while ( i < mEffects.size() )
-  {
-    const auto effect = mEffects[i];
-
-    effect->Update();
-
-    if ( effect->hasFinished() == true )
-    {
-      delete effect;
-      mEffects.erase(mEffects.begin() + i);
-
-      continue;
-    }
-
-    ++i;
-  }
-}
-
-void
-Effects::Draw() const
-{
-  for ( const auto effect : mEffects )
-    effect->Draw();
-}
-
-
-SmokePuff::SmokePuff(
-  const float x,
-  const float y )
-  : Effect {x, y, constants::smoke::frameTime, constants::smoke::frameCount}
-{
-}
-
-void
-SmokePuff::DrawImpl() const
+float
+Effect::x() const
 {
-  namespace smoke = constants::smoke;
-
-
-  const SDL_FRect smokeRect
-  {
-    toWindowSpaceX(mX - 0.5f * smoke::sizeX),
-    toWindowSpaceY(mY - 0.5f * smoke::sizeY),
-    scaleToScreenX(smoke::sizeX),
-    scaleToScreenY(smoke::sizeY),
-  };
-
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.anim_smk,
-    &textures.anim_smk_rect[mFrame],
-    &smokeRect );
+  return mX;
 }
 
-
-Explosion::Explosion(
-  const float x,
-  const float y )
-  : Effect {x, y, 0.075, 7}
+float
+Effect::y() const
 {
+  return mY;
 }
 
-void
-Explosion::DrawImpl() const
+uint8_t
+Effect::frame() const
 {
-  namespace explosion = constants::explosion;
-
-
-  const SDL_FRect explosionRect
-  {
-    toWindowSpaceX(mX - 0.5f * explosion::sizeX),
-    toWindowSpaceY(mY - 0.5f * explosion::sizeY),
-    scaleToScreenX(explosion::sizeX),
-    scaleToScreenY(explosion::sizeY),
-  };
-
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.anim_expl,
-    &textures.anim_expl_rect[mFrame],
-    &explosionRect );
+  return mFrame;
 }
 
 
@@ -187,8 +88,8 @@ ExplosionSpark::ExplosionSpark(
   const float dir )
   : Effect {x, y, 0.035, 5}
 {
-  mSpeedX = std::sin(dir) * speed;
-  mSpeedY = std::cos(dir) * -speed;
+  mSpeedX = sin_deg(dir) * speed;
+  mSpeedY = cos_deg(dir) * -speed;
 }
 
 void
@@ -244,52 +145,69 @@ ExplosionSpark::Update()
   mSpeedY = -spark::speedBounce;
 }
 
+
 void
-ExplosionSpark::DrawImpl() const
+Effects::SpawnSmokePuff(
+  const float x,
+  const float y )
 {
-  namespace spark = constants::explosion::spark;
-  namespace colors = constants::colors;
-
+  namespace smoke = constants::smoke;
 
-  const SDL_FRect sparkRect
-  {
-    toWindowSpaceX(mX - 0.5f * spark::sizeX),
-    toWindowSpaceY(mY - 0.5f * spark::sizeY),
-    scaleToScreenX(spark::sizeX),
-    scaleToScreenY(spark::sizeY),
-  };
-
-  setRenderColor(colors::explosionSpark[mFrame]);
-  SDL_RenderFillRectF(
-    gRenderer,
-    &sparkRect );
+  mSmokePuffs.Spawn({x, y, smoke::frameTime, smoke::frameCount});
 }
 
+void
+Effects::SpawnBulletImpact(
+  const float x,
+  const float y )
+{
+  mBulletImpacts.Spawn({x, y, 0.08, 6});
+}
 
-BulletImpact::BulletImpact(
+void
+Effects::SpawnExplosion(
   const float x,
   const float y )
-  : Effect {x, y, 0.08, 6}
 {
+  mExplosions.Spawn({x, y, 0.075, 7});
+}
+
+void
+Effects::SpawnExplosionSpark(
+  const float x,
+  const float y,
+  const float speed,
+  const float dir )
+{
+  mExplosionSparks.Spawn({x, y, speed, dir});
+}
+
+void
+Effects::Clear()
+{
+  mSmokePuffs.Clear();
+  mBulletImpacts.Clear();
+  mExplosions.Clear();
+  mExplosionSparks.Clear();
 }
 
 void
-BulletImpact::DrawImpl() const
+Effects::Update()
 {
-  namespace hit = constants::bullet::hit;
+  PROFILE_ZONE("Effects::Update");
 
+  mSmokePuffs.Update();
+  mBulletImpacts.Update();
+  mExplosions.Update();
+  mExplosionSparks.Update();
+}
 
-  const SDL_FRect impactRect
-  {
-    toWindowSpaceX(mX - 0.5f * hit::sizeX),
-    toWindowSpaceY(mY - 0.5f * hit::sizeY),
-    scaleToScreenX(hit::sizeX),
-    scaleToScreenY(hit::sizeY),
-  };
-
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.anim_hit,
-    &textures.anim_hit_rect[mFrame],
-    &impactRect );
+size_t
+Effects::count() const
+{
+  return
+    mSmokePuffs.count() +
+    mBulletImpacts.count() +
+    mExplosions.count() +
+    mExplosionSparks.count();
 }
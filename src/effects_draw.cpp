@@ -0,0 +1,159 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/effects.hpp>
+#include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
+#include <include/constants.hpp>
+#include <include/textures.hpp>
+
+#include <iterator>
+
+
+void
+Effects::Draw() const
+{
+  DrawSmokePuffs();
+  DrawBulletImpacts();
+  DrawExplosions();
+  DrawExplosionSparks();
+}
+
+void
+Effects::DrawSmokePuffs() const
+{
+  namespace smoke = constants::smoke;
+
+
+  const auto sizeX = scaleToScreenX(smoke::sizeX);
+  const auto sizeY = scaleToScreenY(smoke::sizeY);
+
+  for ( const auto& puff : mSmokePuffs )
+  {
+    const SDL_FRect smokeRect
+    {
+      toWindowSpaceX(puff.x() - 0.5f * smoke::sizeX),
+      toWindowSpaceY(puff.y() - 0.5f * smoke::sizeY),
+      sizeX,
+      sizeY,
+    };
+
+    sprite_batch_draw(
+      textures.anim_smk,
+      &textures.anim_smk_rect[puff.frame()],
+      smokeRect );
+  }
+}
+
+void
+Effects::DrawBulletImpacts() const
+{
+  namespace hit = constants::bullet::hit;
+
+
+  const auto sizeX = scaleToScreenX(hit::sizeX);
+  const auto sizeY = scaleToScreenY(hit::sizeY);
+
+  for ( const auto& impact : mBulletImpacts )
+  {
+    const SDL_FRect impactRect
+    {
+      toWindowSpaceX(impact.x() - 0.5f * hit::sizeX),
+      toWindowSpaceY(impact.y() - 0.5f * hit::sizeY),
+      sizeX,
+      sizeY,
+    };
+
+    sprite_batch_draw(
+      textures.anim_hit,
+      &textures.anim_hit_rect[impact.frame()],
+      impactRect );
+  }
+}
+
+void
+Effects::DrawExplosions() const
+{
+  namespace explosion = constants::explosion;
+
+
+  const auto sizeX = scaleToScreenX(explosion::sizeX);
+  const auto sizeY = scaleToScreenY(explosion::sizeY);
+
+  for ( const auto& instance : mExplosions )
+  {
+    const SDL_FRect explosionRect
+    {
+      toWindowSpaceX(instance.x() - 0.5f * explosion::sizeX),
+      toWindowSpaceY(instance.y() - 0.5f * explosion::sizeY),
+      sizeX,
+      sizeY,
+    };
+
+    sprite_batch_draw(
+      textures.anim_expl,
+      &textures.anim_expl_rect[instance.frame()],
+      explosionRect );
+  }
+}
+
+void
+Effects::DrawExplosionSparks() const
+{
+  namespace spark = constants::explosion::spark;
+  namespace colors = constants::colors;
+
+
+  const auto sizeX = scaleToScreenX(spark::sizeX);
+  const auto sizeY = scaleToScreenY(spark::sizeY);
+
+  SDL_FRect sparkRects[spark::maxCount];
+
+//  Sparks are plain rectangles colored by their frame,
+//  so each color is filled with a single draw call
+  for ( size_t frame {}; frame < std::size(colors::explosionSpark); ++frame )
+  {
+    int rectCount {};
+
+    for ( const auto& instance : mExplosionSparks )
+    {
+      if ( instance.frame() != frame )
+        continue;
+
+      sparkRects[rectCount++] =
+      {
+        toWindowSpaceX(instance.x() - 0.5f * spark::sizeX),
+        toWindowSpaceY(instance.y() - 0.5f * spark::sizeY),
+        sizeX,
+        sizeY,
+      };
+    }
+
+    if ( rectCount == 0 )
+      continue;
+
+
+    setRenderColor(colors::explosionSpark[frame]);
+    SDL_RenderFillRectsF(
+      gRenderer,
+      sparkRects,
+      rectCount );
+  }
+}
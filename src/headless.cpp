@@ -0,0 +1,527 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Headless bot-vs-bot match runner.
+//  Links only against biplanes_sim: no window, renderer or mixer.
+//  Matches run unthrottled on a pool of worker threads,
+//  each worker owning an isolated World.
+
+#include <include/simulation.hpp>
+#include <include/world.hpp>
+#include <include/constants.hpp>
+#include <include/game_state.hpp>
+#include <include/time.hpp>
+#include <include/plane.hpp>
+#include <include/ai_stuff.hpp>
+#include <include/stats.hpp>
+#include <include/profiler.hpp>
+
+#include <lib/picojson.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+static const char* const difficultyNames[]
+{
+  "easy",
+  "medium",
+  "hard",
+  "developer",
+  "insane",
+};
+
+
+struct HeadlessOptions
+{
+  uint32_t matches {1};
+  uint32_t maxTicks {constants::tickRate * 60 * 30};
+  uint32_t threads {};
+  uint32_t seed {1};
+  uint8_t winScore {constants::defaultWinScore};
+  std::vector <DIFFICULTY::DIFFICULTY> difficulties {};
+  std::string outputPath {};
+  std::string tracePath {};
+};
+
+
+struct BatchResults
+{
+  uint32_t matches {};
+  uint32_t unfinished {};
+  uint64_t ticks {};
+
+//  Seeds of the first and the last match in the batch
+  uint32_t seedFirst {};
+  uint32_t seedLast {};
+
+//  Most bullets alive at once in a single match
+  size_t bulletsPeak {};
+
+  std::map <PLANE_TYPE, uint32_t> wins {};
+
+//  Both planes combined
+  Statistics stats {};
+};
+
+
+static bool
+parseDifficulties(
+  const std::string& list,
+  std::vector <DIFFICULTY::DIFFICULTY>& difficulties )
+{
+  difficulties.clear();
+
+  if ( list == "all" )
+  {
+    for ( uint8_t i {}; i <= DIFFICULTY::INSANE; ++i )
+      difficulties.push_back(static_cast <DIFFICULTY::DIFFICULTY> (i));
+
+    return true;
+  }
+
+  size_t begin {};
+
+  while ( begin <= list.size() )
+  {
+    auto end = list.find(',', begin);
+
+    if ( end == std::string::npos )
+      end = list.size();
+
+    const auto name = list.substr(begin, end - begin);
+    bool found {};
+
+    for ( uint8_t i {}; i <= DIFFICULTY::INSANE; ++i )
+      if ( name == difficultyNames[i] )
+      {
+        difficulties.push_back(static_cast <DIFFICULTY::DIFFICULTY> (i));
+        found = true;
+        break;
+      }
+
+    if ( found == false )
+      return false;
+
+    begin = end + 1;
+  }
+
+  return difficulties.empty() == false;
+}
+
+static void
+printUsage(
+  const char* exeName )
+{
+  std::printf(
+    "Usage: %s [options]\n"
+    "  --matches N       matches to run per difficulty (default 1)\n"
+    "  --difficulty D    easy|medium|hard|developer|insane,\n"
+    "                    a comma-separated list of them or 'all'\n"
+    "  --win-score N     score needed to win a match (default %u)\n"
+    "  --max-ticks N     abort a match after N ticks\n"
+    "  --threads N       worker threads (default: all cores)\n"
+    "  --seed N          seed of the first match, each next one adds 1 (default 1)\n"
+    "  --output FILE     write aggregate statistics as JSON\n"
+#if defined(BIPLANES_PROFILER_ENABLED)
+    "  --trace FILE      write the profiler trace as Chrome trace JSON\n"
+#endif
+    , exeName, constants::defaultWinScore );
+}
+
+static bool
+parseOptions(
+  int argc,
+  char* args[],
+  HeadlessOptions& options )
+{
+  for ( int i = 1; i < argc; ++i )
+  {
+    const std::string arg = args[i];
+
+    if ( arg == "--help" || arg == "-h" )
+      return false;
+
+    if ( i + 1 >= argc )
+      return false;
+
+    const std::string value = args[++i];
+
+    if ( arg == "--matches" )
+      options.matches = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--max-ticks" )
+      options.maxTicks = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--win-score" )
+      options.winScore = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--threads" )
+      options.threads = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--seed" )
+      options.seed = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--output" )
+      options.outputPath = value;
+
+#if defined(BIPLANES_PROFILER_ENABLED)
+    else if ( arg == "--trace" )
+      options.tracePath = value;
+#endif
+
+    else if ( arg == "--difficulty" )
+    {
+      if ( parseDifficulties(value, options.difficulties) == false )
+        return false;
+    }
+    else
+      return false;
+  }
+
+  if ( options.difficulties.empty() == true )
+    options.difficulties.push_back(DIFFICULTY::EASY);
+
+  if ( options.threads == 0 )
+    options.threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  return options.winScore > 0;
+}
+
+
+static void
+accumulateStats(
+  Statistics& total,
+  const Statistics& stats )
+{
+  total.shots        += stats.shots;
+  total.plane_hits   += stats.plane_hits;
+  total.chute_hits   += stats.chute_hits;
+  total.pilot_hits   += stats.pilot_hits;
+  total.jumps        += stats.jumps;
+  total.crashes      += stats.crashes;
+  total.falls        += stats.falls;
+  total.rescues      += stats.rescues;
+  total.plane_kills  += stats.plane_kills;
+  total.plane_deaths += stats.plane_deaths;
+  total.pilot_deaths += stats.pilot_deaths;
+  total.wins         += stats.wins;
+  total.losses       += stats.losses;
+}
+
+static void
+accumulateResults(
+  BatchResults& total,
+  const BatchResults& results )
+{
+  if ( results.matches == 0 )
+    return;
+
+  total.seedFirst = total.matches == 0
+    ? results.seedFirst
+    : std::min(total.seedFirst, results.seedFirst);
+
+  total.seedLast = total.matches == 0
+    ? results.seedLast
+    : std::max(total.seedLast, results.seedLast);
+
+  total.matches += results.matches;
+  total.unfinished += results.unfinished;
+  total.ticks += results.ticks;
+  total.bulletsPeak = std::max(total.bulletsPeak, results.bulletsPeak);
+
+  for ( const auto& [planeType, wins] : results.wins )
+    total.wins[planeType] += wins;
+
+  accumulateStats(total.stats, results.stats);
+}
+
+
+static uint32_t
+runMatch(
+  const HeadlessOptions& options,
+  const uint32_t seed )
+{
+  auto& game = gameState();
+
+  game.isRoundFinished = false;
+  sim_reset();
+
+  world().aiController = {};
+  world().aiController.init();
+  world().aiController.setSeed(seed);
+
+  game.isRoundRunning = true;
+
+
+  uint32_t tick {};
+
+  for ( ; tick < options.maxTicks; ++tick )
+  {
+    sim_tick();
+
+    if ( game.isRoundFinished == true )
+      break;
+  }
+
+  game.isRoundRunning = false;
+
+  return tick;
+}
+
+static void
+runWorker(
+  const HeadlessOptions& options,
+  std::atomic <uint32_t>& nextJob,
+  std::map <DIFFICULTY::DIFFICULTY, BatchResults>& results )
+{
+  PROFILE_THREAD_NAME("headless worker");
+
+  World localWorld {};
+  bindWorld(&localWorld);
+
+  auto& game = gameState();
+
+  game.output.toFile = false;
+  game.output.stats = false;
+  game.gameMode = GAME_MODE::BOT_VS_BOT;
+  game.winScore = options.winScore;
+
+  for ( auto& [planeType, plane] : localWorld.planes )
+  {
+    plane.setLocal(true);
+    plane.setBot(true);
+  }
+
+  deltaTime = 1.0 / constants::tickRate;
+
+
+  const uint32_t jobCount =
+    options.matches * options.difficulties.size();
+
+  for ( auto job = nextJob++; job < jobCount; job = nextJob++ )
+  {
+    const auto difficulty = options.difficulties[job / options.matches];
+    auto& batch = results[difficulty];
+
+    game.botDifficulty = difficulty;
+
+//  Matches differ from each other, but rerun the same
+    const uint32_t seed = options.seed + job;
+
+    batch.seedFirst = batch.matches == 0 ? seed : std::min(batch.seedFirst, seed);
+    batch.seedLast = batch.matches == 0 ? seed : std::max(batch.seedLast, seed);
+
+    ++batch.matches;
+    batch.ticks += runMatch(options, seed);
+
+    batch.bulletsPeak = std::max(
+      batch.bulletsPeak, localWorld.bullets.highWaterMark() );
+
+    for ( const auto& [planeType, plane] : localWorld.planes )
+      accumulateStats(batch.stats, plane.stats());
+
+    if ( game.isRoundFinished == false )
+    {
+      ++batch.unfinished;
+      continue;
+    }
+
+    for ( const auto& [planeType, plane] : localWorld.planes )
+      if ( plane.score() >= game.winScore )
+        ++batch.wins[planeType];
+  }
+
+  bindWorld(nullptr);
+}
+
+
+static uint32_t
+planeWins(
+  const BatchResults& batch,
+  const PLANE_TYPE planeType )
+{
+  const auto wins = batch.wins.find(planeType);
+
+  if ( wins == batch.wins.end() )
+    return 0;
+
+  return wins->second;
+}
+
+static bool
+writeResults(
+  const std::string& path,
+  const std::map <DIFFICULTY::DIFFICULTY, BatchResults>& results )
+{
+  std::ofstream output { path, std::ios::trunc };
+
+  if ( output.is_open() == false )
+    return false;
+
+
+  picojson::object jsonResults;
+
+  for ( const auto& [difficulty, batch] : results )
+  {
+    auto stats = batch.stats;
+    calcDerivedStats(stats);
+
+    picojson::object jsonStats;
+    jsonStats["Matches"]      = picojson::value( (double) batch.matches );
+    jsonStats["Unfinished"]   = picojson::value( (double) batch.unfinished );
+    jsonStats["SeedFirst"]    = picojson::value( (double) batch.seedFirst );
+    jsonStats["SeedLast"]     = picojson::value( (double) batch.seedLast );
+    jsonStats["Ticks"]        = picojson::value( (double) batch.ticks );
+    jsonStats["BulletsPeak"]  = picojson::value( (double) batch.bulletsPeak );
+    jsonStats["BlueWins"]     = picojson::value( (double) planeWins(batch, PLANE_TYPE::BLUE) );
+    jsonStats["RedWins"]      = picojson::value( (double) planeWins(batch, PLANE_TYPE::RED) );
+    jsonStats["Shots"]        = picojson::value( (double) stats.shots );
+    jsonStats["PlaneHits"]    = picojson::value( (double) stats.plane_hits );
+    jsonStats["ChuteHits"]    = picojson::value( (double) stats.chute_hits );
+    jsonStats["PilotHits"]    = picojson::value( (double) stats.pilot_hits );
+    jsonStats["Jumps"]        = picojson::value( (double) stats.jumps );
+    jsonStats["Crashes"]      = picojson::value( (double) stats.crashes );
+    jsonStats["Falls"]        = picojson::value( (double) stats.falls );
+    jsonStats["Rescues"]      = picojson::value( (double) stats.rescues );
+    jsonStats["Kills"]        = picojson::value( (double) stats.plane_kills );
+    jsonStats["PlaneDeaths"]  = picojson::value( (double) stats.plane_deaths );
+    jsonStats["PilotDeaths"]  = picojson::value( (double) stats.pilot_deaths );
+    jsonStats["Accuracy"]     = picojson::value( (double) stats.accuracy );
+    jsonStats["ShotsPerKill"] = picojson::value( (double) stats.shotsPerKill );
+    jsonStats["SelfPreservation"] = picojson::value( (double) stats.selfPreservation );
+    jsonStats["Survivability"] = picojson::value( (double) stats.survivability );
+
+    jsonResults[difficultyNames[difficulty]] = picojson::value( jsonStats );
+  }
+
+  output << picojson::value( jsonResults ).serialize( true );
+
+  return true;
+}
+
+static void
+printResults(
+  const std::map <DIFFICULTY::DIFFICULTY, BatchResults>& results )
+{
+  for ( const auto& [difficulty, batch] : results )
+  {
+    auto stats = batch.stats;
+    calcDerivedStats(stats);
+
+    std::printf( "[%s]\n", difficultyNames[difficulty] );
+    std::printf( "  matches:    %u\n", batch.matches );
+    std::printf( "  seeds:      %u-%u\n", batch.seedFirst, batch.seedLast );
+    std::printf( "  blue wins:  %u\n", planeWins(batch, PLANE_TYPE::BLUE) );
+    std::printf( "  red wins:   %u\n", planeWins(batch, PLANE_TYPE::RED) );
+    std::printf( "  unfinished: %u\n", batch.unfinished );
+    std::printf( "  accuracy:   %.1f%%\n", stats.accuracy );
+    std::printf( "  kills:      %u\n", stats.totalKills );
+    std::printf( "  deaths:     %u\n", stats.totalDeaths );
+    std::printf( "  bullets:    %zu at most\n", batch.bulletsPeak );
+    std::printf( "  sim time:   %.1f s\n",
+      static_cast <double> (batch.ticks) / constants::tickRate );
+  }
+}
+
+int
+main(
+  int argc,
+  char* args[] )
+{
+  HeadlessOptions options {};
+
+  if ( parseOptions(argc, args, options) == false )
+  {
+    printUsage(args[0]);
+    return 1;
+  }
+
+
+  const uint32_t jobCount =
+    options.matches * options.difficulties.size();
+
+  const uint32_t threadCount =
+    std::min(options.threads, std::max(jobCount, 1u));
+
+  std::atomic <uint32_t> nextJob {};
+  std::vector <std::map <DIFFICULTY::DIFFICULTY, BatchResults>>
+    workerResults (threadCount);
+
+  std::vector <std::thread> workers {};
+  workers.reserve(threadCount);
+
+  const auto timeStart = std::chrono::steady_clock::now();
+
+  for ( uint32_t i {}; i < threadCount; ++i )
+    workers.emplace_back(
+      runWorker,
+      std::cref(options),
+      std::ref(nextJob),
+      std::ref(workerResults[i]) );
+
+  for ( auto& worker : workers )
+    worker.join();
+
+  const std::chrono::duration <double> elapsed =
+    std::chrono::steady_clock::now() - timeStart;
+
+
+  std::map <DIFFICULTY::DIFFICULTY, BatchResults> results {};
+
+  for ( const auto& worker : workerResults )
+    for ( const auto& [difficulty, batch] : worker )
+      accumulateResults(results[difficulty], batch);
+
+  printResults(results);
+
+  std::printf( "threads:    %u\n", threadCount );
+  std::printf( "wall time:  %.3f s (%.1f matches/s)\n",
+    elapsed.count(), jobCount / elapsed.count() );
+
+
+  if ( options.outputPath.empty() == false &&
+       writeResults(options.outputPath, results) == false )
+  {
+    std::fprintf( stderr, "Failed to write '%s'\n",
+      options.outputPath.c_str() );
+    return 1;
+  }
+
+#if defined(BIPLANES_PROFILER_ENABLED)
+  if ( options.tracePath.empty() == false &&
+       profiler_write_trace(options.tracePath) == false )
+  {
+    std::fprintf( stderr, "Failed to write '%s'\n",
+      options.tracePath.c_str() );
+    return 1;
+  }
+#endif
+
+  return 0;
+}
@@ -26,11 +26,52 @@
 
 #include <lib/picojson.h>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <algorithm>
 
 
+//  BIPLANES_MATCHMAKE_SERVER=host[:port] points
+//  the game to another server, e.g. biplanes_server
+static net::Address
+serverAddressOverride()
+{
+#if defined(VITA_PLATFORM)
+  return {};
+#else
+  const auto serverOverride = std::getenv("BIPLANES_MATCHMAKE_SERVER");
+
+  if (  serverOverride == nullptr ||
+        std::strcmp(serverOverride, "") == 0 )
+    return {};
+
+
+  const std::string server {serverOverride};
+  const auto portSeparator = server.rfind(':');
+
+  uint16_t port {MATCHMAKE_SRV_PORT};
+
+  if ( portSeparator != std::string::npos )
+    port = std::strtoul(server.c_str() + portSeparator + 1, nullptr, 10);
+
+  const auto address = net::Address::ResolveHostname(
+    server.substr(0, portSeparator) );
+
+  if ( address.GetAddress() == 0 || port == 0 )
+    return {};
+
+  return {address.GetAddress(), port};
+#endif
+}
+
 net::Address MatchMaker::GetServerAddress()
 {
+  static const auto overrideAddr = serverAddressOverride();
+
+  if ( overrideAddr.GetAddress() != 0 )
+    return overrideAddr;
+
+
   static auto mmakeAddr = net::Address::ResolveHostname(
     MATCHMAKE_SRV_HOSTNAME);
 
@@ -0,0 +1,542 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Load generator for the matchmaking server.
+//  Simulates many clients going through the same exchange as
+//  MatchMaker: MMSTREAM from its matchmaking socket, FIND from
+//  its game socket, then waiting for MMOPPONENT and searching
+//  again after each MMECHO. Reports how long pairing took.
+
+#include <include/matchmake.hpp>
+#include <include/utility.hpp>
+
+#include <lib/Net.h>
+#include <lib/picojson.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+  #include <sys/resource.h>
+#endif
+
+
+using Clock = std::chrono::steady_clock;
+
+//  Same delays as MatchMaker::Update
+static constexpr double StreamToFindDelay {0.6};
+static constexpr double ReplyTimeout {5.0};
+
+
+struct LoadTestOptions
+{
+  std::string server {"127.0.0.1"};
+  uint16_t port {MATCHMAKE_SRV_PORT};
+  uint32_t clients {1000};
+  double rate {100.0};
+  double timeout {60.0};
+};
+
+
+enum class ClientState
+{
+  FIND_BEGIN,
+  FIND_END,
+  MATCH_WAIT,
+  PAIRED,
+  TIMED_OUT,
+};
+
+struct LoadTestClient
+{
+  int32_t id {};
+  std::string password {};
+
+  std::unique_ptr <net::Socket> streamSocket {};
+  std::unique_ptr <net::Socket> gameSocket {};
+
+  ClientState state {};
+  Clock::time_point startTime {};
+  Clock::time_point timer {};
+
+  uint32_t echoes {};
+};
+
+
+struct LoadTestStats
+{
+  std::vector <double> latencies {};
+  uint32_t hosts {};
+  uint32_t guests {};
+  uint32_t echoes {};
+  uint32_t timedOut {};
+  uint32_t failedSockets {};
+  uint32_t badReplies {};
+};
+
+
+//  Net.h logs through the game's log_message,
+//  which lives in the SDL frontend
+void
+log_message(
+  const std::string& message,
+  const std::string& buffer1,
+  const std::string& buffer2,
+  const std::string& buffer3 )
+{
+  std::printf( "%s%s%s%s",
+    message.c_str(), buffer1.c_str(),
+    buffer2.c_str(), buffer3.c_str() );
+}
+
+
+static void
+printUsage(
+  const char* exeName )
+{
+  std::printf(
+    "Usage: %s [options]\n"
+    "  --server HOST     matchmaking server (default 127.0.0.1)\n"
+    "  --port N          matchmaking server port (default %u)\n"
+    "  --clients N       clients to simulate, paired by password (default 1000)\n"
+    "  --rate N          new clients per second (default 100)\n"
+    "  --timeout S       give up on a client after S seconds (default 60)\n",
+    exeName, MATCHMAKE_SRV_PORT );
+}
+
+static bool
+parseOptions(
+  int argc,
+  char* args[],
+  LoadTestOptions& options )
+{
+  for ( int i = 1; i < argc; ++i )
+  {
+    const std::string arg = args[i];
+
+    if ( arg == "--help" || arg == "-h" )
+      return false;
+
+    if ( i + 1 >= argc )
+      return false;
+
+    const std::string value = args[++i];
+
+    if ( arg == "--server" )
+      options.server = value;
+
+    else if ( arg == "--port" )
+      options.port = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--clients" )
+      options.clients = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--rate" )
+      options.rate = std::strtod(value.c_str(), nullptr);
+
+    else if ( arg == "--timeout" )
+      options.timeout = std::strtod(value.c_str(), nullptr);
+
+    else
+      return false;
+  }
+
+  return
+    options.port != 0 &&
+    options.clients != 0 &&
+    options.rate > 0.0 &&
+    options.timeout > 0.0;
+}
+
+
+//  Every waiting client holds two sockets
+static void
+raiseFileLimit()
+{
+#if !defined(_WIN32)
+  rlimit limit {};
+
+  if ( getrlimit(RLIMIT_NOFILE, &limit) != 0 )
+    return;
+
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+#endif
+}
+
+
+static void
+sendMessage(
+  net::Socket& socket,
+  const net::Address& destination,
+  const picojson::object& message )
+{
+  const auto payload = picojson::value(message).serialize();
+
+  socket.Send(
+    destination,
+    payload.c_str(),
+    payload.size() );
+}
+
+static bool
+openSockets(
+  LoadTestClient& client )
+{
+  client.streamSocket = std::make_unique <net::Socket> ();
+  client.gameSocket = std::make_unique <net::Socket> ();
+
+  return
+    client.streamSocket->Open(0) == true &&
+    client.gameSocket->Open(0) == true;
+}
+
+static void
+closeSockets(
+  LoadTestClient& client )
+{
+  client.streamSocket.reset();
+  client.gameSocket.reset();
+}
+
+
+static void
+receiveReplies(
+  LoadTestClient& client,
+  LoadTestStats& stats,
+  const Clock::time_point now )
+{
+  char buffer[512] {};
+  net::Address sender {};
+
+  int size {};
+
+  while ( ( size = client.streamSocket->Receive(sender, buffer, sizeof(buffer)) ) > 0 )
+  {
+    picojson::value json {};
+    std::string error {};
+
+    const char* begin = buffer;
+    picojson::parse( json, begin, begin + size, &error );
+
+    if ( error.empty() == false || json.is <picojson::object> () == false )
+    {
+      ++stats.badReplies;
+      continue;
+    }
+
+
+    const auto& reply = json.get <picojson::object> ();
+
+    const auto type = reply.find(MATCHMAKE_MSG_TYPE);
+
+    if ( type == reply.end() || type->second.is <double> () == false )
+    {
+      ++stats.badReplies;
+      continue;
+    }
+
+    const auto status = static_cast <MatchConnectStatus> (type->second.get <double> ());
+
+    if ( status == MatchConnectStatus::MMECHO )
+    {
+//    MatchMaker searches again once its reply timer runs out
+      ++client.echoes;
+      ++stats.echoes;
+      client.state = ClientState::FIND_BEGIN;
+
+      continue;
+    }
+
+    if ( status != MatchConnectStatus::MMOPPONENT )
+    {
+      ++stats.badReplies;
+      continue;
+    }
+
+
+    const auto nodeType = reply.find("cs");
+
+    if ( nodeType == reply.end() ||
+         reply.count("ip") == 0 || reply.count("port") == 0 )
+    {
+      ++stats.badReplies;
+      continue;
+    }
+
+    if ( nodeType->second.to_str() == "server" )
+      ++stats.hosts;
+
+    else if ( nodeType->second.to_str() == "client" )
+      ++stats.guests;
+
+    else
+    {
+      ++stats.badReplies;
+      continue;
+    }
+
+
+    const std::chrono::duration <double> latency = now - client.startTime;
+    stats.latencies.push_back(latency.count());
+
+    client.state = ClientState::PAIRED;
+    closeSockets(client);
+
+    return;
+  }
+}
+
+static void
+updateClient(
+  LoadTestClient& client,
+  LoadTestStats& stats,
+  const net::Address& server,
+  const LoadTestOptions& options,
+  const Clock::time_point now )
+{
+  const std::chrono::duration <double> age = now - client.startTime;
+
+  if ( age.count() > options.timeout )
+  {
+    ++stats.timedOut;
+    client.state = ClientState::TIMED_OUT;
+    closeSockets(client);
+
+    return;
+  }
+
+
+  switch ( client.state )
+  {
+    case ClientState::FIND_BEGIN:
+    {
+      if ( now < client.timer )
+        return;
+
+      picojson::object message {};
+      message[MATCHMAKE_MSG_TYPE] = picojson::value( (double) MatchConnectStatus::MMSTREAM );
+      message[MATCHMAKE_MSG_CID] = picojson::value( (double) client.id );
+
+      sendMessage(*client.streamSocket, server, message);
+
+      client.timer = now + std::chrono::duration_cast <Clock::duration> (
+        std::chrono::duration <double> {StreamToFindDelay} );
+
+      client.state = ClientState::FIND_END;
+
+      return;
+    }
+
+    case ClientState::FIND_END:
+    {
+      if ( now < client.timer )
+        return;
+
+      picojson::object message {};
+      message[MATCHMAKE_MSG_TYPE] = picojson::value( (double) MatchConnectStatus::FIND );
+      message[MATCHMAKE_MSG_CID] = picojson::value( (double) client.id );
+      message[MATCHMAKE_MSG_PASS] = picojson::value( client.password );
+
+      sendMessage(*client.gameSocket, server, message);
+
+      client.timer = now + std::chrono::duration_cast <Clock::duration> (
+        std::chrono::duration <double> {ReplyTimeout} );
+
+      client.state = ClientState::MATCH_WAIT;
+
+      return;
+    }
+
+    case ClientState::MATCH_WAIT:
+    {
+      receiveReplies(client, stats, now);
+
+      if ( client.state == ClientState::MATCH_WAIT && now >= client.timer )
+        client.state = ClientState::FIND_BEGIN;
+
+      return;
+    }
+
+    default:
+      return;
+  }
+}
+
+
+static double
+percentile(
+  const std::vector <double>& sorted,
+  const double fraction )
+{
+  if ( sorted.empty() == true )
+    return 0.0;
+
+  const size_t index = fraction * ( sorted.size() - 1 ) + 0.5;
+
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void
+printReport(
+  LoadTestStats& stats,
+  const LoadTestOptions& options,
+  const double duration )
+{
+  auto& latencies = stats.latencies;
+  std::sort(latencies.begin(), latencies.end());
+
+  std::printf( "\nclients: %u, paired: %zu (%u hosts, %u guests), timed out: %u\n",
+    options.clients, latencies.size(),
+    stats.hosts, stats.guests, stats.timedOut );
+
+  std::printf( "echoes: %u, bad replies: %u, socket failures: %u\n",
+    stats.echoes, stats.badReplies, stats.failedSockets );
+
+  std::printf( "pairing throughput: %.1f clients/s over %.1f s\n",
+    latencies.size() / duration, duration );
+
+  if ( latencies.empty() == true )
+    return;
+
+  std::printf( "pairing latency, ms: p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+    percentile(latencies, 0.50) * 1000.0,
+    percentile(latencies, 0.90) * 1000.0,
+    percentile(latencies, 0.99) * 1000.0,
+    latencies.back() * 1000.0 );
+}
+
+
+int
+main(
+  int argc,
+  char* args[] )
+{
+  LoadTestOptions options {};
+
+  if ( parseOptions(argc, args, options) == false )
+  {
+    printUsage(args[0]);
+    return 1;
+  }
+
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+
+  if ( net::InitializeSockets() != 0 )
+  {
+    std::fprintf( stderr, "Failed to initialize sockets\n" );
+    return 1;
+  }
+
+  raiseFileLimit();
+
+  const auto serverAddress = net::Address::ResolveHostname(options.server);
+
+  if ( serverAddress.GetAddress() == 0 )
+  {
+    std::fprintf( stderr, "Failed to resolve '%s'\n", options.server.c_str() );
+    return 1;
+  }
+
+  const net::Address server {serverAddress.GetAddress(), options.port};
+
+
+//  Random like MatchMaker's, so reruns don't reuse ids
+  std::mt19937 random {std::random_device{}()};
+  const uint32_t idBase = random() % 1'000'000;
+
+  std::vector <LoadTestClient> clients (options.clients);
+  LoadTestStats stats {};
+
+  const auto arrivalInterval = std::chrono::duration_cast <Clock::duration> (
+    std::chrono::duration <double> {1.0 / options.rate} );
+
+  const auto startTime = Clock::now();
+  auto nextArrival = startTime;
+
+  uint32_t started {};
+  uint32_t finished {};
+
+
+  while ( finished < options.clients )
+  {
+    const auto now = Clock::now();
+
+//  Consecutive clients share a password and should pair
+    while ( started < options.clients && now >= nextArrival )
+    {
+      auto& client = clients[started];
+
+      client.id = ( idBase + started ) % 1'000'000;
+      client.password = "loadtest" + std::to_string(started / 2);
+      client.startTime = now;
+      client.timer = now;
+
+      ++started;
+      nextArrival += arrivalInterval;
+
+      if ( openSockets(client) == false )
+      {
+        ++stats.failedSockets;
+        ++finished;
+        client.state = ClientState::TIMED_OUT;
+        closeSockets(client);
+
+        continue;
+      }
+    }
+
+
+    for ( uint32_t i {}; i < started; ++i )
+    {
+      auto& client = clients[i];
+
+      if (  client.state == ClientState::PAIRED ||
+            client.state == ClientState::TIMED_OUT ||
+            client.streamSocket == nullptr )
+        continue;
+
+      updateClient(client, stats, server, options, now);
+
+      if (  client.state == ClientState::PAIRED ||
+            client.state == ClientState::TIMED_OUT )
+        ++finished;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+
+  const std::chrono::duration <double> duration = Clock::now() - startTime;
+
+  printReport(stats, options, duration.count());
+
+  net::ShutdownSockets();
+
+  return 0;
+}
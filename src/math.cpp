@@ -23,14 +23,94 @@
 
 #include <lib/godot_math.hpp>
 
+#include <array>
 #include <cmath>
 
 
+//  Table covers a full turn plus a guard entry for interpolation.
+//  It's computed by the compiler from IEEE double arithmetic alone,
+//  so it doesn't depend on the platform's libm
+static constexpr size_t sineTableSize {1024};
+
+static constexpr double
+taylorSine(
+  const double radians )
+{
+  double term {radians};
+  double sum {radians};
+
+  for ( int n = 1; n < 12; ++n )
+  {
+    term *= -radians * radians / ( (2 * n) * (2 * n + 1) );
+    sum += term;
+  }
+
+  return sum;
+}
+
+static constexpr std::array <float, sineTableSize + 1>
+makeSineTable()
+{
+  constexpr double pi {3.14159265358979323846};
+  constexpr size_t quarter {sineTableSize / 4};
+
+  std::array <float, sineTableSize + 1> table {};
+
+//  Mirroring the first quadrant keeps 0, 90, 180
+//  and 270 degrees exact and the table symmetric
+  for ( size_t i = 0; i <= quarter; ++i )
+  {
+    const auto value = static_cast <float> (
+      taylorSine(2.0 * pi * i / sineTableSize) );
+
+    table[i] = value;
+    table[2 * quarter - i] = value;
+    table[2 * quarter + i] = -value;
+    table[4 * quarter - i] = -value;
+  }
+
+  table[0] = 0.f;
+  table[2 * quarter] = 0.f;
+  table[sineTableSize] = table[0];
+
+  return table;
+}
+
+static constexpr auto sineTable = makeSineTable();
+
+
+static_assert(
+  sineTableSize % constants::plane::directionCount == 0,
+  "Every pitch step must land on a sine table entry" );
+
+static constexpr std::array <Direction, constants::plane::directionCount>
+makeDirectionTable()
+{
+  constexpr size_t step {sineTableSize / constants::plane::directionCount};
+  constexpr size_t quarter {sineTableSize / 4};
+
+  std::array <Direction, constants::plane::directionCount> table {};
+
+  for ( size_t i = 0; i < table.size(); ++i )
+  {
+    const auto sineIndex = i * step;
+    const auto cosineIndex = (sineIndex + quarter) % sineTableSize;
+
+    table[i] = {sineTable[sineIndex], -sineTable[cosineIndex]};
+  }
+
+  return table;
+}
+
+static constexpr auto directionTable = makeDirectionTable();
+
+
 bool
 segment_intersects_polygon(
   const SDL_Vector& from,
   const SDL_Vector& to,
-  const std::vector <SDL_Vector>& polygon,
+  const SDL_Vector* polygon,
+  const size_t pointCount,
   SDL_Vector* contact )
 {
   const auto delta = to - from;
@@ -40,13 +120,13 @@ segment_intersects_polygon(
 
   SDL_Vector closestContactPoint {from + delta * 2.f};
 
-  for ( size_t i = 0, j = 1; j < polygon.size(); ++i, ++j )
+  for ( size_t i = 0, j = 1; j < pointCount; ++i, ++j )
   {
     SDL_Vector contactPoint {};
 
     const auto intersects = segment_intersects_segment(
       from, to,
-      polygon.at(i), polygon.at(j),
+      polygon[i], polygon[j],
       &contactPoint );
 
     if ( intersects == false )
@@ -122,3 +202,63 @@ size_t angleToPitchIndex(
   return std::round(
     degrees / constants::plane::pitchStep );
 }
+
+float
+sin_deg(
+  const float degrees )
+{
+#if defined(BIPLANES_DETERMINISTIC_MATH)
+  const float turns = degrees / 360.f;
+  const float position =
+    (turns - std::floor(turns)) * sineTableSize;
+
+  const size_t index = std::min(
+    static_cast <size_t> (position),
+    sineTableSize - 1 );
+
+  const float fraction = position - index;
+
+  return
+    sineTable[index] +
+    (sineTable[index + 1] - sineTable[index]) * fraction;
+#else
+  return std::sin(degrees * M_PI / 180.0);
+#endif
+}
+
+float
+cos_deg(
+  const float degrees )
+{
+#if defined(BIPLANES_DETERMINISTIC_MATH)
+  return sin_deg(degrees + 90.f);
+#else
+  return std::cos(degrees * M_PI / 180.0);
+#endif
+}
+
+const Direction&
+pitch_direction(
+  const size_t pitchIndex )
+{
+  return directionTable[pitchIndex % directionTable.size()];
+}
+
+Direction
+direction_vector(
+  const float degrees )
+{
+  const float steps =
+    clamp_angle(degrees, 360.f) / constants::plane::pitchStep;
+
+  const float pitchIndex = std::floor(steps);
+
+  if ( steps == pitchIndex )
+    return pitch_direction(pitchIndex);
+
+  return
+  {
+    sin_deg(degrees),
+    -cos_deg(degrees),
+  };
+}
@@ -20,18 +20,22 @@
 
 #include <include/menu.hpp>
 #include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
 #include <include/time.hpp>
 #include <include/timer.hpp>
 #include <include/constants.hpp>
 #include <include/game_state.hpp>
 #include <include/network_state.hpp>
 #include <include/render.hpp>
+#include <include/resources.hpp>
 #include <include/biplanes.hpp>
 #include <include/controls.hpp>
 #include <include/plane.hpp>
+#include <include/world.hpp>
 #include <include/textures.hpp>
 #include <include/variables.hpp>
 #include <include/utility.hpp>
+#include <include/profiler.hpp>
 
 #if !defined(__EMSCRIPTEN__)
   #include <include/matchmake.hpp>
@@ -151,6 +155,8 @@ Menu::currentMessage() const
 void
 Menu::DrawMenu()
 {
+  PROFILE_ZONE("Menu::DrawMenu");
+
   AnimateButton();
 
 
@@ -166,7 +172,11 @@ Menu::DrawMenu()
     {
       if ( game.autoSkipIntro == true )
       {
-        ChangeRoom(ROOMS::MENU_MAIN);
+//        Splash screen waits for assets to load
+        ChangeRoom(
+          resources_loaded() == true
+          ? ROOMS::MENU_MAIN
+          : ROOMS::MENU_SPLASH );
         break;
       }
 
@@ -187,7 +197,8 @@ Menu::DrawMenu()
     {
       mIntroAutoSkipTimer.Update();
 
-      if ( mIntroAutoSkipTimer.isReady() == true )
+      if (  mIntroAutoSkipTimer.isReady() == true &&
+            resources_loaded() == true )
       {
         ChangeRoom(ROOMS::MENU_MAIN);
         break;
@@ -286,8 +297,8 @@ Menu::DrawMenu()
 
       if ( mmakeState == MatchMakerState::MATCH_READY )
       {
-        auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-        auto& planeRed = planes.at(PLANE_TYPE::RED);
+        auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+        auto& planeRed = world().planes.at(PLANE_TYPE::RED);
 
         planeBlue.setBot(false);
         planeRed.setBot(false);
@@ -510,8 +521,8 @@ Menu::DrawMenu()
         break;
 
 
-      const auto& planeRed = planes.at(PLANE_TYPE::RED);
-      const auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
+      const auto& planeRed = world().planes.at(PLANE_TYPE::RED);
+      const auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
 
 
       switch (game.gameMode)
@@ -766,8 +777,8 @@ Menu::DrawButton()
 
   const SDL_Rect srcRect
   {
-    mButtonX * 0.5f * button::width,
-    0,
+    textures.menu_button_rect.x + mButtonX * 0.5f * button::width,
+    textures.menu_button_rect.y,
     0.5f * button::width,
     button::height,
   };
@@ -780,11 +791,10 @@ Menu::DrawButton()
     scaleToScreenY(button::sizeY),
   };
 
-  SDL_RenderCopyF(
-    gRenderer,
+  sprite_batch_draw(
     textures.menu_button,
     &srcRect,
-    &buttonRect );
+    buttonRect );
 }
 
 
@@ -1044,9 +1054,24 @@ Menu::screen_splash()
     scaleToScreenY(1.0f),
   };
 
-  SDL_RenderCopyF(
-    gRenderer,
+  sprite_batch_draw(
     textures.menu_logo,
-    nullptr,
-    &logoRect );
+    &textures.menu_logo_rect,
+    logoRect );
+
+
+  if ( resources_loaded() == true )
+    return;
+
+
+  const SDL_FRect progressRect
+  {
+    toWindowSpaceX(0.0f),
+    toWindowSpaceY(0.98f),
+    scaleToScreenX(resources_load_progress()),
+    scaleToScreenY(0.02f),
+  };
+
+  setRenderColor(constants::colors::menuBorder);
+  SDL_RenderFillRectF(gRenderer, &progressRect);
 }
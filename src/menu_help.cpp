@@ -21,8 +21,10 @@
 #include <include/menu.hpp>
 #include <include/render.hpp>
 #include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
 #include <include/controls.hpp>
 #include <include/constants.hpp>
+#include <include/resource_cache.hpp>
 #include <include/textures.hpp>
 #include <include/variables.hpp>
 
@@ -249,11 +251,10 @@ Menu::screen_help()
     scaleToScreenY(1.0f),
   };
 
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.menu_help,
+  sprite_batch_draw(
+    resourceCache().texture(textures.menu_help),
     nullptr,
-    &helpRect );
+    helpRect );
 
 
   const SDL_FRect planeRect
@@ -265,13 +266,11 @@ Menu::screen_help()
     scaleToScreenY(plane::sizeY),
   };
 
-  SDL_RenderCopyExF(
-    gRenderer,
+  sprite_batch_draw_ex(
     textures.plane_blue,
-    nullptr,
-    &planeRect,
+    &textures.plane_blue_rect,
+    planeRect,
     337.5,
-    nullptr,
     SDL_FLIP_NONE );
 
 
@@ -24,7 +24,9 @@
 #include <include/game_state.hpp>
 #include <include/network.hpp>
 #include <include/network_state.hpp>
+#include <include/resources.hpp>
 #include <include/plane.hpp>
+#include <include/world.hpp>
 #include <include/variables.hpp>
 #include <include/utility.hpp>
 
@@ -150,8 +152,8 @@ Menu::Select()
         case MENU_SP_SETUP::START:
         {
           auto& gameMode = gameState().gameMode;
-          auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-          auto& planeRed = planes.at(PLANE_TYPE::RED);
+          auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+          auto& planeRed = world().planes.at(PLANE_TYPE::RED);
 
           planeBlue.setLocal(true);
           planeRed.setLocal(true);
@@ -428,8 +430,8 @@ Menu::Select()
         {
 #if !defined(__EMSCRIPTEN__)
           auto& network = networkState();
-          auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-          auto& planeRed = planes.at(PLANE_TYPE::RED);
+          auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+          auto& planeRed = world().planes.at(PLANE_TYPE::RED);
 
           network.nodeType = SRV_CLI::SERVER;
 
@@ -503,8 +505,8 @@ Menu::Select()
         {
 #if !defined(__EMSCRIPTEN__)
           auto& network = networkState();
-          auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-          auto& planeRed = planes.at(PLANE_TYPE::RED);
+          auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+          auto& planeRed = world().planes.at(PLANE_TYPE::RED);
 
           network.nodeType = SRV_CLI::CLIENT;
 
@@ -569,8 +571,8 @@ Menu::Select()
         case MENU_MP_HOTSEAT::START:
         {
           auto& gameMode = gameState().gameMode;
-          auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-          auto& planeRed = planes.at(PLANE_TYPE::RED);
+          auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+          auto& planeRed = world().planes.at(PLANE_TYPE::RED);
 
           planeBlue.setLocal(true);
           planeRed.setLocal(true);
@@ -778,7 +780,9 @@ Menu::Select()
 
     case ROOMS::MENU_SPLASH:
     {
-      ChangeRoom(ROOMS::MENU_MAIN);
+      if ( resources_loaded() == true )
+        ChangeRoom(ROOMS::MENU_MAIN);
+
       break;
     }
 
@@ -801,7 +805,9 @@ Menu::GoBack()
 
     case ROOMS::MENU_SPLASH:
     {
-      ChangeRoom(ROOMS::MENU_MAIN);
+      if ( resources_loaded() == true )
+        ChangeRoom(ROOMS::MENU_MAIN);
+
       break;
     }
 
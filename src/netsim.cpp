@@ -0,0 +1,824 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Loopback netcode test.
+//  Forks into two peers that play an online match over localhost,
+//  each conditioning its outgoing traffic with the same link
+//  conditioner config, and steering its plane with random input.
+//  Each peer samples its world state once it's past the rollback
+//  window, so both samples of a frame must agree: the tool
+//  compares them and fails if the peers' states diverged.
+
+#include <include/simulation.hpp>
+#include <include/world.hpp>
+#include <include/world_snapshot.hpp>
+#include <include/constants.hpp>
+#include <include/controls.hpp>
+#include <include/game_state.hpp>
+#include <include/network.hpp>
+#include <include/network_data.hpp>
+#include <include/network_state.hpp>
+#include <include/plane.hpp>
+#include <include/rollback.hpp>
+#include <include/time.hpp>
+#include <include/utility.hpp>
+
+#include <lib/Net.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr float ConnectionTimeout {10.0f};
+static constexpr double ConnectTimeout {5.0};
+
+//  Keep answering after the last frame,
+//  so the opponent can finish as well
+static constexpr double LingerTime {1.0};
+
+//  Frames are sampled this many frames late, any input and
+//  correction that arrives later is ignored by the rollback
+static constexpr uint32_t SampleDelay {rollbackFrames - 16};
+static constexpr uint32_t SampleInterval {12};
+
+//  Frames to hold each random input for
+static constexpr uint32_t InputHoldFrames {30};
+
+
+struct NetsimOptions
+{
+  std::string conditions {};
+  double seconds {30.0};
+  uint16_t port {23800};
+  uint32_t seed {1};
+  float tolerance {0.01f};
+  bool isVerbose {};
+};
+
+
+struct PlaneSample
+{
+  float x {};
+  float y {};
+  float dir {};
+  float pilotX {};
+  float pilotY {};
+  uint8_t hp {};
+  uint8_t score {};
+  bool isDead {};
+  bool hasJumped {};
+};
+
+struct Sample
+{
+  uint32_t frame {};
+  PlaneSample planes[2] {};
+};
+
+struct PeerResults
+{
+  bool isConnected {};
+  uint32_t frames {};
+  uint32_t stalls {};
+  uint32_t packetsSent {};
+  uint32_t packetsReceived {};
+  uint32_t packetsLost {};
+  float roundTripTime {};
+  float sentBandwidth {};
+  float sendRate {};
+  uint32_t sampleCount {};
+};
+
+
+static bool isVerbose {};
+
+
+void
+log_message(
+  const std::string& message,
+  const std::string& buffer1,
+  const std::string& buffer2,
+  const std::string& buffer3 )
+{
+  if ( isVerbose == false )
+    return;
+
+  std::printf( "[%d] %s%s%s%s", getpid(),
+    message.c_str(), buffer1.c_str(),
+    buffer2.c_str(), buffer3.c_str() );
+}
+
+NetworkState&
+networkState()
+{
+  static NetworkState state {};
+  return state;
+}
+
+
+static void
+printUsage(
+  const char* exeName )
+{
+  std::printf(
+    "Usage: %s [options]\n"
+    "  --conditions FILE  link conditioner config applied to both peers\n"
+    "  --seconds N        match length (default 30)\n"
+    "  --port N           host port, the client uses the next one (default 23800)\n"
+    "  --seed N           random input seed (default 1)\n"
+    "  --tolerance X      largest coordinate difference between peers (default 0.01)\n"
+    "  --verbose          print network log of both peers\n",
+    exeName );
+}
+
+static bool
+parseOptions(
+  int argc,
+  char* args[],
+  NetsimOptions& options )
+{
+  for ( int i = 1; i < argc; ++i )
+  {
+    const std::string arg = args[i];
+
+    if ( arg == "--help" || arg == "-h" )
+      return false;
+
+    if ( arg == "--verbose" )
+    {
+      options.isVerbose = true;
+      continue;
+    }
+
+    if ( i + 1 >= argc )
+      return false;
+
+    const std::string value = args[++i];
+
+    if ( arg == "--conditions" )
+      options.conditions = value;
+
+    else if ( arg == "--seconds" )
+      options.seconds = std::strtod(value.c_str(), nullptr);
+
+    else if ( arg == "--port" )
+      options.port = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--seed" )
+      options.seed = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--tolerance" )
+      options.tolerance = std::strtod(value.c_str(), nullptr);
+
+    else
+      return false;
+  }
+
+  return
+    options.seconds > 0.0 &&
+    options.port != 0 &&
+    options.port != 0xFFFF;
+}
+
+
+static void
+handleSimEvent(
+  const SimEvent& event )
+{
+  if ( event.type == SIM_EVENT::NETWORK_EVENT )
+    eventPush(event.netEvent);
+}
+
+static Controls
+randomControls(
+  std::mt19937& random )
+{
+  Controls controls {};
+
+  controls.pitch = static_cast <PLANE_PITCH> (random() % 3);
+  controls.throttle = static_cast <PLANE_THROTTLE> (random() % 3);
+  controls.shoot = random() % 3 == 0;
+  controls.jump = random() % 50 == 0;
+
+  return controls;
+}
+
+static PlaneSample
+samplePlane(
+  const Plane& plane )
+{
+  PlaneSample sample {};
+
+  sample.x = plane.x();
+  sample.y = plane.y();
+  sample.dir = plane.dir();
+  sample.pilotX = plane.pilot.x();
+  sample.pilotY = plane.pilot.y();
+  sample.hp = plane.hp();
+  sample.score = plane.score();
+  sample.isDead = plane.isDead();
+  sample.hasJumped = plane.hasJumped();
+
+  return sample;
+}
+
+
+static void
+resetMatch()
+{
+  eventsReset();
+  rollbackReset();
+  sim_reset();
+}
+
+static void
+sendPeerPacket()
+{
+  auto& network = networkState();
+
+  Packet packet {};
+  packet.waiting = network.isOpponentConnected == false;
+
+  rollbackPackInputs(packet);
+
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
+  const auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+  const auto& planeRed = world().planes.at(PLANE_TYPE::RED);
+
+  const auto& planeLocal =
+    planeBlue.isLocal() == true
+    ? planeBlue
+    : planeRed;
+
+  if ( network.flowControl->ShouldSendState() == true )
+    packet << planeLocal.getNetworkData();
+#endif
+
+  eventsPack(packet);
+
+  sendPacket(packet);
+}
+
+static void
+receivePeerPackets()
+{
+  auto& network = networkState();
+
+  Packet packet {};
+
+  while ( receivePacket(packet) == true )
+  {
+    if ( network.isOpponentConnected == false )
+    {
+      network.isOpponentConnected = true;
+      resetMatch();
+    }
+
+    if ( packet.disconnect == false )
+      processOpponentData(packet);
+  }
+}
+
+
+//  Mirrors game_loop_mp without menus, rendering and sound
+static PeerResults
+runPeer(
+  const NetsimOptions& options,
+  const SRV_CLI nodeType,
+  std::vector <Sample>& samples )
+{
+  PeerResults results {};
+
+  World peerWorld {};
+  bindWorld(&peerWorld);
+
+  auto& game = gameState();
+  game.output.toFile = false;
+  game.output.stats = false;
+  game.gameMode = GAME_MODE::HUMAN_VS_HUMAN;
+  game.winScore = 0;
+
+  auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+  auto& planeRed = world().planes.at(PLANE_TYPE::RED);
+
+  planeBlue.setBot(false);
+  planeRed.setBot(false);
+  planeBlue.setLocal(nodeType == SRV_CLI::SERVER);
+  planeRed.setLocal(nodeType == SRV_CLI::CLIENT);
+
+  setSimEventHandler(handleSimEvent);
+
+
+  net::ReliableConnection connection {ProtocolId, ConnectionTimeout};
+  net::FlowControl flowControl {};
+  flowControlInit(flowControl);
+  net::LinkConditioner conditioner {options.seed * 2 + static_cast <uint32_t> (nodeType)};
+
+  auto& network = networkState();
+  network.connection = &connection;
+  network.flowControl = &flowControl;
+  network.nodeType = nodeType;
+
+  if (  options.conditions.empty() == false &&
+        conditioner.LoadConfig(options.conditions) == false )
+    return results;
+
+  connection.socket.SetConditioner(&conditioner);
+
+
+  const uint16_t port =
+    nodeType == SRV_CLI::SERVER
+    ? options.port : options.port + 1;
+
+  if ( connection.Start(port) == false )
+    return results;
+
+  if ( nodeType == SRV_CLI::SERVER )
+    connection.Listen();
+  else
+    connection.Connect({127, 0, 0, 1, options.port});
+
+  game.isRoundFinished = false;
+  resetMatch();
+  game.isRoundRunning = true;
+
+
+  std::mt19937 random {options.seed * 2 + static_cast <uint32_t> (nodeType)};
+  Controls controls {};
+
+  const auto tickInterval = std::chrono::duration_cast <Clock::duration> (
+    std::chrono::duration <double> {1.0 / constants::tickRate} );
+
+  const auto lastFrame = static_cast <uint32_t> (options.seconds * constants::tickRate);
+
+  const auto startTime = Clock::now();
+  auto timePrevious = startTime;
+  auto tickNext = startTime;
+
+  double packetSendTime {};
+  uint32_t packetsSent {};
+  double roundTripTimeSum {};
+  uint32_t roundTripTimeCount {};
+
+  Clock::time_point finishTime {};
+  bool isFinished {};
+
+
+  while ( true )
+  {
+    tickNext += tickInterval;
+    std::this_thread::sleep_until(tickNext);
+
+    const auto timeCurrent = Clock::now();
+    deltaTime = std::chrono::duration <double> (timeCurrent - timePrevious).count();
+    timePrevious = timeCurrent;
+
+    connection.Update(deltaTime);
+
+    if ( connection.ConnectHasErrors() == true )
+      break;
+
+
+    receivePeerPackets();
+
+    if ( network.isOpponentConnected == false )
+    {
+      const std::chrono::duration <double> waited = timeCurrent - startTime;
+
+      if ( waited.count() > ConnectTimeout )
+        break;
+    }
+
+    else if ( isFinished == false )
+    {
+      flowControl.Update(
+        connection.GetReliabilitySystem(),
+        deltaTime );
+
+      roundTripTimeSum += connection.GetReliabilitySystem().GetRoundTripTime();
+      ++roundTripTimeCount;
+    }
+
+
+    if ( isFinished == false )
+    {
+      if ( rollbackFrame() % InputHoldFrames == 0 )
+        controls = randomControls(random);
+
+      const bool isAheadOfOpponent =
+        network.isOpponentConnected == true &&
+        rollbackShouldStall(
+          connection.GetReliabilitySystem().GetRoundTripTime() );
+
+      if ( isAheadOfOpponent == true )
+        ++results.stalls;
+      else
+        rollbackAdvance(controls, network.isOpponentConnected);
+
+
+      const auto frame = rollbackFrame();
+
+      if (  network.isOpponentConnected == true &&
+            frame >= SampleDelay &&
+            ( frame - SampleDelay ) % SampleInterval == 0 )
+      {
+        const auto snapshot = rollbackSnapshot(frame - SampleDelay);
+
+        if ( snapshot != nullptr )
+        {
+          Sample sample {};
+          sample.frame = frame - SampleDelay;
+          sample.planes[0] = samplePlane(snapshot->planes[0]);
+          sample.planes[1] = samplePlane(snapshot->planes[1]);
+
+          samples.push_back(sample);
+        }
+      }
+
+      if ( network.isOpponentConnected == true && frame >= lastFrame )
+      {
+        isFinished = true;
+        finishTime = timeCurrent;
+      }
+    }
+
+    else if ( timeCurrent - finishTime > std::chrono::duration <double> {LingerTime} )
+      break;
+
+
+    const auto packetSendInterval = 1.0 / flowControl.GetSendRate();
+
+    if ( packetSendTime >= packetSendInterval )
+    {
+      while ( packetSendTime >= packetSendInterval )
+        packetSendTime -= packetSendInterval;
+
+      sendPeerPacket();
+      ++packetsSent;
+    }
+
+    packetSendTime += deltaTime;
+  }
+
+
+  const auto& reliability = connection.GetReliabilitySystem();
+
+  results.isConnected = isFinished;
+  results.frames = rollbackFrame();
+  results.packetsSent = reliability.GetSentPackets();
+  results.packetsReceived = reliability.GetReceivedPackets();
+  results.packetsLost = reliability.GetLostPackets();
+  results.sentBandwidth = reliability.GetSentBandwidth();
+  results.sampleCount = samples.size();
+
+  if ( roundTripTimeCount > 0 )
+    results.roundTripTime = roundTripTimeSum / roundTripTimeCount;
+
+  const std::chrono::duration <double> runTime = Clock::now() - startTime;
+  results.sendRate = packetsSent / runTime.count();
+
+  connection.Stop();
+  bindWorld(nullptr);
+
+  return results;
+}
+
+
+static bool
+writeAll(
+  const int fd,
+  const void* data,
+  const size_t size )
+{
+  auto bytes = static_cast <const char*> (data);
+  size_t written {};
+
+  while ( written < size )
+  {
+    const auto result = write(fd, bytes + written, size - written);
+
+    if ( result <= 0 )
+      return false;
+
+    written += result;
+  }
+
+  return true;
+}
+
+static bool
+readAll(
+  const int fd,
+  void* data,
+  const size_t size )
+{
+  auto bytes = static_cast <char*> (data);
+  size_t received {};
+
+  while ( received < size )
+  {
+    const auto result = read(fd, bytes + received, size - received);
+
+    if ( result <= 0 )
+      return false;
+
+    received += result;
+  }
+
+  return true;
+}
+
+
+struct Peer
+{
+  pid_t pid {};
+  int pipe {};
+
+  PeerResults results {};
+  std::vector <Sample> samples {};
+};
+
+static bool
+startPeer(
+  const NetsimOptions& options,
+  const SRV_CLI nodeType,
+  Peer& peer )
+{
+  int fds[2] {};
+
+  if ( pipe(fds) != 0 )
+    return false;
+
+  peer.pid = fork();
+
+  if ( peer.pid < 0 )
+    return false;
+
+  if ( peer.pid == 0 )
+  {
+    close(fds[0]);
+
+    std::vector <Sample> samples {};
+    const auto results = runPeer(options, nodeType, samples);
+
+    const bool isWritten =
+      writeAll(fds[1], &results, sizeof(results)) == true &&
+      writeAll(fds[1], samples.data(), samples.size() * sizeof(Sample)) == true;
+
+    close(fds[1]);
+    _exit(isWritten == true ? 0 : 1);
+  }
+
+  close(fds[1]);
+  peer.pipe = fds[0];
+
+  return true;
+}
+
+static bool
+finishPeer(
+  Peer& peer )
+{
+  bool isRead = readAll(peer.pipe, &peer.results, sizeof(peer.results));
+
+  if ( isRead == true )
+  {
+    peer.samples.resize(peer.results.sampleCount);
+
+    isRead = readAll(peer.pipe,
+      peer.samples.data(), peer.samples.size() * sizeof(Sample) );
+  }
+
+  close(peer.pipe);
+
+  int status {};
+  waitpid(peer.pid, &status, 0);
+
+  return isRead == true && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+
+static void
+printPeer(
+  const char* name,
+  const PeerResults& results )
+{
+  const float lossRatio =
+    results.packetsSent > 0
+    ? 100.0f * results.packetsLost / results.packetsSent
+    : 0.0f;
+
+  std::printf( "%s: %u frames, %u stalls, rtt %.1f ms, "
+    "packets sent %u, received %u, lost %u (%.1f%%), "
+    "%.1f packets/s, %.1f kbit/s\n",
+    name, results.frames, results.stalls,
+    results.roundTripTime * 1000.0f,
+    results.packetsSent, results.packetsReceived,
+    results.packetsLost, lossRatio,
+    results.sendRate, results.sentBandwidth );
+}
+
+static float
+angleDifference(
+  const float lhs,
+  const float rhs )
+{
+  const float difference = std::fabs(lhs - rhs);
+
+  return std::min(difference, 360.0f - difference);
+}
+
+//  Returns whether the peers agree on every sampled frame
+static bool
+compareSamples(
+  const Peer& host,
+  const Peer& client,
+  const float tolerance )
+{
+  std::map <uint32_t, const Sample*> hostSamples {};
+
+  for ( const auto& sample : host.samples )
+    hostSamples[sample.frame] = &sample;
+
+
+  uint32_t compared {};
+  uint32_t diverged {};
+  uint32_t firstDiverged {};
+  float maxCoordsDifference {};
+  float maxDirDifference {};
+  double coordsDifferenceSum {};
+
+  for ( const auto& clientSample : client.samples )
+  {
+    const auto match = hostSamples.find(clientSample.frame);
+
+    if ( match == hostSamples.end() )
+      continue;
+
+    ++compared;
+
+    bool isDiverged {};
+
+    for ( size_t i {}; i < 2; ++i )
+    {
+      const auto& lhs = match->second->planes[i];
+      const auto& rhs = clientSample.planes[i];
+
+      float coordsDifference = std::max(
+        std::fabs(lhs.x - rhs.x),
+        std::fabs(lhs.y - rhs.y) );
+
+//  Pilot stays wherever it was last unless it's bailed out
+      const bool isPilotOut =
+        lhs.hasJumped == true && lhs.isDead == false &&
+        rhs.hasJumped == true && rhs.isDead == false;
+
+      if ( isPilotOut == true )
+        coordsDifference = std::max({
+          coordsDifference,
+          std::fabs(lhs.pilotX - rhs.pilotX),
+          std::fabs(lhs.pilotY - rhs.pilotY) });
+
+      const float dirDifference = angleDifference(lhs.dir, rhs.dir);
+
+      maxCoordsDifference = std::max(maxCoordsDifference, coordsDifference);
+      maxDirDifference = std::max(maxDirDifference, dirDifference);
+      coordsDifferenceSum += coordsDifference;
+
+      if (  coordsDifference > tolerance ||
+            lhs.hp != rhs.hp ||
+            lhs.score != rhs.score ||
+            lhs.isDead != rhs.isDead ||
+            lhs.hasJumped != rhs.hasJumped )
+        isDiverged = true;
+    }
+
+    if ( isDiverged == true && diverged++ == 0 )
+      firstDiverged = clientSample.frame;
+  }
+
+
+  std::printf( "compared %u sampled frames: %u diverged",
+    compared, diverged );
+
+  if ( diverged > 0 )
+    std::printf( " (first at frame %u)", firstDiverged );
+
+  std::printf( "\n" );
+
+  if ( compared > 0 )
+    std::printf( "coordinates difference: max %.5f, mean %.5f; direction difference: max %.2f\n",
+      maxCoordsDifference, coordsDifferenceSum / ( compared * 2 ),
+      maxDirDifference );
+
+  return compared > 0 && diverged == 0;
+}
+
+
+int
+main(
+  int argc,
+  char* args[] )
+{
+  NetsimOptions options {};
+
+  if ( parseOptions(argc, args, options) == false )
+  {
+    printUsage(args[0]);
+    return 1;
+  }
+
+  isVerbose = options.isVerbose;
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+
+  if ( options.conditions.empty() == false )
+  {
+    net::LinkConditioner conditioner {};
+
+    if ( conditioner.LoadConfig(options.conditions) == false )
+    {
+      std::fprintf( stderr, "Failed to load link conditions from '%s'\n",
+        options.conditions.c_str() );
+      return 1;
+    }
+
+    const auto& config = conditioner.GetConfig();
+
+    std::printf( "link: latency %.0f ms, jitter %.0f ms, loss %.1f%%, "
+      "duplicate %.1f%%, reorder %.1f%% by %.0f ms\n",
+      config.latency, config.jitter, config.loss,
+      config.duplicate, config.reorder, config.reorder_delay );
+  }
+
+
+  Peer host {};
+  Peer client {};
+
+  if (  startPeer(options, SRV_CLI::SERVER, host) == false ||
+        startPeer(options, SRV_CLI::CLIENT, client) == false )
+  {
+    std::fprintf( stderr, "Failed to start peers\n" );
+    return 1;
+  }
+
+  const bool isHostFinished = finishPeer(host);
+  const bool isClientFinished = finishPeer(client);
+
+  if ( isHostFinished == false || isClientFinished == false )
+  {
+    std::fprintf( stderr, "Peer failed\n" );
+    return 1;
+  }
+
+
+  printPeer("host", host.results);
+  printPeer("client", client.results);
+
+  if (  host.results.isConnected == false ||
+        client.results.isConnected == false )
+  {
+    std::printf( "FAIL: peers didn't finish the match\n" );
+    return 1;
+  }
+
+  if ( compareSamples(host, client, options.tolerance) == false )
+  {
+    std::printf( "FAIL: peers diverged\n" );
+    return 1;
+  }
+
+  std::printf( "OK\n" );
+
+  return 0;
+}
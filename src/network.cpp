@@ -20,10 +20,14 @@
 
 #include <include/network.hpp>
 #include <include/plane.hpp>
+#include <include/world.hpp>
+#include <include/constants.hpp>
 #include <include/controls.hpp>
 #include <include/game_state.hpp>
 #include <include/network_data.hpp>
 #include <include/network_state.hpp>
+#include <include/packet_codec.hpp>
+#include <include/rollback.hpp>
 #include <include/variables.hpp>
 
 #if defined(VITA_PLATFORM)
@@ -32,32 +36,35 @@
   #include <lib/Net.h>
 #endif
 
+#include <algorithm>
 #include <deque>
 
 
-static std::deque <unsigned char> eventsLocal( 32, 'n' );
-static bool eventsTickFinished {true};
+struct PendingEvent
+{
+  uint16_t id {};
+  NetworkEvent event {};
+};
+
+//  Local events waiting for opponent's ack
+static std::deque <PendingEvent> eventsLocal {};
+static uint16_t eventIdLocal {};
+static uint16_t eventIdUnsent {};
 
-static uint8_t eventCounterLocal {};
-static uint8_t eventCounterRemote {};
+//  Next opponent's event to apply
+static uint16_t eventIdRemote {};
 
 static bool sentGameParams {};
 
+static PacketCodec packetCodec {};
 
-Packet& operator << (
-  Packet& packet,
-  const Controls& controls )
-{
-  packet.throttle = controls.throttle;
-  packet.pitch    = controls.pitch;
-
-  return packet;
-}
 
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
 Packet& operator << (
   Packet& packet,
   const PlaneNetworkData& data )
 {
+  packet.hasState = true;
   packet.x       = data.x;
   packet.y       = data.y;
   packet.dir     = data.dir;
@@ -66,6 +73,7 @@ Packet& operator << (
 
   return packet;
 }
+#endif
 
 void
 sendDisconnectMessage()
@@ -74,34 +82,96 @@ sendDisconnectMessage()
   localData.disconnect = true;
   eventsPack(localData);
 
-  uint8_t packet[sizeof(Packet)];
-  memcpy( packet, &localData, sizeof(packet) );
-
-  networkState().connection->SendPacket(
-    packet, sizeof(packet) );
+  sendPacket(localData);
 }
 
 void
-eventPush(
-  const EVENTS newEvent )
+sendPacket(
+  const Packet& packet )
 {
-  if (  gameState().gameMode != GAME_MODE::HUMAN_VS_HUMAN ||
-        networkState().isOpponentConnected == false )
+  const auto connection = networkState().connection;
+
+  uint8_t data[PacketCodec::maxSize];
+
+  const auto size = packetCodec.Encode(
+    packet,
+    connection->GetReliabilitySystem().GetLocalSequence(),
+    data, sizeof(data) );
+
+  if ( size == 0 )
+  {
+    log_message("NETWORK: Failed to encode packet\n");
     return;
+  }
 
+  connection->SendPacket( data, size );
+}
+
+void
+flowControlInit(
+  net::FlowControl& flowControl )
+{
+  auto policy = flowControl.GetPolicy();
+
+  policy.max_send_rate = constants::packetSendRate;
+  policy.min_send_rate = constants::packetSendRateMin;
+
+  flowControl.SetPolicy(policy);
+}
+
+//  Skips packets with a baseline we never decoded,
+//  opponent moves to a newer one once we report it
+bool
+receivePacket(
+  Packet& packet )
+{
+  const auto connection = networkState().connection;
 
-  if ( eventsTickFinished == true )
+  while ( true )
   {
-    eventsLocal.pop_front();
-    eventsLocal.push_back(eventCounterLocal);
-    eventsTickFinished = false;
+//  Decoded straight from the socket's receive arena
+    int size {};
+    const auto data = connection->ReceivePacket(size);
+
+    if ( data == nullptr )
+      return false;
+
+    const auto sequence =
+      connection->GetReliabilitySystem().GetRemoteSequence();
 
-    if ( ++eventCounterLocal >= 64 )
-      eventCounterLocal = 0;
+    Packet decoded {};
+
+    if ( packetCodec.Decode( data, size, sequence, decoded ) == false )
+      continue;
+
+    packet = decoded;
+    return true;
   }
+}
+
+//  Ids wrap around, so they are compared by distance
+static int16_t
+eventIdDifference(
+  const uint16_t lhs,
+  const uint16_t rhs )
+{
+  return static_cast <int16_t> (lhs - rhs);
+}
+
+void
+eventPush(
+  const EVENTS newEvent )
+{
+  PendingEvent pending {};
+  pending.id = eventIdLocal++;
+  pending.event.type = newEvent;
+
+//  Simulation pushes events during the frame they happen in
+  pending.event.frame = rollbackFrame();
+
+  eventsLocal.push_back(pending);
 
-  eventsLocal.pop_front();
-  eventsLocal.push_back( (unsigned char) newEvent );
+  rollbackAddLocalEvent(newEvent);
 }
 
 void
@@ -124,40 +194,106 @@ eventsPack(
     sentGameParams = true;
   }
 
-  for ( uint8_t i = 0; i < sizeof(packet.events); i++ )
-    packet.events[i] = eventsLocal.at(i);
+
+//  Opponent applies events right after the frame they happened in,
+//  no matter which resend gets through. Ones pushed between frames
+//  belong to the last frame sent
+  for ( auto& pending : eventsLocal )
+    if ( eventIdDifference(pending.id, eventIdUnsent) >= 0 )
+      pending.event.frame = std::min(pending.event.frame, packet.frame);
+
+  eventIdUnsent = eventIdLocal;
+
+
+  const uint8_t eventCapacity =
+    sizeof(packet.events) / sizeof(packet.events[0]);
+
+  packet.eventId =
+    eventsLocal.empty() == false
+    ? eventsLocal.front().id
+    : eventIdLocal;
+
+  packet.eventCount = std::min(
+    eventsLocal.size(), size_t{eventCapacity} );
+
+  for ( uint8_t i {}; i < packet.eventCount; ++i )
+    packet.events[i] = eventsLocal[i].event;
+
+  packet.eventAck = eventIdRemote;
 }
 
 void
 eventsReset()
 {
-  eventCounterLocal = 0;
-  eventCounterRemote = 0;
-  eventsTickFinished = true;
+  eventsLocal.clear();
+  eventIdLocal = 0;
+  eventIdUnsent = 0;
+  eventIdRemote = 0;
   sentGameParams = false;
 
-  eventsLocal.clear();
-  eventsLocal.resize( 32, 'n' );
+  packetCodec.Reset();
 }
 
 void
-eventsNewTick()
+processOpponentData(
+  const Packet& opponentData )
 {
-  eventsTickFinished = true;
+  if ( opponentData.waiting == true )
+    return;
+
+  rollbackUnpackInputs(opponentData);
+
+//  Bit-exact physics stays in sync with inputs alone
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
+  if ( opponentData.hasState == true )
+  {
+    PlaneNetworkData data {};
+    data.x = opponentData.x;
+    data.y = opponentData.y;
+    data.dir = opponentData.dir;
+    data.pilot_x = opponentData.pilot_x;
+    data.pilot_y = opponentData.pilot_y;
+
+    rollbackAddRemoteState(opponentData.frame, data);
+  }
+#endif
+
+
+  while (  eventsLocal.empty() == false &&
+            eventIdDifference(eventsLocal.front().id, opponentData.eventAck) < 0 )
+    eventsLocal.pop_front();
+
+
+  for ( uint8_t i {}; i < opponentData.eventCount; ++i )
+  {
+    const uint16_t id = opponentData.eventId + i;
+    const auto idDifference = eventIdDifference(id, eventIdRemote);
+
+//  Already applied from an earlier packet
+    if ( idDifference < 0 )
+      continue;
+
+    if ( idDifference > 0 )
+    {
+      log_message("NETWORK: Events desynchronization detected!\n");
+      log_message("NETWORK: Expected opponent event " + std::to_string(eventIdRemote) + ", got " + std::to_string(id) + "\n");
+
+      break;
+    }
+
+    const auto& event = opponentData.events[i];
+
+    rollbackAddRemoteEvent(event.frame, event.type);
+    ++eventIdRemote;
+  }
 }
 
 void
-processOpponentData(
-  const Packet& opponentData,
-  const Packet& opponentDataPrev )
+applyOpponentEvent(
+  const EVENTS event )
 {
-  PlaneNetworkData data {};
-  data.dir = opponentData.dir;
-  data.pilot_x = opponentData.pilot_x;
-  data.pilot_y = opponentData.pilot_y;
-
-  auto& planeRed = planes.at(PLANE_TYPE::RED);
-  auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
+  auto& planeRed = world().planes.at(PLANE_TYPE::RED);
+  auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
 
   auto& planeLocal =
     planeRed.isLocal() == true
@@ -167,162 +303,85 @@ processOpponentData(
     planeRed.isLocal() == false
     ? planeRed : planeBlue;
 
-  planeRemote.setDir( data.dir );
-  planeRemote.pilot.setX( data.pilot_x );
-  planeRemote.pilot.setY( data.pilot_y );
 
+  switch ( event )
+  {
+    case EVENTS::NO_EXTRA_CLOUDS:
+    {
+      gameState().features.extraClouds = false;
+      break;
+    }
 
-  const bool eventsChanged = std::equal(
-    std::begin(opponentData.events),
-    std::end(opponentData.events),
-    std::begin(opponentDataPrev.events) ) == false;
+    case EVENTS::NO_ONESHOT_KILLS:
+    {
+      gameState().features.oneShotKills = false;
+      break;
+    }
 
-  if ( eventsChanged == true )
-  {
-    bool foundNewEventIndex {};
+    case EVENTS::NO_ALT_HITBOXES:
+    {
+      gameState().features.alternativeHitboxes = false;
+      break;
+    }
+
+//  Carried by input frames now
+    case EVENTS::SHOOT:
+    case EVENTS::EJECT:
+      break;
 
-    for ( uint8_t i = 0;
-          i < sizeof(opponentData.events);
-          ++i )
+    case EVENTS::HIT_PLANE:
     {
-      if ( foundNewEventIndex == false )
-      {
-        if ( opponentData.events[i] == eventCounterRemote )
-          foundNewEventIndex = true;
-
-        continue;
-      }
-
-      switch ( opponentData.events[i] )
-      {
-        case (uint8_t) EVENTS::NONE:
-        {
-          continue;
-        }
-
-        case (uint8_t) EVENTS::NO_EXTRA_CLOUDS:
-        {
-          gameState().features.extraClouds = false;
-          continue;
-        }
-
-        case (uint8_t) EVENTS::NO_ONESHOT_KILLS:
-        {
-          gameState().features.oneShotKills = false;
-          continue;
-        }
-
-        case (uint8_t) EVENTS::NO_ALT_HITBOXES:
-        {
-          gameState().features.alternativeHitboxes = false;
-          continue;
-        }
-
-        case (uint8_t) EVENTS::SHOOT:
-        {
-          planeRemote.input.Shoot();
-          continue;
-        }
-
-        case (uint8_t) EVENTS::EJECT:
-        {
-          planeRemote.input.Jump();
-          continue;
-        }
-
-        case (uint8_t) EVENTS::HIT_PLANE:
-        {
-          planeRemote.Hit(planeLocal);
-          continue;
-        }
-
-        case (uint8_t) EVENTS::HIT_CHUTE:
-        {
-          planeRemote.pilot.ChuteHit(planeLocal);
-          continue;
-        }
-
-        case (uint8_t) EVENTS::HIT_PILOT:
-        {
-          planeRemote.pilot.Kill(planeLocal);
-          continue;
-        }
-
-        case (uint8_t) EVENTS::PLANE_DEATH:
-        {
-          planeRemote.Crash();
-          continue;
-        }
-
-        case (uint8_t) EVENTS::PILOT_DEATH:
-        {
-          planeRemote.pilot.Death();
-
-          planeRemote.ScoreChange(-1);
-          planeRemote.mStats.falls++;
-
-          continue;
-        }
-
-        case (uint8_t) EVENTS::PLANE_RESPAWN:
-        {
-          planeRemote.Respawn();
-          continue;
-        }
-
-        case (uint8_t) EVENTS::PILOT_RESPAWN:
-        {
-          planeRemote.pilot.Rescue();
-          continue;
-        }
-
-        case (uint8_t) EVENTS::PILOT_LAND:
-        {
-          planeRemote.pilot.FallSurvive();
-          continue;
-        }
-
-        default:
-        {
-          if ( ++eventCounterRemote >= 64 )
-            eventCounterRemote = 0;
-
-          break;
-        }
-      }
+      planeRemote.Hit(planeLocal);
+      break;
     }
 
-    if ( foundNewEventIndex == true )
+    case EVENTS::HIT_CHUTE:
     {
-      if ( ++eventCounterRemote >= 64 )
-        eventCounterRemote = 0;
+      planeRemote.pilot.ChuteHit(planeLocal);
+      break;
     }
-    else
+
+    case EVENTS::HIT_PILOT:
     {
-      const std::string eventBufferStr
-      {
-        opponentData.events,
-        opponentData.events + sizeof(Packet::events)
-      };
-
-      const std::string emptyEventBufferStr(
-        sizeof(Packet::events), 'n' );
-
-      if ( eventBufferStr != emptyEventBufferStr )
-      {
-        log_message("NETWORK: Events desynchronization detected!\n");
-        log_message("NETWORK: Expected opponent event index " + std::to_string(eventCounterRemote) + "\n");
-        log_message("NETWORK: Opponent event buffer: '" + eventBufferStr + "'\n");
-      }
+      planeRemote.pilot.Kill(planeLocal);
+      break;
     }
-  }
 
-  if ( networkState().sendCoordsTimer.isReady() == false )
-    return;
+    case EVENTS::PLANE_DEATH:
+    {
+      planeRemote.Crash();
+      break;
+    }
 
+    case EVENTS::PILOT_DEATH:
+    {
+      planeRemote.pilot.Death();
 
-  data.x = opponentData.x;
-  data.y = opponentData.y;
+      planeRemote.ScoreChange(-1);
+      planeRemote.mStats.falls++;
 
-  planeRemote.setCoords(data);
+      break;
+    }
+
+    case EVENTS::PLANE_RESPAWN:
+    {
+      planeRemote.Respawn();
+      break;
+    }
+
+    case EVENTS::PILOT_RESPAWN:
+    {
+      planeRemote.pilot.Rescue();
+      break;
+    }
+
+    case EVENTS::PILOT_LAND:
+    {
+      planeRemote.pilot.FallSurvive();
+      break;
+    }
+
+    default:
+      break;
+  }
 }
@@ -0,0 +1,560 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/packet_codec.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+
+BitWriter::BitWriter(
+  uint8_t* data,
+  const size_t capacity )
+  : mData{data}
+  , mCapacity{capacity}
+{
+  std::memset(mData, 0, mCapacity);
+}
+
+//  Bits are stored least significant first, so
+//  the stream reads the same on any endianness
+void
+BitWriter::Write(
+  const uint32_t value,
+  const uint8_t bits )
+{
+  if ( mBitCount + bits > mCapacity * 8 )
+  {
+    mHasOverflowed = true;
+    return;
+  }
+
+  for ( uint8_t i {}; i < bits; ++i, ++mBitCount )
+    if ( ( value >> i ) & 1 )
+      mData[mBitCount / 8] |= 1 << ( mBitCount % 8 );
+}
+
+size_t
+BitWriter::byteCount() const
+{
+  return ( mBitCount + 7 ) / 8;
+}
+
+bool
+BitWriter::hasOverflowed() const
+{
+  return mHasOverflowed;
+}
+
+
+BitReader::BitReader(
+  const uint8_t* data,
+  const size_t size )
+  : mData{data}
+  , mSize{size}
+{
+}
+
+uint32_t
+BitReader::Read(
+  const uint8_t bits )
+{
+  if ( mBitCount + bits > mSize * 8 )
+  {
+    mHasOverflowed = true;
+    return 0;
+  }
+
+  uint32_t value {};
+
+  for ( uint8_t i {}; i < bits; ++i, ++mBitCount )
+    if ( ( mData[mBitCount / 8] >> ( mBitCount % 8 ) ) & 1 )
+      value |= uint32_t{1} << i;
+
+  return value;
+}
+
+bool
+BitReader::hasOverflowed() const
+{
+  return mHasOverflowed;
+}
+
+
+void
+PacketHistory::Reset()
+{
+  std::fill(
+    std::begin(mIsValid),
+    std::end(mIsValid),
+    false );
+}
+
+void
+PacketHistory::Store(
+  const uint32_t sequence,
+  const Packet& packet )
+{
+  const auto index = sequence % size;
+
+  mPackets[index] = packet;
+  mSequences[index] = sequence;
+  mIsValid[index] = true;
+}
+
+const Packet*
+PacketHistory::find(
+  const uint32_t sequence ) const
+{
+  const auto index = sequence % size;
+
+  if ( mIsValid[index] == false || mSequences[index] != sequence )
+    return nullptr;
+
+  return &mPackets[index];
+}
+
+//  History spans fewer than 256 sequences,
+//  so low bits identify a packet uniquely
+const Packet*
+PacketHistory::findLowBits(
+  const uint8_t sequenceLowBits,
+  uint32_t& sequence ) const
+{
+  for ( uint32_t i {}; i < size; ++i )
+  {
+    if ( mIsValid[i] == false )
+      continue;
+
+    if ( ( mSequences[i] & 0xFF ) != sequenceLowBits )
+      continue;
+
+    sequence = mSequences[i];
+    return &mPackets[i];
+  }
+
+  return nullptr;
+}
+
+
+namespace
+{
+
+constexpr uint8_t versionBits {4};
+constexpr uint8_t sequenceLowBits {8};
+constexpr uint8_t baselineDistanceBits {6};
+constexpr uint8_t frameDeltaBits {8};
+constexpr uint8_t inputBits {6};
+constexpr uint8_t eventIdBits {16};
+constexpr uint8_t eventCountBits {4};
+constexpr uint8_t eventTypeBits {7};
+constexpr uint8_t eventFrameDeltaBits {8};
+
+static_assert(
+  sizeof(Packet::events) / sizeof(Packet::events[0]) == 1 << eventCountBits );
+
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
+constexpr uint8_t quantizedBits {16};
+constexpr uint32_t quantizedMax {( 1 << quantizedBits ) - 1};
+
+//  Planes and pilots stay well within these bounds
+constexpr float positionMin {-1.0f};
+constexpr float positionMax {2.0f};
+
+constexpr float dirMin {0.0f};
+constexpr float dirMax {360.0f};
+
+
+uint32_t
+quantize(
+  const float value,
+  const float min,
+  const float max )
+{
+  const auto normalized =
+    ( std::clamp(value, min, max) - min ) / ( max - min );
+
+  return std::lround(normalized * quantizedMax);
+}
+
+float
+dequantize(
+  const uint32_t value,
+  const float min,
+  const float max )
+{
+  return min + ( max - min ) * value / quantizedMax;
+}
+
+//  Replaces floats with what the opponent will decode,
+//  so both sides hold identical baselines
+void
+quantize(
+  Packet& packet )
+{
+  const auto round =
+  [] ( float& value, const float min, const float max )
+  {
+    value = dequantize(quantize(value, min, max), min, max);
+  };
+
+  round(packet.x, positionMin, positionMax);
+  round(packet.y, positionMin, positionMax);
+  round(packet.dir, dirMin, dirMax);
+  round(packet.pilot_x, positionMin, positionMax);
+  round(packet.pilot_y, positionMin, positionMax);
+}
+
+//  Packets without state keep baseline's, so that
+//  both sides delta the next one against the same values
+void
+copyState(
+  Packet& packet,
+  const Packet& source )
+{
+  packet.x = source.x;
+  packet.y = source.y;
+  packet.dir = source.dir;
+  packet.pilot_x = source.pilot_x;
+  packet.pilot_y = source.pilot_y;
+}
+
+void
+writeFloat(
+  BitWriter& writer,
+  const float value,
+  const float baseline,
+  const float min,
+  const float max )
+{
+  const auto quantized = quantize(value, min, max);
+  const bool isChanged = quantized != quantize(baseline, min, max);
+
+  writer.Write(isChanged, 1);
+
+  if ( isChanged == true )
+    writer.Write(quantized, quantizedBits);
+}
+
+float
+readFloat(
+  BitReader& reader,
+  const float baseline,
+  const float min,
+  const float max )
+{
+  if ( reader.Read(1) == false )
+    return baseline;
+
+  return dequantize(reader.Read(quantizedBits), min, max);
+}
+#endif
+
+} // namespace
+
+
+void
+PacketCodec::Reset()
+{
+  mSent.Reset();
+  mReceived.Reset();
+
+  mHasBaseline = false;
+  mHasDecoded = false;
+}
+
+size_t
+PacketCodec::Encode(
+  const Packet& source,
+  const uint32_t sequence,
+  uint8_t* data,
+  const size_t capacity )
+{
+  Packet packet = source;
+
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
+  quantize(packet);
+#endif
+
+
+  const Packet* baseline {};
+  const auto baselineDistance = sequence - mBaselineSequence;
+
+  if (  mHasBaseline == true &&
+        baselineDistance > 0 &&
+        baselineDistance < ( 1u << baselineDistanceBits ) )
+    baseline = mSent.find(mBaselineSequence);
+
+
+  BitWriter writer {data, capacity};
+
+  writer.Write(version, versionBits);
+  writer.Write(packet.disconnect, 1);
+  writer.Write(packet.waiting, 1);
+
+  writer.Write(mHasDecoded, 1);
+
+  if ( mHasDecoded == true )
+    writer.Write(mDecodedSequence & 0xFF, sequenceLowBits);
+
+  writer.Write(baseline != nullptr, 1);
+
+  if ( baseline != nullptr )
+    writer.Write(baselineDistance, baselineDistanceBits);
+
+
+//  Frame advances steadily, so its delta is small
+  const auto frameDelta =
+    baseline != nullptr
+    ? packet.frame - baseline->frame
+    : uint32_t{1} << frameDeltaBits;
+
+  const bool isFrameDelta = frameDelta < ( 1u << frameDeltaBits );
+
+  writer.Write(isFrameDelta, 1);
+
+  if ( isFrameDelta == true )
+    writer.Write(frameDelta, frameDeltaBits);
+  else
+    writer.Write(packet.frame, 32);
+
+
+//  Inputs rarely change between frames. Each one is compared
+//  to the same frame in baseline if it's there, else to the
+//  previous frame
+  const uint8_t inputCount = sizeof(packet.inputs);
+
+  for ( uint8_t i {}; i < inputCount; ++i )
+  {
+    uint8_t reference {};
+
+    if ( isFrameDelta == true && i + frameDelta < inputCount )
+      reference = baseline->inputs[i + frameDelta];
+    else if ( i > 0 )
+      reference = packet.inputs[i - 1];
+
+    const bool isSame = packet.inputs[i] == reference;
+
+    writer.Write(isSame, 1);
+
+    if ( isSame == false )
+      writer.Write(packet.inputs[i], inputBits);
+  }
+
+
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
+  const Packet zeroes {};
+  const auto& floats = baseline != nullptr ? *baseline : zeroes;
+
+  writer.Write(packet.hasState, 1);
+
+  if ( packet.hasState == true )
+  {
+    writeFloat(writer, packet.x, floats.x, positionMin, positionMax);
+    writeFloat(writer, packet.y, floats.y, positionMin, positionMax);
+    writeFloat(writer, packet.dir, floats.dir, dirMin, dirMax);
+    writeFloat(writer, packet.pilot_x, floats.pilot_x, positionMin, positionMax);
+    writeFloat(writer, packet.pilot_y, floats.pilot_y, positionMin, positionMax);
+  }
+  else
+    copyState(packet, floats);
+#endif
+
+
+//  Events are only there until acked,
+//  so most packets carry none
+  const bool isEventAckSame =
+    baseline != nullptr &&
+    packet.eventAck == baseline->eventAck;
+
+  writer.Write(isEventAckSame, 1);
+
+  if ( isEventAckSame == false )
+    writer.Write(packet.eventAck, eventIdBits);
+
+  writer.Write(packet.eventCount > 0, 1);
+
+  if ( packet.eventCount > 0 )
+  {
+    writer.Write(packet.eventId, eventIdBits);
+    writer.Write(packet.eventCount - 1, eventCountBits);
+
+    for ( uint8_t i {}; i < packet.eventCount; ++i )
+    {
+      const auto& event = packet.events[i];
+      const auto frameDelta = packet.frame - event.frame;
+      const bool isFrameDelta = frameDelta < ( 1u << eventFrameDeltaBits );
+
+      writer.Write(static_cast <uint8_t> (event.type), eventTypeBits);
+      writer.Write(isFrameDelta, 1);
+
+      if ( isFrameDelta == true )
+        writer.Write(frameDelta, eventFrameDeltaBits);
+      else
+        writer.Write(event.frame, 32);
+    }
+  }
+
+
+  if ( writer.hasOverflowed() == true )
+    return 0;
+
+  mSent.Store(sequence, packet);
+
+  return writer.byteCount();
+}
+
+bool
+PacketCodec::Decode(
+  const uint8_t* data,
+  const size_t size,
+  const uint32_t sequence,
+  Packet& packet )
+{
+  BitReader reader {data, size};
+
+  if ( reader.Read(versionBits) != version )
+    return false;
+
+  packet = {};
+  packet.disconnect = reader.Read(1);
+  packet.waiting = reader.Read(1);
+
+
+  if ( reader.Read(1) == true )
+  {
+    uint32_t decodedSequence {};
+
+    const auto sequenceBits = reader.Read(sequenceLowBits);
+
+    if (  mSent.findLowBits(sequenceBits, decodedSequence) != nullptr &&
+          ( mHasBaseline == false ||
+            static_cast <int32_t> (decodedSequence - mBaselineSequence) > 0 ) )
+    {
+      mBaselineSequence = decodedSequence;
+      mHasBaseline = true;
+    }
+  }
+
+
+  const Packet* baseline {};
+
+  if ( reader.Read(1) == true )
+  {
+    baseline = mReceived.find(
+      sequence - reader.Read(baselineDistanceBits) );
+
+    if ( baseline == nullptr )
+      return false;
+  }
+
+
+  const bool isFrameDelta = reader.Read(1);
+  uint32_t frameDelta {};
+
+  if ( isFrameDelta == true )
+  {
+    if ( baseline == nullptr )
+      return false;
+
+    frameDelta = reader.Read(frameDeltaBits);
+    packet.frame = baseline->frame + frameDelta;
+  }
+  else
+    packet.frame = reader.Read(32);
+
+
+  const uint8_t inputCount = sizeof(packet.inputs);
+
+  for ( uint8_t i {}; i < inputCount; ++i )
+  {
+    if ( reader.Read(1) == false )
+    {
+      packet.inputs[i] = reader.Read(inputBits);
+      continue;
+    }
+
+    if ( isFrameDelta == true && i + frameDelta < inputCount )
+      packet.inputs[i] = baseline->inputs[i + frameDelta];
+    else if ( i > 0 )
+      packet.inputs[i] = packet.inputs[i - 1];
+  }
+
+
+#if !defined(BIPLANES_DETERMINISTIC_MATH)
+  const Packet zeroes {};
+  const auto& floats = baseline != nullptr ? *baseline : zeroes;
+
+  packet.hasState = reader.Read(1);
+
+  if ( packet.hasState == true )
+  {
+    packet.x = readFloat(reader, floats.x, positionMin, positionMax);
+    packet.y = readFloat(reader, floats.y, positionMin, positionMax);
+    packet.dir = readFloat(reader, floats.dir, dirMin, dirMax);
+    packet.pilot_x = readFloat(reader, floats.pilot_x, positionMin, positionMax);
+    packet.pilot_y = readFloat(reader, floats.pilot_y, positionMin, positionMax);
+  }
+  else
+    copyState(packet, floats);
+#endif
+
+
+  if ( reader.Read(1) == true )
+  {
+    if ( baseline == nullptr )
+      return false;
+
+    packet.eventAck = baseline->eventAck;
+  }
+  else
+    packet.eventAck = reader.Read(eventIdBits);
+
+  if ( reader.Read(1) == true )
+  {
+    packet.eventId = reader.Read(eventIdBits);
+    packet.eventCount = reader.Read(eventCountBits) + 1;
+
+    for ( uint8_t i {}; i < packet.eventCount; ++i )
+    {
+      auto& event = packet.events[i];
+
+      event.type = static_cast <EVENTS> (reader.Read(eventTypeBits));
+
+      if ( reader.Read(1) == true )
+        event.frame = packet.frame - reader.Read(eventFrameDeltaBits);
+      else
+        event.frame = reader.Read(32);
+    }
+  }
+
+
+  if ( reader.hasOverflowed() == true )
+    return false;
+
+  mReceived.Store(sequence, packet);
+
+  mDecodedSequence = sequence;
+  mHasDecoded = true;
+
+  return true;
+}
@@ -0,0 +1,291 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/perf_hud.hpp>
+#include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
+#include <include/constants.hpp>
+#include <include/network_state.hpp>
+#include <include/render.hpp>
+#include <include/bullet.hpp>
+#include <include/effects.hpp>
+#include <include/world.hpp>
+
+#if defined(VITA_PLATFORM)
+  #include <lib/Net-vita.h>
+#elif !defined(__EMSCRIPTEN__)
+  #include <lib/Net.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+
+class RollingSamples
+{
+  std::array <float, constants::perfHud::sampleCount> mSamples {};
+  size_t mCount {};
+  size_t mNext {};
+
+
+public:
+  RollingSamples() = default;
+
+  void Push( const float );
+  void Clear();
+
+  size_t count() const;
+
+//  Oldest sample first
+  float at( const size_t ) const;
+
+  float min() const;
+  float avg() const;
+  float max() const;
+};
+
+
+void
+RollingSamples::Push(
+  const float sample )
+{
+  mSamples[mNext] = sample;
+  mNext = (mNext + 1) % mSamples.size();
+  mCount = std::min(mCount + 1, mSamples.size());
+}
+
+void
+RollingSamples::Clear()
+{
+  mCount = 0;
+  mNext = 0;
+}
+
+size_t
+RollingSamples::count() const
+{
+  return mCount;
+}
+
+float
+RollingSamples::at(
+  const size_t index ) const
+{
+  return mSamples[(mNext + mSamples.size() - mCount + index) % mSamples.size()];
+}
+
+float
+RollingSamples::min() const
+{
+  if ( mCount == 0 )
+    return 0.f;
+
+  float result {at(0)};
+
+  for ( size_t i = 1; i < mCount; ++i )
+    result = std::min(result, at(i));
+
+  return result;
+}
+
+float
+RollingSamples::avg() const
+{
+  if ( mCount == 0 )
+    return 0.f;
+
+  double sum {};
+
+  for ( size_t i = 0; i < mCount; ++i )
+    sum += at(i);
+
+  return sum / mCount;
+}
+
+float
+RollingSamples::max() const
+{
+  if ( mCount == 0 )
+    return 0.f;
+
+  float result {at(0)};
+
+  for ( size_t i = 1; i < mCount; ++i )
+    result = std::max(result, at(i));
+
+  return result;
+}
+
+
+static RollingSamples frameTimes {};
+static RollingSamples tickTimes {};
+static RollingSamples tickCounts {};
+static RollingSamples drawCalls {};
+static RollingSamples bulletCounts {};
+static RollingSamples effectCounts {};
+
+static RollingSamples roundTripTimes {};
+static RollingSamples packetLosses {};
+static RollingSamples bandwidths {};
+
+
+void
+perf_hud_record(
+  const double frameTime,
+  const double tickTime,
+  const uint32_t ticks )
+{
+  frameTimes.Push(frameTime * 1000.0);
+  tickTimes.Push(tickTime * 1000.0);
+  tickCounts.Push(ticks);
+
+  drawCalls.Push(sprite_batch_stats().drawCalls);
+  bulletCounts.Push(world().bullets.count());
+  effectCounts.Push(world().effects.count());
+
+
+#if !defined(__EMSCRIPTEN__)
+  const auto& network = networkState();
+
+  if ( network.connection->IsConnected() == false )
+  {
+    roundTripTimes.Clear();
+    packetLosses.Clear();
+    bandwidths.Clear();
+
+    return;
+  }
+
+  const auto& reliability =
+    network.connection->GetReliabilitySystem();
+
+  roundTripTimes.Push(reliability.GetRoundTripTime() * 1000.f);
+  packetLosses.Push(network.flowControl->GetPacketLoss());
+  bandwidths.Push(reliability.GetSentBandwidth());
+#endif
+}
+
+
+static void
+draw_perf_graph(
+  const char label[],
+  const RollingSamples& samples,
+  const float y )
+{
+  namespace hud = constants::perfHud;
+  namespace colors = constants::colors::debug::perf;
+
+
+  const float maxTime = hud::graphMaxTime * 1000.0;
+  const float bottom = y + hud::graphSizeY;
+
+  setRenderColor(colors::graphSample);
+
+  for ( size_t i = 0; i < samples.count(); ++i )
+  {
+    const float x = hud::originX + i * hud::sampleSizeX;
+    const float height = std::min(samples.at(i) / maxTime, 1.f);
+
+    SDL_RenderDrawLineF(
+      gRenderer,
+      toWindowSpaceX(x),
+      toWindowSpaceY(bottom),
+      toWindowSpaceX(x),
+      toWindowSpaceY(bottom - height * hud::graphSizeY) );
+  }
+
+
+  const float budgetTime = 1000.f / constants::tickRate;
+  const float budgetY = bottom - budgetTime / maxTime * hud::graphSizeY;
+
+  setRenderColor(colors::tickBudget);
+  SDL_RenderDrawLineF(
+    gRenderer,
+    toWindowSpaceX(hud::originX),
+    toWindowSpaceY(budgetY),
+    toWindowSpaceX(hud::originX + hud::graphSizeX),
+    toWindowSpaceY(budgetY) );
+
+
+  const SDL_FRect border
+  {
+    toWindowSpaceX(hud::originX),
+    toWindowSpaceY(y),
+    scaleToScreenX(hud::graphSizeX),
+    scaleToScreenY(hud::graphSizeY),
+  };
+
+  setRenderColor(colors::graphBorder);
+  SDL_RenderDrawRectF(gRenderer, &border);
+
+  draw_text( label,
+    hud::originX + hud::graphLabelOffsetX,
+    y + hud::graphLabelOffsetY );
+}
+
+void
+draw_perf_hud()
+{
+  namespace hud = constants::perfHud;
+  namespace text = constants::text;
+
+
+  char row[32] {};
+  float y = hud::originY;
+
+  std::snprintf( row, sizeof(row),
+    "%-9s%6s%6s%6s", "", "min", "avg", "max" );
+
+  draw_text( row, hud::originX, y );
+  y += text::sizeY;
+
+
+  const auto drawRow =
+  [&row, &y] ( const char label[], const RollingSamples& samples )
+  {
+    if ( samples.count() == 0 )
+      return;
+
+    std::snprintf( row, sizeof(row),
+      "%-9s%6.1f%6.1f%6.1f",
+      label, samples.min(), samples.avg(), samples.max() );
+
+    draw_text( row, hud::originX, y );
+    y += text::sizeY;
+  };
+
+  drawRow( "frame ms", frameTimes );
+  drawRow( "tick ms", tickTimes );
+  drawRow( "ticks", tickCounts );
+  drawRow( "draws", drawCalls );
+  drawRow( "bullets", bulletCounts );
+  drawRow( "effects", effectCounts );
+  drawRow( "rtt ms", roundTripTimes );
+  drawRow( "loss %", packetLosses );
+  drawRow( "kbit/s", bandwidths );
+
+
+  y += hud::graphSpacingY;
+  draw_perf_graph( "frame", frameTimes, y );
+
+  y += hud::graphSizeY + hud::graphSpacingY;
+  draw_perf_graph( "tick", tickTimes, y );
+}
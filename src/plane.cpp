@@ -22,19 +22,16 @@
 #include <include/time.hpp>
 #include <include/constants.hpp>
 #include <include/game_state.hpp>
-#include <include/sdl.hpp>
-#include <include/render.hpp>
+#include <include/simulation.hpp>
+#include <include/sdl_rect.hpp>
 #include <include/cloud.hpp>
 #include <include/bullet.hpp>
 #include <include/math.hpp>
-#include <include/menu.hpp>
-#include <include/network.hpp>
 #include <include/network_data.hpp>
 #include <include/effects.hpp>
 #include <include/stats.hpp>
-#include <include/sounds.hpp>
-#include <include/textures.hpp>
-#include <include/variables.hpp>
+#include <include/world.hpp>
+#include <include/profiler.hpp>
 
 #include <lib/SDL_Vector.h>
 
@@ -50,13 +47,15 @@ Plane::Plane(
 void
 Plane::Update()
 {
+  PROFILE_ZONE("Plane::Update");
+
   if (  mIsDead == true &&
         mIsLocal == true &&
         mHasJumped == false &&
         mDeadCooldown.isReady() == true )
   {
     Respawn();
-    eventPush(EVENTS::PLANE_RESPAWN);
+    simNetEventPush(EVENTS::PLANE_RESPAWN);
   }
 
   SpeedUpdate();
@@ -76,136 +75,6 @@ Plane::Update()
   AnimationsUpdate();
 }
 
-void
-Plane::Draw() const
-{
-  namespace plane = constants::plane;
-
-
-  if ( mIsDead == true )
-    return;
-
-
-  const SDL_FRect planeRect
-  {
-    toWindowSpaceX(mX - 0.5f * plane::sizeX),
-    toWindowSpaceY(mY - 0.5f * plane::sizeY),
-    scaleToScreenX(plane::sizeX),
-    scaleToScreenY(plane::sizeY),
-  };
-
-  auto* planeTexture {textures.plane_blue};
-  double textureAngle {mDir - 90.0};
-
-  if ( mType == PLANE_TYPE::RED )
-  {
-    planeTexture = textures.plane_red;
-    textureAngle = mDir + 90.0;
-  }
-
-  if ( mProtection.isReady() == false )
-    SDL_SetTextureAlphaMod( planeTexture, 127 );
-
-  SDL_RenderCopyExF(
-    gRenderer,
-    planeTexture,
-    nullptr,
-    &planeRect,
-    textureAngle,
-    nullptr,
-    SDL_FLIP_NONE );
-
-  SDL_SetTextureAlphaMod( planeTexture, 255 );
-
-
-  DrawFire();
-}
-
-void
-Plane::DrawCollisionLayer() const
-{
-  namespace plane = constants::plane;
-  namespace colors = constants::colors::debug::collisions;
-
-  if ( mIsDead == true )
-    return;
-
-
-  const auto planeHitbox = Hitbox();
-
-  const SDL_FRect hitbox
-  {
-    toWindowSpaceX(planeHitbox.x),
-    toWindowSpaceY(planeHitbox.y),
-    scaleToScreenX(planeHitbox.w),
-    scaleToScreenY(planeHitbox.h),
-  };
-
-  setRenderColor(colors::planeToBullet);
-  SDL_RenderDrawRectF( gRenderer, &hitbox );
-
-
-  const SDL_FRect planeCenter
-  {
-    toWindowSpaceX(mX - 0.05f * plane::sizeX),
-    toWindowSpaceY(mY - 0.05f * plane::sizeY),
-    scaleToScreenX(0.1f * plane::sizeX),
-    scaleToScreenY(0.1f * plane::sizeY),
-  };
-
-  setRenderColor(colors::planeToObstacles);
-  SDL_RenderDrawRectF( gRenderer, &planeCenter );
-
-  const auto hitboxOffset = constants::plane::hitboxOffset;
-  const float dir = mDir * M_PI / 180.0f;
-
-  const SDL_Vector hitboxCenter
-  {
-    mX + hitboxOffset * std::sin(dir),
-    mY - hitboxOffset * std::cos(dir),
-  };
-
-  draw_circle(hitboxCenter.x, hitboxCenter.y, plane::hitboxRadius);
-}
-
-void
-Plane::DrawFire() const
-{
-  namespace fire = constants::fire;
-
-
-  if ( mHp > 0 )
-    return;
-
-
-  const SDL_FRect textureRect
-  {
-    toWindowSpaceX(mX - 0.5f * fire::sizeX),
-    toWindowSpaceY(mY - 0.5f * fire::sizeY),
-    scaleToScreenX(fire::sizeX),
-    scaleToScreenY(fire::sizeY),
-  };
-
-  const double textureAngle =
-    mType == PLANE_TYPE::RED
-    ? mDir + 90.0
-    : mDir - 90.0;
-
-  const auto textureFlip =
-    mType == PLANE_TYPE::BLUE
-    ? SDL_FLIP_NONE
-    : SDL_FLIP_HORIZONTAL;
-
-  SDL_RenderCopyExF(
-    gRenderer,
-    textures.anim_fire,
-    &textures.anim_fire_rect[mFireFrame],
-    &textureRect,
-    textureAngle,
-    nullptr,
-    textureFlip );
-}
-
 void
 Plane::Accelerate()
 {
@@ -296,27 +165,22 @@ Plane::Shoot()
         mProtection.isReady() == false )
     return;
 
-  if (  mIsLocal == true &&
-        mShootCooldown.isReady() == false )
+  if ( mShootCooldown.isReady() == false )
     return;
 
 
   mShootCooldown.Start();
 
-  panSound( playSound(sounds.shoot), mX );
+  simEventPush({SIM_EVENT::SHOT_FIRED, mType, mX});
 
   const auto bulletOffset = bulletSpawnOffset();
 
-  bullets.SpawnBullet(
+  world().bullets.SpawnBullet(
     mX + bulletOffset.x,
     mY + bulletOffset.y,
     mDir,
     mType );
 
-
-  if ( mIsLocal == true )
-    eventPush(EVENTS::SHOOT);
-
   if ( gameState().isRoundFinished == false )
     mStats.shots++;
 }
@@ -332,10 +196,6 @@ Plane::Jump()
 
   mHasJumped = true;
   pilot.Bail(mX, mY, jumpDir());
-
-
-  if ( mIsLocal == false )
-    pilot.ChuteUnlock();
 }
 
 
@@ -417,12 +277,14 @@ Plane::CoordinatesUpdate()
   const SDL_FPoint currentPos {mX, mY};
 
 //  Change coordinates
-  mX += mSpeed * std::sin( mDir * M_PI / 180.0f ) * deltaTime;
+  const auto direction = direction_vector(mDir);
+
+  mX += mSpeed * direction.x * deltaTime;
 
 
   if ( mIsOnGround == false )
   {
-    mY -= mSpeed * std::cos( mDir * M_PI / 180.0f ) * deltaTime;
+    mY += mSpeed * direction.y * deltaTime;
 
 //    Gravity
     if ( mSpeed < mMaxSpeedVar )
@@ -475,7 +337,7 @@ Plane::CollisionsUpdate()
         collidesWithGround == true )
   {
     Crash();
-    eventPush(EVENTS::PLANE_DEATH);
+    simNetEventPush(EVENTS::PLANE_DEATH);
   }
 }
 
@@ -578,7 +440,7 @@ Plane::SmokeUpdate()
 
   if ( mSmokeFrame < constants::smoke::frameCount )
   {
-    effects.Spawn(new SmokePuff{mX, mY});
+    world().effects.SpawnSmokePuff(mX, mY);
     mSmokeAnim.Start();
     ++mSmokeFrame;
   }
@@ -665,7 +527,7 @@ Plane::Hit(
     if ( mProtection.isReady() == false )
       return;
 
-    eventPush(EVENTS::HIT_PLANE);
+    simNetEventPush(EVENTS::HIT_PLANE);
   }
 
 
@@ -679,7 +541,7 @@ Plane::Hit(
 
   if ( mHp > 0 )
   {
-    panSound( playSound(sounds.hitPlane), mX );
+    simEventPush({SIM_EVENT::PLANE_HIT, mType, mX});
 
     --mHp;
 
@@ -717,10 +579,9 @@ Plane::Explode()
   namespace spark = constants::explosion::spark;
 
 
-  panSound( playSound(sounds.explosion), mX );
+  simEventPush({SIM_EVENT::PLANE_EXPLODED, mType, mX});
 
-  const auto sparkDirFactor =
-    std::sin(mDir * M_PI / 180.f);
+  const auto sparkDirFactor = direction_vector(mDir).x;
 
   const auto sparkSpeedFactor =
     mSpeed / constants::plane::maxSpeedBoosted;
@@ -742,7 +603,7 @@ Plane::Explode()
   mShootCooldown.Stop();
   mDeadCooldown.Start();
 
-  effects.Spawn(new Explosion{mX, mY});
+  world().effects.SpawnExplosion(mX, mY);
 
   for ( size_t i = 0; i < spark::count; ++i )
   {
@@ -760,10 +621,8 @@ Plane::Explode()
     const auto sparkSpeed =
       spark::speedMin + speedVariation * spark::speedRange;
 
-    const float sparkDir = dir * M_PI / 180.f;
-
-    effects.Spawn(new ExplosionSpark{
-      mX, mY, sparkSpeed, sparkDir });
+    world().effects.SpawnExplosionSpark(
+      mX, mY, sparkSpeed, dir );
   }
 
 
@@ -834,7 +693,7 @@ void
 Plane::ResetSpawnProtection()
 {
   const auto& opponentPlane =
-    planes.at(static_cast <PLANE_TYPE> (!mType));
+    world().planes.at(static_cast <PLANE_TYPE> (!mType));
 
   if (  opponentPlane.mIsOnGround == false &&
         opponentPlane.mIsDead == false )
@@ -867,7 +726,9 @@ Plane::ScoreChange(
 
 
   auto& opponentPlane =
-    planes.at(static_cast <PLANE_TYPE> (!mType));
+    world().planes.at(static_cast <PLANE_TYPE> (!mType));
+
+  SimEvent roundEvent {SIM_EVENT::ROUND_WON, mType, mX};
 
   if ( mIsLocal == true )
   {
@@ -875,42 +736,40 @@ Plane::ScoreChange(
     {
       if ( opponentPlane.isBot() == false )
       {
-        playSound(sounds.defeat);
-        menu.setMessage(MESSAGE_TYPE::GAME_LOST);
+        roundEvent.type = SIM_EVENT::ROUND_LOST;
+        roundEvent.message = MESSAGE_TYPE::GAME_LOST;
       }
       else
       {
-        playSound(sounds.victory);
-
         if ( mType == PLANE_TYPE::BLUE )
-          menu.setMessage(MESSAGE_TYPE::BLUE_SIDE_WON);
+          roundEvent.message = MESSAGE_TYPE::BLUE_SIDE_WON;
         else
-          menu.setMessage(MESSAGE_TYPE::RED_SIDE_WON);
+          roundEvent.message = MESSAGE_TYPE::RED_SIDE_WON;
 
 //      TODO: finish bot match
       }
     }
     else
     {
-      playSound(sounds.victory);
-
       if ( game.gameMode != GAME_MODE::HUMAN_VS_HUMAN_HOTSEAT )
-        menu.setMessage(MESSAGE_TYPE::GAME_WON);
+        roundEvent.message = MESSAGE_TYPE::GAME_WON;
       else
       {
         if ( mType == PLANE_TYPE::BLUE )
-          menu.setMessage(MESSAGE_TYPE::BLUE_SIDE_WON);
+          roundEvent.message = MESSAGE_TYPE::BLUE_SIDE_WON;
         else
-          menu.setMessage(MESSAGE_TYPE::RED_SIDE_WON);
+          roundEvent.message = MESSAGE_TYPE::RED_SIDE_WON;
       }
     }
   }
   else
   {
-    playSound(sounds.defeat);
-    menu.setMessage(MESSAGE_TYPE::GAME_LOST);
+    roundEvent.type = SIM_EVENT::ROUND_LOST;
+    roundEvent.message = MESSAGE_TYPE::GAME_LOST;
   }
 
+  simEventPush(roundEvent);
+
 
   mStats.wins++;
   opponentPlane.mStats.losses++;
@@ -971,12 +830,12 @@ Plane::isHit(
   }
 
   const auto hitboxOffset = constants::plane::hitboxOffset;
-  const float dir = mDir * M_PI / 180.0f;
+  const auto direction = direction_vector(mDir);
 
   const SDL_Vector hitboxCenter
   {
-    mX + hitboxOffset * std::sin(dir),
-    mY - hitboxOffset * std::cos(dir),
+    mX + hitboxOffset * direction.x,
+    mY + hitboxOffset * direction.y,
   };
 
   const auto distance =
@@ -1113,12 +972,12 @@ Plane::bulletSpawnOffset() const
 
 
   const auto offset = constants::plane::bulletSpawnOffset;
-  const float dir = mDir * M_PI / 180.0f;
+  const auto direction = direction_vector(mDir);
 
   return
   {
-    offset * std::sin(dir),
-    -offset * std::cos(dir),
+    offset * direction.x,
+    offset * direction.y,
   };
 }
 
@@ -0,0 +1,303 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/plane.hpp>
+#include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
+#include <include/constants.hpp>
+#include <include/render.hpp>
+#include <include/textures.hpp>
+
+#include <lib/SDL_Vector.h>
+
+#include <cmath>
+
+
+void
+Plane::Draw() const
+{
+  namespace plane = constants::plane;
+
+
+  if ( mIsDead == true )
+    return;
+
+
+  const SDL_FRect planeRect
+  {
+    toWindowSpaceX(mX - 0.5f * plane::sizeX),
+    toWindowSpaceY(mY - 0.5f * plane::sizeY),
+    scaleToScreenX(plane::sizeX),
+    scaleToScreenY(plane::sizeY),
+  };
+
+  auto* planeTexture {textures.plane_blue};
+  auto* planeTextureRect {&textures.plane_blue_rect};
+  double textureAngle {mDir - 90.0};
+
+  if ( mType == PLANE_TYPE::RED )
+  {
+    planeTexture = textures.plane_red;
+    planeTextureRect = &textures.plane_red_rect;
+    textureAngle = mDir + 90.0;
+  }
+
+  const uint8_t alpha =
+    mProtection.isReady() == false
+    ? 127 : 255;
+
+  sprite_batch_draw_ex(
+    planeTexture,
+    planeTextureRect,
+    planeRect,
+    textureAngle,
+    SDL_FLIP_NONE,
+    alpha );
+
+
+  DrawFire();
+}
+
+void
+Plane::DrawCollisionLayer() const
+{
+  namespace plane = constants::plane;
+  namespace colors = constants::colors::debug::collisions;
+
+  if ( mIsDead == true )
+    return;
+
+
+  const auto planeHitbox = Hitbox();
+
+  const SDL_FRect hitbox
+  {
+    toWindowSpaceX(planeHitbox.x),
+    toWindowSpaceY(planeHitbox.y),
+    scaleToScreenX(planeHitbox.w),
+    scaleToScreenY(planeHitbox.h),
+  };
+
+  setRenderColor(colors::planeToBullet);
+  SDL_RenderDrawRectF( gRenderer, &hitbox );
+
+
+  const SDL_FRect planeCenter
+  {
+    toWindowSpaceX(mX - 0.05f * plane::sizeX),
+    toWindowSpaceY(mY - 0.05f * plane::sizeY),
+    scaleToScreenX(0.1f * plane::sizeX),
+    scaleToScreenY(0.1f * plane::sizeY),
+  };
+
+  setRenderColor(colors::planeToObstacles);
+  SDL_RenderDrawRectF( gRenderer, &planeCenter );
+
+  const auto hitboxOffset = constants::plane::hitboxOffset;
+  const float dir = mDir * M_PI / 180.0f;
+
+  const SDL_Vector hitboxCenter
+  {
+    mX + hitboxOffset * std::sin(dir),
+    mY - hitboxOffset * std::cos(dir),
+  };
+
+  draw_circle(hitboxCenter.x, hitboxCenter.y, plane::hitboxRadius);
+}
+
+void
+Plane::DrawFire() const
+{
+  namespace fire = constants::fire;
+
+
+  if ( mHp > 0 )
+    return;
+
+
+  const SDL_FRect textureRect
+  {
+    toWindowSpaceX(mX - 0.5f * fire::sizeX),
+    toWindowSpaceY(mY - 0.5f * fire::sizeY),
+    scaleToScreenX(fire::sizeX),
+    scaleToScreenY(fire::sizeY),
+  };
+
+  const double textureAngle =
+    mType == PLANE_TYPE::RED
+    ? mDir + 90.0
+    : mDir - 90.0;
+
+  const auto textureFlip =
+    mType == PLANE_TYPE::BLUE
+    ? SDL_FLIP_NONE
+    : SDL_FLIP_HORIZONTAL;
+
+  sprite_batch_draw_ex(
+    textures.anim_fire,
+    &textures.anim_fire_rect[mFireFrame],
+    textureRect,
+    textureAngle,
+    textureFlip );
+}
+
+
+void
+Plane::Pilot::Draw() const
+{
+  namespace pilot = constants::pilot;
+  namespace chute = pilot::chute;
+  namespace angel = pilot::angel;
+
+
+  if ( plane->hasJumped() == false )
+    return;
+
+
+  if ( mIsDead == true )
+  {
+    const SDL_FRect angelRect
+    {
+      toWindowSpaceX(mX - 0.5f * angel::sizeX),
+      toWindowSpaceY(mY - 0.5f * angel::sizeY),
+      scaleToScreenX(angel::sizeX),
+      scaleToScreenY(angel::sizeY),
+    };
+
+    sprite_batch_draw(
+      textures.anim_pilot_angel,
+      &textures.anim_pilot_angel_rect[mAngelFrame],
+      angelRect );
+
+    return;
+  }
+
+
+  if ( mIsChuteOpen == true )
+  {
+    const SDL_FRect chuteRect
+    {
+      toWindowSpaceX(mX - 0.5f * chute::sizeX),
+      toWindowSpaceY(mY - chute::offsetY),
+      scaleToScreenX(chute::sizeX),
+      scaleToScreenY(chute::sizeY),
+    };
+
+    sprite_batch_draw(
+      textures.anim_chute,
+      &textures.anim_chute_rect[mChuteState],
+      chuteRect );
+  }
+
+
+  const SDL_FRect pilotRect
+  {
+    toWindowSpaceX(mX - 0.5f * pilot::sizeX),
+    toWindowSpaceY(mY - 0.5f * pilot::sizeY),
+    scaleToScreenX(pilot::sizeX),
+    scaleToScreenY(pilot::sizeY),
+  };
+
+  if ( mIsRunning == true )
+  {
+    auto* const pilotTexture =
+      plane->mType == PLANE_TYPE::RED
+      ? textures.anim_pilot_run_red
+      : textures.anim_pilot_run_blue;
+
+    const auto& pilotFrameRect =
+      plane->mType == PLANE_TYPE::RED
+      ? textures.anim_pilot_run_red_rect[mRunFrame]
+      : textures.anim_pilot_run_blue_rect[mRunFrame];
+
+    if ( mDir == 270 )
+    {
+      sprite_batch_draw(
+        pilotTexture,
+        &pilotFrameRect,
+        pilotRect );
+    }
+    else
+    {
+      sprite_batch_draw_ex(
+        pilotTexture,
+        &pilotFrameRect,
+        pilotRect,
+        0.0,
+        SDL_FLIP_HORIZONTAL );
+    }
+  }
+  else
+  {
+    auto* const pilotTexture =
+      plane->mType == PLANE_TYPE::RED
+      ? textures.anim_pilot_fall_red
+      : textures.anim_pilot_fall_blue;
+
+    const auto& pilotFrameRect =
+      plane->mType == PLANE_TYPE::RED
+      ? textures.anim_pilot_fall_red_rect[mFallFrame]
+      : textures.anim_pilot_fall_blue_rect[mFallFrame];
+
+    sprite_batch_draw(
+      pilotTexture,
+      &pilotFrameRect,
+      pilotRect );
+  }
+}
+
+void
+Plane::Pilot::DrawCollisionLayer() const
+{
+  namespace colors = constants::colors::debug::collisions;
+
+  if ( mIsDead == true || plane->mHasJumped == false )
+    return;
+
+
+  if ( mIsChuteOpen == true )
+  {
+    const auto chuteHitbox = ChuteHitbox();
+
+    const SDL_FRect hitbox
+    {
+      toWindowSpaceX(chuteHitbox.x),
+      toWindowSpaceY(chuteHitbox.y),
+      scaleToScreenX(chuteHitbox.w),
+      scaleToScreenY(chuteHitbox.h),
+    };
+
+    setRenderColor(colors::bulletToChute);
+    SDL_RenderDrawRectF( gRenderer, &hitbox );
+  }
+
+  const auto pilotHitbox = Hitbox();
+
+  const SDL_FRect hitbox
+  {
+    toWindowSpaceX(pilotHitbox.x),
+    toWindowSpaceY(pilotHitbox.y),
+    scaleToScreenX(pilotHitbox.w),
+    scaleToScreenY(pilotHitbox.h),
+  };
+
+  setRenderColor(colors::pilotToBullet);
+  SDL_RenderDrawRectF( gRenderer, &hitbox );
+}
@@ -46,8 +46,7 @@ Plane::Input::TurnLeft()
 {
   if ( plane->mHasJumped == true )
     plane->pilot.Move(PLANE_PITCH::PITCH_LEFT);
-
-  else if ( plane->mIsLocal == true )
+  else
     plane->Turn(PLANE_PITCH::PITCH_LEFT);
 }
 
@@ -56,8 +55,7 @@ Plane::Input::TurnRight()
 {
   if ( plane->mHasJumped == true )
     plane->pilot.Move(PLANE_PITCH::PITCH_RIGHT);
-
-  else if ( plane->mIsLocal == true )
+  else
     plane->Turn(PLANE_PITCH::PITCH_RIGHT);
 }
 
@@ -19,17 +19,15 @@
 */
 
 #include <include/plane.hpp>
-#include <include/sdl.hpp>
+#include <include/sdl_rect.hpp>
 #include <include/enums.hpp>
 #include <include/time.hpp>
 #include <include/timer.hpp>
 #include <include/constants.hpp>
 #include <include/game_state.hpp>
+#include <include/simulation.hpp>
 #include <include/math.hpp>
-#include <include/network.hpp>
 #include <include/cloud.hpp>
-#include <include/sounds.hpp>
-#include <include/textures.hpp>
 
 #include <cmath>
 
@@ -43,7 +41,6 @@ Plane::Pilot::setPlane(
   Plane* parentPlane )
 {
   plane = parentPlane;
-  mAudioLoopChannel = plane->type();
 }
 
 void
@@ -54,145 +51,6 @@ Plane::Pilot::Update()
   DeathUpdate();
 }
 
-void
-Plane::Pilot::Draw() const
-{
-  namespace pilot = constants::pilot;
-  namespace chute = pilot::chute;
-  namespace angel = pilot::angel;
-
-
-  if ( plane->hasJumped() == false )
-    return;
-
-
-  if ( mIsDead == true )
-  {
-    const SDL_FRect angelRect
-    {
-      toWindowSpaceX(mX - 0.5f * angel::sizeX),
-      toWindowSpaceY(mY - 0.5f * angel::sizeY),
-      scaleToScreenX(angel::sizeX),
-      scaleToScreenY(angel::sizeY),
-    };
-
-    SDL_RenderCopyF(
-      gRenderer,
-      textures.anim_pilot_angel,
-      &textures.anim_pilot_angel_rect[mAngelFrame],
-      &angelRect );
-
-    return;
-  }
-
-
-  if ( mIsChuteOpen == true )
-  {
-    const SDL_FRect chuteRect
-    {
-      toWindowSpaceX(mX - 0.5f * chute::sizeX),
-      toWindowSpaceY(mY - chute::offsetY),
-      scaleToScreenX(chute::sizeX),
-      scaleToScreenY(chute::sizeY),
-    };
-
-    SDL_RenderCopyF(
-      gRenderer,
-      textures.anim_chute,
-      &textures.anim_chute_rect[mChuteState],
-      &chuteRect );
-  }
-
-
-  const SDL_FRect pilotRect
-  {
-    toWindowSpaceX(mX - 0.5f * pilot::sizeX),
-    toWindowSpaceY(mY - 0.5f * pilot::sizeY),
-    scaleToScreenX(pilot::sizeX),
-    scaleToScreenY(pilot::sizeY),
-  };
-
-  if ( mIsRunning == true )
-  {
-    auto* const pilotTexture =
-      plane->mType == PLANE_TYPE::RED
-      ? textures.anim_pilot_run_red
-      : textures.anim_pilot_run_blue;
-
-    if ( mDir == 270 )
-    {
-      SDL_RenderCopyF(
-        gRenderer,
-        pilotTexture,
-        &textures.anim_pilot_run_rect[mRunFrame],
-        &pilotRect );
-    }
-    else
-    {
-      SDL_RenderCopyExF(
-        gRenderer,
-        pilotTexture,
-        &textures.anim_pilot_run_rect[mRunFrame],
-        &pilotRect,
-        0.0,
-        nullptr,
-        SDL_FLIP_HORIZONTAL );
-    }
-  }
-  else
-  {
-    auto* const pilotTexture =
-      plane->mType == PLANE_TYPE::RED
-      ? textures.anim_pilot_fall_red
-      : textures.anim_pilot_fall_blue;
-
-    SDL_RenderCopyF(
-      gRenderer,
-      pilotTexture,
-      &textures.anim_pilot_fall_rect[mFallFrame],
-      &pilotRect );
-  }
-}
-
-void
-Plane::Pilot::DrawCollisionLayer() const
-{
-  namespace colors = constants::colors::debug::collisions;
-
-  if ( mIsDead == true || plane->mHasJumped == false )
-    return;
-
-
-  if ( mIsChuteOpen == true )
-  {
-    const auto chuteHitbox = ChuteHitbox();
-
-    const SDL_FRect hitbox
-    {
-      toWindowSpaceX(chuteHitbox.x),
-      toWindowSpaceY(chuteHitbox.y),
-      scaleToScreenX(chuteHitbox.w),
-      scaleToScreenY(chuteHitbox.h),
-    };
-
-    setRenderColor(colors::bulletToChute);
-    SDL_RenderDrawRectF( gRenderer, &hitbox );
-  }
-
-  const auto pilotHitbox = Hitbox();
-
-  const SDL_FRect hitbox
-  {
-    toWindowSpaceX(pilotHitbox.x),
-    toWindowSpaceY(pilotHitbox.y),
-    scaleToScreenX(pilotHitbox.w),
-    scaleToScreenY(pilotHitbox.h),
-  };
-
-  setRenderColor(colors::pilotToBullet);
-  SDL_RenderDrawRectF( gRenderer, &hitbox );
-}
-
 void
 Plane::Pilot::Move(
   const PLANE_PITCH inputDir )
@@ -256,24 +114,22 @@ Plane::Pilot::Bail(
   namespace pilot = constants::pilot;
 
 
-  stopSound(mAudioLoopChannel);
+  simEventPush({SIM_EVENT::PILOT_BAILED, plane->mType, planeX});
 
   mX = planeX;
   mY = planeY;
   mDir = clamp_angle(bailDir, 360.f);
 
   mGravity = pilot::gravity;
-  mSpeed.x =  pilot::ejectSpeed * std::sin(mDir * M_PI / 180.0);
-  mSpeed.y = -pilot::ejectSpeed * std::cos(mDir * M_PI / 180.0);
+  const auto direction = direction_vector(mDir);
+
+  mSpeed.x = pilot::ejectSpeed * direction.x;
+  mSpeed.y = pilot::ejectSpeed * direction.y;
   mMoveSpeed = 0.0f;
 
 
   if ( gameState().isRoundFinished == false )
-    plane->mStats.jumps++;
-
-  if ( plane->mIsLocal == true )
-    eventPush(EVENTS::EJECT);
-}
+    plane->mStats.jumps++;}
 
 void
 Plane::Pilot::OpenChute()
@@ -289,11 +145,7 @@ Plane::Pilot::OpenChute()
   mGravity = constants::pilot::gravity;
 
   if ( mSpeed.y < 0.0f )
-    mSpeed.y = constants::pilot::chute::baseSpeedY;
-
-  if ( plane->mIsLocal == true )
-    eventPush(EVENTS::EJECT);
-}
+    mSpeed.y = constants::pilot::chute::baseSpeedY;}
 
 void
 Plane::Pilot::ChuteUnlock()
@@ -439,7 +291,7 @@ Plane::Pilot::DeathUpdate()
     if ( plane->mIsLocal == true )
     {
       plane->Respawn();
-      eventPush(EVENTS::PLANE_RESPAWN);
+      simNetEventPush(EVENTS::PLANE_RESPAWN);
     }
 
     return;
@@ -562,9 +414,7 @@ Plane::Pilot::ChuteHitbox() const
 void
 Plane::Pilot::FadeFallingSound()
 {
-  Mix_FadeOutChannel(
-    mAudioLoopChannel,
-    constants::audioFadeDuration );
+  simEventPush({SIM_EVENT::PILOT_FALL_ENDED, plane->mType, mX});
 }
 
 void
@@ -572,17 +422,15 @@ Plane::Pilot::PlayFallingSound()
 {
   if (  plane->hasJumped() == false ||
         mIsDead == true ||
-        mIsRunning == true ||
-        mAudioLoopChannel == -1 )
+        mIsRunning == true )
     return;
 
 
-  const auto soundToPlay = mIsChuteOpen == true
-    ? sounds.pilotChuteLoop
-    : sounds.pilotFallLoop;
+  const auto fallEvent = mIsChuteOpen == true
+    ? SIM_EVENT::PILOT_CHUTE_FALLING
+    : SIM_EVENT::PILOT_FALLING;
 
-  loopSound(soundToPlay, mAudioLoopChannel);
-  panSound(mAudioLoopChannel, mX);
+  simEventPush({fallEvent, plane->mType, mX});
 }
 
 float
@@ -629,7 +477,7 @@ void
 Plane::Pilot::ChuteHit(
   Plane& attacker )
 {
-  panSound( playSound(sounds.hitChute), mX );
+  simEventPush({SIM_EVENT::PILOT_CHUTE_HIT, plane->mType, mX});
 
   mChuteState = CHUTE_STATE::CHUTE_DESTROYED;
   mIsChuteOpen = false;
@@ -645,7 +493,7 @@ Plane::Pilot::Death()
 {
   FadeFallingSound();
 
-  panSound( playSound(sounds.pilotDeath), mX );
+  simEventPush({SIM_EVENT::PILOT_DIED, plane->mType, mX});
 
   mIsRunning = false;
   mIsChuteOpen = false;
@@ -690,7 +538,7 @@ Plane::Pilot::HitGroundCheck()
     FallSurvive();
 
     if ( plane->mIsLocal == true )
-      eventPush(EVENTS::PILOT_LAND);
+      simNetEventPush(EVENTS::PILOT_LAND);
 
     return;
   }
@@ -707,7 +555,7 @@ Plane::Pilot::HitGroundCheck()
   if ( gameState().isRoundFinished == false )
     plane->mStats.falls++;
 
-  eventPush(EVENTS::PILOT_DEATH);
+  simNetEventPush(EVENTS::PILOT_DEATH);
 }
 
 void
@@ -731,13 +579,13 @@ Plane::Pilot::Rescue()
 {
   plane->Respawn();
 
-  panSound( playSound(sounds.pilotRescue), plane->mX );
+  simEventPush({SIM_EVENT::PILOT_RESCUED, plane->mType, plane->mX});
 
   if ( gameState().isRoundFinished  == false )
     plane->mStats.rescues++;
 
   if ( plane->mIsLocal == true )
-    eventPush(EVENTS::PILOT_RESPAWN);
+    simNetEventPush(EVENTS::PILOT_RESPAWN);
 }
 
 void
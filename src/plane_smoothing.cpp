@@ -0,0 +1,259 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/plane_smoothing.hpp>
+#include <include/constants.hpp>
+#include <include/plane.hpp>
+#include <include/network_data.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+//  Planes and pilots wrap around the screen horizontally
+static float
+wrappedDelta(
+  const float from,
+  const float to )
+{
+  return std::remainder(to - from, 1.0f);
+}
+
+static float
+wrap(
+  const float x )
+{
+  return std::fmod( std::fmod(x, 1.0f) + 1.0f, 1.0f );
+}
+
+
+void
+PlaneSmoothing::setConfig(
+  const Config& config )
+{
+  mConfig = config;
+}
+
+const PlaneSmoothing::Config&
+PlaneSmoothing::config() const
+{
+  return mConfig;
+}
+
+void
+PlaneSmoothing::Reset()
+{
+  mStateCount = 0;
+  mNewest = 0;
+
+  mError = {};
+  mErrorTime = 0.0;
+}
+
+const PlaneSmoothing::State&
+PlaneSmoothing::state(
+  const size_t age ) const
+{
+  return mStates[( mNewest + mStates.size() - age ) % mStates.size()];
+}
+
+PlaneSmoothing::Position
+PlaneSmoothing::sample(
+  const double time ) const
+{
+  const auto& newest = state(0);
+
+  if ( time >= newest.time )
+  {
+    const auto elapsed = std::min(
+      time - newest.time, mConfig.extrapolationLimit );
+
+    const auto ticks = static_cast <float> (elapsed * constants::tickRate);
+
+    return
+    {
+      newest.x + newest.speedX * ticks,
+      newest.y + newest.speedY * ticks,
+      newest.pilotX,
+      newest.pilotY,
+    };
+  }
+
+
+  for ( size_t age = 1; age < mStateCount; ++age )
+  {
+    const auto& from = state(age);
+
+    if ( time < from.time )
+      continue;
+
+    const auto& to = state(age - 1);
+
+    const auto factor = static_cast <float> (
+      ( time - from.time ) / ( to.time - from.time ) );
+
+    return
+    {
+      from.x + wrappedDelta(from.x, to.x) * factor,
+      from.y + ( to.y - from.y ) * factor,
+      from.pilotX + wrappedDelta(from.pilotX, to.pilotX) * factor,
+      from.pilotY + ( to.pilotY - from.pilotY ) * factor,
+    };
+  }
+
+
+  const auto& oldest = state(mStateCount - 1);
+
+  return
+  {
+    oldest.x,
+    oldest.y,
+    oldest.pilotX,
+    oldest.pilotY,
+  };
+}
+
+PlaneSmoothing::Position
+PlaneSmoothing::error(
+  const double time ) const
+{
+  if ( mConfig.errorHalfLife <= 0.0 )
+    return {};
+
+
+  const auto factor = static_cast <float> (std::exp2(
+    -std::max(time - mErrorTime, 0.0) / mConfig.errorHalfLife ));
+
+  return
+  {
+    mError.x * factor,
+    mError.y * factor,
+    mError.pilotX * factor,
+    mError.pilotY * factor,
+  };
+}
+
+void
+PlaneSmoothing::Update(
+  const Plane& plane,
+  const uint32_t frame,
+  const double time )
+{
+  if ( mStateCount > 0 && state(0).frame == frame )
+    return;
+
+
+  State newState {};
+  newState.time = time;
+  newState.frame = frame;
+  newState.x = plane.x();
+  newState.y = plane.y();
+  newState.pilotX = plane.pilot.x();
+  newState.pilotY = plane.pilot.y();
+  newState.speedX = plane.speedVector().x;
+  newState.speedY = plane.speedVector().y;
+  newState.isVisible = plane.isDead() == false;
+  newState.hasJumped = plane.hasJumped();
+
+
+//  Respawns, bail outs and new rounds aren't smoothed
+  const bool isContinuous =
+    mStateCount > 0 &&
+    state(0).isVisible == newState.isVisible &&
+    state(0).hasJumped == newState.hasJumped &&
+    frame > state(0).frame;
+
+  const auto drawTime = time - mConfig.interpolationDelay;
+
+  Position drawnBefore {};
+
+  if ( isContinuous == true )
+  {
+    const auto sampled = sample(drawTime);
+    const auto offset = error(drawTime);
+
+    drawnBefore =
+    {
+      sampled.x + offset.x,
+      sampled.y + offset.y,
+      sampled.pilotX + offset.pilotX,
+      sampled.pilotY + offset.pilotY,
+    };
+  }
+  else
+    mStateCount = 0;
+
+
+  mNewest = ( mNewest + 1 ) % mStates.size();
+  mStates[mNewest] = newState;
+  mStateCount = std::min(mStateCount + 1, mStates.size());
+
+
+//  Whatever jump the new state makes becomes the offset to fade out
+  mError = {};
+  mErrorTime = drawTime;
+
+  if ( isContinuous == false )
+    return;
+
+
+  const auto drawnAfter = sample(drawTime);
+
+  const Position newError
+  {
+    wrappedDelta(drawnAfter.x, drawnBefore.x),
+    drawnBefore.y - drawnAfter.y,
+    wrappedDelta(drawnAfter.pilotX, drawnBefore.pilotX),
+    drawnBefore.pilotY - drawnAfter.pilotY,
+  };
+
+  const bool isSnapped =
+    std::hypot(newError.x, newError.y) > mConfig.snapDistance ||
+    std::hypot(newError.pilotX, newError.pilotY) > mConfig.snapDistance;
+
+  if ( isSnapped == false )
+    mError = newError;
+}
+
+Plane
+PlaneSmoothing::Apply(
+  const Plane& plane,
+  const double time ) const
+{
+  Plane drawn = plane;
+
+  if ( mStateCount == 0 )
+    return drawn;
+
+
+  const auto drawTime = time - mConfig.interpolationDelay;
+  const auto sampled = sample(drawTime);
+  const auto offset = error(drawTime);
+
+  PlaneNetworkData coords {};
+  coords.x = wrap(sampled.x + offset.x);
+  coords.y = sampled.y + offset.y;
+
+  drawn.setCoords(coords);
+  drawn.pilot.setX(wrap(sampled.pilotX + offset.pilotX));
+  drawn.pilot.setY(sampled.pilotY + offset.pilotY);
+
+  return drawn;
+}
@@ -0,0 +1,180 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#if defined(BIPLANES_PROFILER_ENABLED)
+
+#include <include/profiler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+//  Roughly the last 20 seconds of the game loop
+static constexpr size_t zoneCapacity {1 << 16};
+
+
+struct ProfilerRecord
+{
+  const char* name {};
+  int64_t start {};
+  int64_t end {};
+};
+
+struct ProfilerThread
+{
+  std::vector <ProfilerRecord> records {};
+  uint64_t recordCount {};
+
+  const char* name {};
+  uint32_t id {};
+};
+
+
+static const auto profilerEpoch = std::chrono::steady_clock::now();
+
+static std::mutex profilerThreadsMutex {};
+static std::vector <std::unique_ptr <ProfilerThread>> profilerThreads {};
+
+//  Owned by profilerThreads, outlives its thread
+static thread_local ProfilerThread* currentThread {};
+
+
+static int64_t
+profilerNow()
+{
+  return std::chrono::duration_cast <std::chrono::nanoseconds> (
+    std::chrono::steady_clock::now() - profilerEpoch ).count();
+}
+
+static ProfilerThread&
+profilerThread()
+{
+  if ( currentThread != nullptr )
+    return *currentThread;
+
+
+  auto thread = std::make_unique <ProfilerThread> ();
+  thread->records.resize(zoneCapacity);
+
+  const std::lock_guard <std::mutex> lock {profilerThreadsMutex};
+
+  thread->id = profilerThreads.size() + 1;
+  currentThread = thread.get();
+  profilerThreads.push_back(std::move(thread));
+
+  return *currentThread;
+}
+
+
+ProfilerZone::ProfilerZone(
+  const char* name )
+  : mName{name}
+  , mStart{profilerNow()}
+{
+}
+
+ProfilerZone::~ProfilerZone()
+{
+  auto& thread = profilerThread();
+
+  thread.records[thread.recordCount % zoneCapacity] =
+    {mName, mStart, profilerNow()};
+
+  ++thread.recordCount;
+}
+
+
+void
+profiler_set_thread_name(
+  const char* name )
+{
+  profilerThread().name = name;
+}
+
+bool
+profiler_write_trace(
+  const std::string& path )
+{
+  std::ofstream trace {path, std::ios::trunc};
+
+  if ( trace.is_open() == false )
+    return false;
+
+
+  const std::lock_guard <std::mutex> lock {profilerThreadsMutex};
+
+  char event[256] {};
+  bool isFirstEvent {true};
+
+  const auto writeEvent =
+  [&trace, &isFirstEvent, &event] ()
+  {
+    trace << (isFirstEvent == true ? "\n" : ",\n") << event;
+    isFirstEvent = false;
+  };
+
+
+  trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  for ( const auto& thread : profilerThreads )
+  {
+    if ( thread->name != nullptr )
+    {
+      std::snprintf( event, sizeof(event),
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+        "\"tid\":%" PRIu32 ",\"args\":{\"name\":\"%s\"}}",
+        thread->id, thread->name );
+
+      writeEvent();
+    }
+
+
+    const uint64_t recordCount =
+      std::min <uint64_t> (thread->recordCount, zoneCapacity);
+
+//  Oldest record first
+    for ( uint64_t i = thread->recordCount - recordCount;
+          i < thread->recordCount; ++i )
+    {
+      const auto& record = thread->records[i % zoneCapacity];
+
+      std::snprintf( event, sizeof(event),
+        "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32 ","
+        "\"ts\":%.3f,\"dur\":%.3f}",
+        record.name, thread->id,
+        record.start / 1000.0,
+        (record.end - record.start) / 1000.0 );
+
+      writeEvent();
+    }
+  }
+
+  trace << "\n]}\n";
+
+  return trace.good();
+}
+
+#endif
@@ -20,12 +20,16 @@
 
 #include <include/render.hpp>
 #include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
 #include <include/canvas.hpp>
 #include <include/constants.hpp>
 #include <include/game_state.hpp>
 #include <include/plane.hpp>
+#include <include/resource_cache.hpp>
+#include <include/world.hpp>
 #include <include/textures.hpp>
 #include <include/variables.hpp>
+#include <include/profiler.hpp>
 
 #include <cmath>
 #include <string>
@@ -39,21 +43,23 @@ draw_text(
   namespace Text = constants::text;
 
 
-  for ( size_t i = 0; i < strlen(text); i++ )
+  const size_t length = strlen(text);
+
+  for ( size_t i = 0; i < length; i++ )
   {
-    const SDL_Rect textRect
+//    Glyphs are snapped to whole pixels to keep the font crisp
+    const SDL_FRect textRect
     {
-      toWindowSpaceX(x + Text::sizeX * i),
-      toWindowSpaceY(y),
-      scaleToScreenX(Text::sizeX),
-      scaleToScreenY(Text::sizeY),
+      std::floor(toWindowSpaceX(x + Text::sizeX * i)),
+      std::floor(toWindowSpaceY(y)),
+      std::floor(scaleToScreenX(Text::sizeX)),
+      std::floor(scaleToScreenY(Text::sizeY)),
     };
 
-    SDL_RenderCopy(
-      gRenderer,
+    sprite_batch_draw(
       textures.main_font,
       &textures.font_rect[text[i] - 32],
-      &textRect );
+      textRect );
   }
 }
 
@@ -118,34 +124,62 @@ draw_background()
     scaleToScreenY(1.0f),
   };
 
-  SDL_RenderCopyF(
-    gRenderer,
+  sprite_batch_draw(
     textures.background,
-    nullptr,
-    &backgroundRect );
+    &textures.background_rect,
+    backgroundRect );
+
+
+  const auto frameCount = textures.anim_background_frame_count;
 
+  if ( frameCount == 0 )
+    return;
+
+
+//  Frames are streamed in: the current and the next
+//  one are kept resident, the rest may be evicted
+  auto& cache = resourceCache();
+
+  const auto frameId =
+  [frameCount] ( const size_t frame )
+  {
+    return textures.anim_background + frame % frameCount;
+  };
 
   static size_t bgAnimFrame {};
+  static bool isStreaming {};
 
-  if ( textures.anim_background != nullptr &&
-       textures.anim_background[bgAnimFrame] != nullptr )
-    SDL_RenderCopyF(
-      gRenderer,
-      textures.anim_background[bgAnimFrame],
-      nullptr,
-      &backgroundRect );
+  if ( isStreaming == false )
+  {
+    isStreaming = true;
+
+    cache.Acquire(frameId(bgAnimFrame));
+    cache.Acquire(frameId(bgAnimFrame + 1));
+    cache.Prefetch(frameId(bgAnimFrame + 1));
+  }
+
+  sprite_batch_draw(
+    cache.texture(frameId(bgAnimFrame)),
+    nullptr,
+    backgroundRect );
 
 
   static Timer bgAnimation {constants::backgroundAnimationFrameTime};
 
   bgAnimation.Update();
 
-  if ( bgAnimation.isReady() == true )
+//  Hold the current frame until the next one is decoded
+  if (  bgAnimation.isReady() == true &&
+        cache.isResident(frameId(bgAnimFrame + 1)) == true )
   {
     bgAnimation.Start();
 
-    if ( ++bgAnimFrame >= textures.anim_background_frame_count )
-      bgAnimFrame = 0;
+    cache.Release(frameId(bgAnimFrame));
+
+    bgAnimFrame = (bgAnimFrame + 1) % frameCount;
+
+    cache.Acquire(frameId(bgAnimFrame + 1));
+    cache.Prefetch(frameId(bgAnimFrame + 1));
   }
 }
 
@@ -198,11 +232,10 @@ draw_barn()
     scaleToScreenY(barn::sizeY),
   };
 
-  SDL_RenderCopyF(
-    gRenderer,
+  sprite_batch_draw(
     textures.barn,
-    nullptr,
-    &barnRect );
+    &textures.barn_rect,
+    barnRect );
 }
 
 void
@@ -247,8 +280,8 @@ draw_score()
     std::to_string(constants::maxWinScore).size();
 
 
-  const auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-  const auto& planeRed = planes.at(PLANE_TYPE::RED);
+  const auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+  const auto& planeRed = world().planes.at(PLANE_TYPE::RED);
 
   auto textBlueScore =
     std::to_string(planeBlue.score());
@@ -329,5 +362,8 @@ draw_window_letterbox()
 void
 display_update()
 {
+  PROFILE_ZONE("display_update");
+
+  sprite_batch_end_frame();
   SDL_RenderPresent(gRenderer);
 }
@@ -0,0 +1,444 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/resource_cache.hpp>
+#include <include/asset_pack.hpp>
+#include <include/utility.hpp>
+
+#include <algorithm>
+
+
+ResourceCache&
+resourceCache()
+{
+  static ResourceCache cache {};
+  return cache;
+}
+
+
+ResourceCache::~ResourceCache()
+{
+  StopWorker();
+}
+
+void
+ResourceCache::Open(
+  const AssetPack& assetPack,
+  const size_t budget )
+{
+  mAssetPack = &assetPack;
+  mBudget = budget;
+}
+
+void
+ResourceCache::Close()
+{
+  StopWorker();
+
+  for ( auto& entry : mEntries )
+    Free(entry);
+
+  mEntries.clear();
+  mResidentSize = 0;
+  mAssetPack = nullptr;
+}
+
+ResourceCache::Id
+ResourceCache::AddTexture(
+  const std::string& path )
+{
+  return Add(path, TYPE::TEXTURE);
+}
+
+ResourceCache::Id
+ResourceCache::AddSound(
+  const std::string& path )
+{
+  return Add(path, TYPE::SOUND);
+}
+
+ResourceCache::Id
+ResourceCache::Add(
+  const std::string& path,
+  const TYPE type )
+{
+//  Worker reads entries, so they can't move anymore
+  if ( mWorker.joinable() == true )
+    StopWorker();
+
+
+  Entry entry {};
+  entry.path = path;
+  entry.type = type;
+
+  mEntries.push_back(entry);
+
+  return mEntries.size() - 1;
+}
+
+SDL_Texture*
+ResourceCache::texture(
+  const Id id )
+{
+  if ( id >= mEntries.size() )
+    return {};
+
+
+  auto& entry = mEntries[id];
+  entry.lastUsed = mFrame;
+
+  if ( entry.texture == nullptr )
+    Load(id);
+
+  return entry.texture;
+}
+
+Mix_Chunk*
+ResourceCache::sound(
+  const Id id )
+{
+  if ( id >= mEntries.size() )
+    return {};
+
+
+  auto& entry = mEntries[id];
+  entry.lastUsed = mFrame;
+
+  if ( entry.sound == nullptr )
+    Load(id);
+
+  return entry.sound;
+}
+
+void
+ResourceCache::Prefetch(
+  const Id id )
+{
+  if ( id >= mEntries.size() )
+    return;
+
+
+  auto& entry = mEntries[id];
+
+  if (  entry.size != 0 ||
+        entry.isPending == true ||
+        entry.isFailed == true )
+    return;
+
+  entry.lastUsed = mFrame;
+
+
+#if defined(__EMSCRIPTEN__)
+  Load(id);
+
+#else
+  entry.isPending = true;
+
+  if ( mWorker.joinable() == false )
+  {
+    mIsStopping = false;
+    mWorker = std::thread(&ResourceCache::RunWorker, this);
+  }
+
+  {
+    std::lock_guard <std::mutex> lock {mMutex};
+    mRequests.push_back(id);
+  }
+
+  mRequestsChanged.notify_one();
+#endif
+}
+
+void
+ResourceCache::Acquire(
+  const Id id )
+{
+  if ( id < mEntries.size() )
+    ++mEntries[id].refCount;
+}
+
+void
+ResourceCache::Release(
+  const Id id )
+{
+  if (  id < mEntries.size() &&
+        mEntries[id].refCount > 0 )
+    --mEntries[id].refCount;
+}
+
+void
+ResourceCache::Update()
+{
+  std::vector <Decoded> decoded {};
+
+  {
+    std::lock_guard <std::mutex> lock {mMutex};
+    decoded.swap(mDecoded);
+  }
+
+  for ( const auto& result : decoded )
+  {
+    mEntries[result.id].isPending = false;
+    Store(result);
+  }
+
+
+  Evict();
+
+  ++mFrame;
+}
+
+bool
+ResourceCache::isResident(
+  const Id id ) const
+{
+  return
+    id < mEntries.size() &&
+    mEntries[id].size != 0;
+}
+
+size_t
+ResourceCache::residentSize() const
+{
+  return mResidentSize;
+}
+
+
+ResourceCache::Decoded
+ResourceCache::Decode(
+  const Id id ) const
+{
+  const auto& entry = mEntries[id];
+
+  Decoded result {};
+  result.id = id;
+
+  const bool isPacked =
+    mAssetPack != nullptr &&
+    mAssetPack->find(entry.path) != nullptr;
+
+
+  switch (entry.type)
+  {
+    case TYPE::TEXTURE:
+    {
+      if ( isPacked == true )
+        result.surface = mAssetPack->LoadSurface(entry.path);
+      else
+        result.surface = IMG_Load( entry.path.c_str() );
+
+      break;
+    }
+
+    case TYPE::SOUND:
+    {
+      if ( isPacked == true )
+        result.sound = mAssetPack->LoadSound(entry.path);
+
+//      Mixer isn't open when audio is disabled
+      else if ( Mix_QuerySpec(nullptr, nullptr, nullptr) != 0 )
+        result.sound = Mix_LoadWAV( entry.path.c_str() );
+
+      break;
+    }
+  }
+
+  return result;
+}
+
+void
+ResourceCache::Store(
+  const Decoded& result )
+{
+  auto& entry = mEntries[result.id];
+
+//  Already loaded on demand while decoding
+  if ( entry.size != 0 )
+  {
+    SDL_FreeSurface(result.surface);
+    Mix_FreeChunk(result.sound);
+
+    return;
+  }
+
+
+  if ( result.surface != nullptr )
+  {
+    entry.texture = SDL_CreateTextureFromSurface(gRenderer, result.surface);
+
+    if ( entry.texture != nullptr )
+      entry.size = static_cast <size_t> (result.surface->w) * result.surface->h * 4;
+
+    SDL_FreeSurface(result.surface);
+  }
+
+  if ( result.sound != nullptr )
+  {
+    entry.sound = result.sound;
+    entry.size = std::max <size_t> (result.sound->alen, 1);
+  }
+
+
+  if ( entry.size == 0 )
+  {
+    entry.isFailed = true;
+
+    log_message( "RESOURCES: Unable to load '" + entry.path + "'" );
+    return;
+  }
+
+  mResidentSize += entry.size;
+}
+
+void
+ResourceCache::Load(
+  const Id id )
+{
+  auto& entry = mEntries[id];
+
+  if (  entry.size != 0 ||
+        entry.isFailed == true )
+    return;
+
+
+//  Pending decode, if any, will be discarded
+  Store(Decode(id));
+}
+
+void
+ResourceCache::Evict()
+{
+  while ( mResidentSize > mBudget )
+  {
+    Entry* oldest {};
+
+    for ( auto& entry : mEntries )
+    {
+      if (  entry.size == 0 ||
+            entry.refCount > 0 ||
+            entry.lastUsed >= mFrame ||
+            isSoundPlaying(entry.sound) == true )
+        continue;
+
+      if (  oldest == nullptr ||
+            entry.lastUsed < oldest->lastUsed )
+        oldest = &entry;
+    }
+
+//    Everything resident is in use
+    if ( oldest == nullptr )
+      return;
+
+    Free(*oldest);
+  }
+}
+
+void
+ResourceCache::Free(
+  Entry& entry )
+{
+  SDL_DestroyTexture(entry.texture);
+  Mix_FreeChunk(entry.sound);
+
+  mResidentSize -= std::min(entry.size, mResidentSize);
+
+  entry.texture = {};
+  entry.sound = {};
+  entry.size = {};
+}
+
+bool
+ResourceCache::isSoundPlaying(
+  const Mix_Chunk* sound ) const
+{
+  if ( sound == nullptr )
+    return false;
+
+
+  const auto channelCount = Mix_AllocateChannels(-1);
+
+  for ( int channel {}; channel < channelCount; ++channel )
+    if (  Mix_Playing(channel) != 0 &&
+          Mix_GetChunk(channel) == sound )
+      return true;
+
+  return false;
+}
+
+
+void
+ResourceCache::RunWorker()
+{
+  std::unique_lock <std::mutex> lock {mMutex};
+
+  while ( true )
+  {
+    mRequestsChanged.wait(
+      lock,
+      [this] ()
+      {
+        return mIsStopping == true || mRequests.empty() == false;
+      });
+
+    if ( mIsStopping == true )
+      return;
+
+
+    const auto id = mRequests.front();
+    mRequests.erase(mRequests.begin());
+
+    lock.unlock();
+    const auto result = Decode(id);
+    lock.lock();
+
+    mDecoded.push_back(result);
+  }
+}
+
+void
+ResourceCache::StopWorker()
+{
+  if ( mWorker.joinable() == false )
+    return;
+
+
+  {
+    std::lock_guard <std::mutex> lock {mMutex};
+    mIsStopping = true;
+  }
+
+  mRequestsChanged.notify_one();
+  mWorker.join();
+
+
+  for ( const auto id : mRequests )
+    mEntries[id].isPending = false;
+
+  for ( const auto& result : mDecoded )
+  {
+    mEntries[result.id].isPending = false;
+
+    SDL_FreeSurface(result.surface);
+    Mix_FreeChunk(result.sound);
+  }
+
+  mRequests.clear();
+  mDecoded.clear();
+}
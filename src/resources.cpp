@@ -19,19 +19,105 @@
 */
 
 #include <include/resources.hpp>
+#include <include/atlas.hpp>
+#include <include/asset_pack.hpp>
+#include <include/game_state.hpp>
+#include <include/resource_cache.hpp>
 #include <include/sdl.hpp>
 #include <include/sounds.hpp>
 #include <include/textures.hpp>
 #include <include/utility.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cstdlib>
 #include <cstring>
-#include <vector>
 #include <filesystem>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
 
 #define ASSETS_DIRNAME "assets"
 
 
+static AssetPack assetPack {};
+
+//  Font & logo are packed separately,
+//  so that intro screens can show up first
+static TextureAtlas introAtlas {};
+static TextureAtlas atlas {};
+
+
+static struct
+{
+  size_t font {};
+  size_t logo {};
+
+  size_t button {};
+
+  size_t background {};
+  size_t barn {};
+  size_t planeBlue {};
+  size_t planeRed {};
+  size_t bullet {};
+  size_t cloud {};
+  size_t cloudOpaque {};
+  size_t zeppelin {};
+  size_t zeppelinScore {};
+
+  size_t smoke {};
+  size_t fire {};
+  size_t explosion {};
+  size_t hit {};
+  size_t chute {};
+  size_t angel {};
+  size_t pilotFallRed {};
+  size_t pilotFallBlue {};
+  size_t pilotRunRed {};
+  size_t pilotRunBlue {};
+
+} images {};
+
+
+struct SoundAsset
+{
+  Mix_Chunk* Sounds::* sound {};
+  const char* filename {};
+};
+
+static constexpr SoundAsset soundAssets[]
+{
+  {&Sounds::shoot, "shoot.ogg"},
+  {&Sounds::explosion, "explosion.ogg"},
+  {&Sounds::hitPlane, "hit_plane.ogg"},
+  {&Sounds::hitChute, "hit_chute.ogg"},
+  {&Sounds::hitGround, "hit_ground.ogg"},
+  {&Sounds::pilotFallLoop, "fall_loop.ogg"},
+  {&Sounds::pilotChuteLoop, "chute_loop.ogg"},
+  {&Sounds::pilotDeath, "pilot_death.ogg"},
+  {&Sounds::pilotRescue, "pilot_rescue.ogg"},
+};
+
+static std::string soundErrors[std::size(soundAssets)] {};
+
+
+//  Decoding jobs, picked up by workers in order
+static std::vector <std::function <void()>> loadJobs {};
+static std::vector <std::thread> loadWorkers {};
+
+static std::atomic <size_t> nextLoadJob {};
+static std::atomic <size_t> finishedLoadJobs {};
+
+static std::atomic <size_t> introImagesDecoded {};
+static std::atomic <size_t> imagesDecoded {};
+
+static bool isIntroUploaded {};
+static bool isAtlasUploaded {};
+static bool isLoadFinished {};
+
+
 static std::string
 get_assets_root()
 {
@@ -51,293 +137,437 @@ get_assets_root()
 }
 
 
-void
-textures_load()
+//  Rect of an image part, relative to the image itself
+static SDL_Rect
+atlas_rect(
+  const TextureAtlas::Region& image,
+  const int x, const int y,
+  const int width, const int height )
 {
-  log_message( "RESOURCES: Loading textures..." );
+  return
+  {
+    image.rect.x + x,
+    image.rect.y + y,
+    width,
+    height,
+  };
+}
 
 
-  const auto assetsRoot = get_assets_root();
+static void
+run_load_job(
+  const size_t job )
+{
+  loadJobs[job]();
 
-  textures.main_font = loadTexture( assetsRoot + "/menu/font.png" );
+  finishedLoadJobs.fetch_add(1, std::memory_order_release);
+}
 
-  for ( uint8_t i = 0; i < 95; ++i )
-  {
-    textures.font_rect[i] =
-    {
-      (i % 19) * 8,
-      (i / 19) * 8,
-      8,
-      8,
-    };
-  }
+static void
+run_load_worker()
+{
+  for ( auto job = nextLoadJob++;
+        job < loadJobs.size();
+        job = nextLoadJob++ )
+    run_load_job(job);
+}
 
+static void
+join_load_workers()
+{
+  for ( auto& worker : loadWorkers )
+    worker.join();
+
+  loadWorkers.clear();
+}
 
-  textures.menu_help = loadTexture( assetsRoot + "/menu/screen_help.png" );
-  textures.menu_button = loadTexture( assetsRoot + "/menu/button.png" );
-  textures.menu_logo = loadTexture( assetsRoot + "/menu/screen_logo.png" );
 
+//  Frames are numbered from 0 without gaps
+static std::vector <std::string>
+list_background_frames(
+  const std::string& directory )
+{
+  std::vector <std::pair <size_t, std::string>> frames {};
 
-  textures.background = loadTexture( assetsRoot + "/ingame/background.png" );
-  textures.barn = loadTexture( assetsRoot + "/ingame/barn.png" );
-  textures.plane_blue = loadTexture( assetsRoot + "/ingame/plane_blue.png" );
-  textures.plane_red = loadTexture( assetsRoot + "/ingame/plane_red.png" );
-  textures.bullet = loadTexture( assetsRoot + "/ingame/bullet.png" );
-  textures.cloud = loadTexture( assetsRoot + "/ingame/cloud.png" );
-  textures.cloud_opaque = loadTexture( assetsRoot + "/ingame/cloud_opaque.png" );
-  textures.zeppelin = loadTexture( assetsRoot + "/ingame/zeppelin.png" );
-  textures.font_zeppelin_score = loadTexture( assetsRoot + "/ingame/font_zeppelin_score.png" );
+  std::error_code error {};
 
-  textures.anim_smk = loadTexture( assetsRoot + "/ingame/smoke.png" );
-  textures.anim_smk_rect[0] =
+  for ( const auto& entry : std::filesystem::directory_iterator(directory, error) )
   {
-    0, 0,
-    13, 13,
-  };
+    const auto filename = entry.path().filename().string();
 
-  for ( size_t i = 1; i < 6; ++i )
-  {
-    textures.anim_smk_rect[i] =
-    {
-      textures.anim_smk_rect[i - 1].x + textures.anim_smk_rect[i - 1].w,
-      0,
-      13, 13,
-    };
+    if (  filename.size() <= 9 ||
+          filename.compare(0, 5, "frame") != 0 ||
+          filename.compare(filename.size() - 4, 4, ".png") != 0 )
+      continue;
+
+
+    const auto number = filename.substr(5, filename.size() - 9);
+
+    if ( std::all_of(number.begin(), number.end(), ::isdigit) == false )
+      continue;
+
+    frames.push_back({std::stoul(number), entry.path().string()});
   }
 
-  textures.anim_fire = loadTexture( assetsRoot + "/ingame/fire.png" );
-  textures.anim_fire_rect[0] =
-  {
-    0, 0,
-    13, 13,
-  };
+  std::sort(frames.begin(), frames.end());
+
 
-  for ( size_t i = 1; i < 3; ++i )
+  std::vector <std::string> paths {};
+
+  for ( const auto& [index, path] : frames )
   {
-    textures.anim_fire_rect[i] =
-    {
-      textures.anim_fire_rect[i - 1].x + textures.anim_fire_rect[i - 1].w,
-      0,
-      13, 13,
-    };
+    if ( index != paths.size() )
+      break;
+
+    paths.push_back(path);
   }
 
-  textures.anim_expl = loadTexture( assetsRoot + "/ingame/explosion.png" );
-  textures.anim_expl_rect[0] =
+  return paths;
+}
+
+
+static void
+textures_assign_intro()
+{
+  const auto font = introAtlas.region(images.font);
+  textures.main_font = font.texture;
+
+  for ( uint8_t i = 0; i < 95; ++i )
+    textures.font_rect[i] =
+      atlas_rect(font, (i % 19) * 8, (i / 19) * 8, 8, 8);
+
+
+  const auto logo = introAtlas.region(images.logo);
+  textures.menu_logo = logo.texture;
+  textures.menu_logo_rect = logo.rect;
+}
+
+static void
+textures_assign()
+{
+  const auto setImage =
+  [] ( SDL_Texture*& texture, SDL_Rect& rect, const size_t image )
   {
-    0, 0,
-    40, 40,
+    const auto region = atlas.region(image);
+
+    texture = region.texture;
+    rect = region.rect;
   };
 
-  for ( size_t i = 1; i < 7; ++i )
+  setImage(textures.menu_button, textures.menu_button_rect, images.button);
+
+  setImage(textures.background, textures.background_rect, images.background);
+  setImage(textures.barn, textures.barn_rect, images.barn);
+  setImage(textures.plane_blue, textures.plane_blue_rect, images.planeBlue);
+  setImage(textures.plane_red, textures.plane_red_rect, images.planeRed);
+  setImage(textures.bullet, textures.bullet_rect, images.bullet);
+  setImage(textures.cloud, textures.cloud_rect, images.cloud);
+  setImage(textures.cloud_opaque, textures.cloud_opaque_rect, images.cloudOpaque);
+  setImage(textures.zeppelin, textures.zeppelin_rect, images.zeppelin);
+
+
+  const auto smoke = atlas.region(images.smoke);
+  textures.anim_smk = smoke.texture;
+
+  for ( size_t i = 0; i < 6; ++i )
+    textures.anim_smk_rect[i] = atlas_rect(smoke, i * 13, 0, 13, 13);
+
+
+  const auto fire = atlas.region(images.fire);
+  textures.anim_fire = fire.texture;
+
+  for ( size_t i = 0; i < 3; ++i )
+    textures.anim_fire_rect[i] = atlas_rect(fire, i * 13, 0, 13, 13);
+
+
+  const auto explosion = atlas.region(images.explosion);
+  textures.anim_expl = explosion.texture;
+
+  for ( size_t i = 0; i < 7; ++i )
+    textures.anim_expl_rect[i] = atlas_rect(explosion, i * 40, 0, 40, 40);
+
+
+  const auto hit = atlas.region(images.hit);
+  textures.anim_hit = hit.texture;
+
+  for ( size_t i = 0; i < 5; ++i )
+    textures.anim_hit_rect[i] = atlas_rect(hit, i * 9, 0, 9, 8);
+
+
+  const auto chute = atlas.region(images.chute);
+  textures.anim_chute = chute.texture;
+
+  for ( size_t i = 0; i < 3; ++i )
+    textures.anim_chute_rect[i] = atlas_rect(chute, i * 20, 0, 20, 12);
+
+
+  const auto angel = atlas.region(images.angel);
+  textures.anim_pilot_angel = angel.texture;
+
+  for ( size_t i = 0; i < 4; ++i )
+    textures.anim_pilot_angel_rect[i] = atlas_rect(angel, i * 10, 0, 10, 8);
+
+
+  const auto pilotFallRed = atlas.region(images.pilotFallRed);
+  const auto pilotFallBlue = atlas.region(images.pilotFallBlue);
+  textures.anim_pilot_fall_red = pilotFallRed.texture;
+  textures.anim_pilot_fall_blue = pilotFallBlue.texture;
+
+  for ( size_t i = 0; i < 2; ++i )
   {
-    textures.anim_expl_rect[i] =
-    {
-      textures.anim_expl_rect[i - 1].x + textures.anim_expl_rect[i - 1].w,
-      0,
-      40, 40,
-    };
+    textures.anim_pilot_fall_red_rect[i] = atlas_rect(pilotFallRed, i * 7, 0, 7, 7);
+    textures.anim_pilot_fall_blue_rect[i] = atlas_rect(pilotFallBlue, i * 7, 0, 7, 7);
   }
 
-  textures.anim_hit = loadTexture( assetsRoot + "/ingame/bullet_hit.png" );
-  textures.anim_hit_rect[0] =
-  {
-    0, 0,
-    9, 8,
-  };
 
-  for ( size_t i = 1; i < 5; ++i )
+  const auto pilotRunRed = atlas.region(images.pilotRunRed);
+  const auto pilotRunBlue = atlas.region(images.pilotRunBlue);
+  textures.anim_pilot_run_red = pilotRunRed.texture;
+  textures.anim_pilot_run_blue = pilotRunBlue.texture;
+
+  for ( size_t i = 0; i < 3; ++i )
   {
-    textures.anim_hit_rect[i] =
-    {
-      textures.anim_hit_rect[i - 1].x + textures.anim_hit_rect[i - 1].w,
-      0,
-      9, 8,
-    };
+    textures.anim_pilot_run_red_rect[i] = atlas_rect(pilotRunRed, i * 7, 0, 7, 7);
+    textures.anim_pilot_run_blue_rect[i] = atlas_rect(pilotRunBlue, i * 7, 0, 7, 7);
   }
 
-  textures.anim_chute = loadTexture( assetsRoot + "/ingame/chute.png" );
-  textures.anim_chute_rect[0] =
-  {
-    0, 0,
-    20, 12,
-  };
 
-  for ( size_t i = 1; i < 3; ++i )
+  const auto zeppelinScore = atlas.region(images.zeppelinScore);
+  textures.font_zeppelin_score = zeppelinScore.texture;
+
+//  Blue digits are on the top row, red ones are on the bottom one
+  for ( size_t i = 0; i < 10; ++i )
   {
-    textures.anim_chute_rect[i] =
-    {
-      textures.anim_chute_rect[i - 1].x + textures.anim_chute_rect[i - 1].w,
-      0,
-      20, 12,
-    };
+    textures.zeppelin_score_rect[i] = atlas_rect(zeppelinScore, i * 5, 0, 5, 6);
+    textures.zeppelin_score_rect[10 + i] = atlas_rect(zeppelinScore, i * 5, 6, 5, 6);
   }
+}
+
+
+//  Runs on a worker thread, so errors are reported later
+static Mix_Chunk*
+decode_sound(
+  const std::string& path,
+  std::string& error )
+{
+  if ( assetPack.find(path) != nullptr )
+    return assetPack.LoadSound(path);
+
+//  Mixer isn't open when audio is disabled
+  if ( Mix_QuerySpec(nullptr, nullptr, nullptr) == 0 )
+    return nullptr;
+
+
+  auto* const sound = Mix_LoadWAV( path.c_str() );
+
+  if ( sound == nullptr )
+    error = Mix_GetError();
+
+  return sound;
+}
+
+
+void
+resources_load_begin()
+{
+  log_message( "RESOURCES: Loading assets..." );
+
+
+  const auto assetsRoot = get_assets_root();
+
+  if ( assetPack.isOpen() == false )
+    assetPack.Open(assetsRoot);
 
-  textures.anim_pilot_angel = loadTexture( assetsRoot + "/ingame/pilot_angel.png" );
-  textures.anim_pilot_angel_rect[0] =
-  {
-    0, 0,
-    10, 8,
-  };
 
-  for ( size_t i = 1; i < 4; ++i )
+  images.font = introAtlas.Add( assetsRoot + "/menu/font.png" );
+  images.logo = introAtlas.Add( assetsRoot + "/menu/screen_logo.png" );
+
+  images.button = atlas.Add( assetsRoot + "/menu/button.png" );
+
+  images.background = atlas.Add( assetsRoot + "/ingame/background.png" );
+  images.barn = atlas.Add( assetsRoot + "/ingame/barn.png" );
+  images.planeBlue = atlas.Add( assetsRoot + "/ingame/plane_blue.png" );
+  images.planeRed = atlas.Add( assetsRoot + "/ingame/plane_red.png" );
+  images.bullet = atlas.Add( assetsRoot + "/ingame/bullet.png" );
+  images.cloud = atlas.Add( assetsRoot + "/ingame/cloud.png" );
+  images.cloudOpaque = atlas.Add( assetsRoot + "/ingame/cloud_opaque.png" );
+  images.zeppelin = atlas.Add( assetsRoot + "/ingame/zeppelin.png" );
+  images.zeppelinScore = atlas.Add( assetsRoot + "/ingame/font_zeppelin_score.png" );
+
+  images.smoke = atlas.Add( assetsRoot + "/ingame/smoke.png" );
+  images.fire = atlas.Add( assetsRoot + "/ingame/fire.png" );
+  images.explosion = atlas.Add( assetsRoot + "/ingame/explosion.png" );
+  images.hit = atlas.Add( assetsRoot + "/ingame/bullet_hit.png" );
+  images.chute = atlas.Add( assetsRoot + "/ingame/chute.png" );
+  images.angel = atlas.Add( assetsRoot + "/ingame/pilot_angel.png" );
+  images.pilotFallRed = atlas.Add( assetsRoot + "/ingame/pilot_fall_red.png" );
+  images.pilotFallBlue = atlas.Add( assetsRoot + "/ingame/pilot_fall_blue.png" );
+  images.pilotRunRed = atlas.Add( assetsRoot + "/ingame/pilot_run_red.png" );
+  images.pilotRunBlue = atlas.Add( assetsRoot + "/ingame/pilot_run_blue.png" );
+
+
+
+//  Rarely used, so they're loaded on demand
+  auto& cache = resourceCache();
+  cache.Open(assetPack, gameState().assetCacheBudget * 1024 * 1024);
+
+  textures.menu_help = cache.AddTexture( assetsRoot + "/menu/screen_help.png" );
+
+  const auto backgroundFrames =
+    list_background_frames(assetsRoot + "/ingame/background_animation");
+
+  textures.anim_background_frame_count = backgroundFrames.size();
+
+  for ( size_t i {}; i < backgroundFrames.size(); ++i )
   {
-    textures.anim_pilot_angel_rect[i] =
-    {
-      textures.anim_pilot_angel_rect[i-1].x + textures.anim_pilot_angel_rect[i-1].w,
-      0,
-      10, 8,
-    };
+    const auto frame = cache.AddTexture(backgroundFrames[i]);
+
+    if ( i == 0 )
+      textures.anim_background = frame;
   }
 
-  textures.anim_pilot_fall_red = loadTexture( assetsRoot + "/ingame/pilot_fall_red.png" );
-  textures.anim_pilot_fall_blue = loadTexture( assetsRoot + "/ingame/pilot_fall_blue.png" );
-  textures.anim_pilot_fall_rect[0] = { 0, 0, 7, 7 };
-  textures.anim_pilot_fall_rect[1] = { 7, 0, 7, 7 };
+  sounds.victory = cache.AddSound( assetsRoot + "/sounds/victory.ogg" );
+  sounds.defeat = cache.AddSound( assetsRoot + "/sounds/defeat.ogg" );
 
-  textures.anim_pilot_run_red = loadTexture( assetsRoot + "/ingame/pilot_run_red.png" );
-  textures.anim_pilot_run_blue = loadTexture( assetsRoot + "/ingame/pilot_run_blue.png" );
-  textures.anim_pilot_run_rect[0] =
-  {
-    0, 0,
-    7, 7,
-  };
 
-  for ( size_t i = 1; i < 3; ++i )
-  {
-    textures.anim_pilot_run_rect[i] =
+  introAtlas.Prepare(get_atlas_cache_path() + "_intro", assetPack);
+  atlas.Prepare(get_atlas_cache_path(), assetPack);
+
+
+//  Intro images go first, then sounds since they take
+//  the longest to decode, then everything else
+  for ( size_t i {}; i < introAtlas.decodeCount(); ++i )
+    loadJobs.push_back(
+    [i] ()
     {
-      textures.anim_pilot_run_rect[i - 1].x + textures.anim_pilot_run_rect[i - 1].w,
-      0,
-      7, 7,
-    };
-  }
+      introAtlas.Decode(i, assetPack);
+      introImagesDecoded.fetch_add(1, std::memory_order_release);
+    });
 
-  textures.zeppelin_score_rect[0] =
-  {
-    0, 0,
-    5, 6,
-  };
+  for ( size_t i {}; i < std::size(soundAssets); ++i )
+    loadJobs.push_back(
+    [i, path = assetsRoot + "/sounds/" + soundAssets[i].filename] ()
+    {
+      sounds.*soundAssets[i].sound = decode_sound(path, soundErrors[i]);
+    });
 
-  for ( size_t i = 1; i < 10; ++i )
-  {
-    textures.zeppelin_score_rect[i] =
+  for ( size_t i {}; i < atlas.decodeCount(); ++i )
+    loadJobs.push_back(
+    [i] ()
     {
-      textures.zeppelin_score_rect[i - 1].x + textures.zeppelin_score_rect[i - 1].w,
-      0,
-      5, 6,
-    };
-  }
+      atlas.Decode(i, assetPack);
+      imagesDecoded.fetch_add(1, std::memory_order_release);
+    });
 
 
-  textures.zeppelin_score_rect[10] =
-  {
-    0, 6,
-    5, 6,
-  };
+#if !defined(__EMSCRIPTEN__)
 
-  for ( size_t i = 11; i < 20; ++i )
-  {
-    textures.zeppelin_score_rect[i] =
-    {
-      textures.zeppelin_score_rect[i - 1].x + textures.zeppelin_score_rect[i - 1].w,
-      6,
-      5, 6,
-    };
-  }
+  const auto threadCount = std::min(
+    std::max(std::thread::hardware_concurrency(), 1u),
+    static_cast <unsigned> (loadJobs.size()) );
+
+  for ( size_t i {}; i < threadCount; ++i )
+    loadWorkers.emplace_back(run_load_worker);
+#endif
+}
+
+bool
+resources_load_update()
+{
+  if ( isLoadFinished == true )
+    return true;
 
 
-  std::vector <SDL_Texture*> backgroundFrames {};
+#if defined(__EMSCRIPTEN__)
 
-  for ( size_t i {}; ; ++i )
+//  No worker threads here, so decode one asset per frame
+  if ( const auto job = nextLoadJob++; job < loadJobs.size() )
+    run_load_job(job);
+#endif
+
+
+  if (  isIntroUploaded == false &&
+        introImagesDecoded.load(std::memory_order_acquire) == introAtlas.decodeCount() )
   {
-    const auto filename =
-      assetsRoot + "/ingame/background_animation/frame" + std::to_string(i) + ".png";
+    introAtlas.Upload(assetPack);
+    textures_assign_intro();
 
-    if ( std::filesystem::exists(filename) == false )
-    {
-      textures.anim_background_frame_count = i;
-      break;
-    }
-    else
-      backgroundFrames.push_back(loadTexture(filename));
+    isIntroUploaded = true;
   }
 
-  if ( backgroundFrames.empty() == false )
+  if (  isAtlasUploaded == false &&
+        imagesDecoded.load(std::memory_order_acquire) == atlas.decodeCount() )
   {
-    textures.anim_background = new SDL_Texture*[backgroundFrames.size()];
+    atlas.Upload(assetPack);
+    textures_assign();
 
-    for (  size_t i {}; i < backgroundFrames.size(); ++i )
-      textures.anim_background[i] = backgroundFrames[i];
+    isAtlasUploaded = true;
   }
 
+  if ( finishedLoadJobs.load(std::memory_order_acquire) < loadJobs.size() )
+    return false;
 
-  log_message( "\nRESOURCES: Finished loading textures!\n\n" );
-}
 
-void
-textures_unload()
-{
-  log_message( "RESOURCES: Unloading textures..." );
+  join_load_workers();
+  loadJobs.clear();
+
+  for ( size_t i {}; i < std::size(soundAssets); ++i )
+  {
+    if ( soundErrors[i].empty() == true )
+      continue;
 
+    const auto path = get_assets_root() + "/sounds/" + soundAssets[i].filename;
 
-  SDL_DestroyTexture(textures.main_font);
-  SDL_DestroyTexture(textures.menu_help);
-  SDL_DestroyTexture(textures.menu_button);
-  SDL_DestroyTexture(textures.menu_logo);
-  SDL_DestroyTexture(textures.font_zeppelin_score);
-  SDL_DestroyTexture(textures.background);
-  SDL_DestroyTexture(textures.barn);
-  SDL_DestroyTexture(textures.plane_red);
-  SDL_DestroyTexture(textures.plane_blue);
-  SDL_DestroyTexture(textures.bullet);
-  SDL_DestroyTexture(textures.cloud);
-  SDL_DestroyTexture(textures.cloud_opaque);
-  SDL_DestroyTexture(textures.zeppelin);
-  SDL_DestroyTexture(textures.anim_smk);
-  SDL_DestroyTexture(textures.anim_fire);
-  SDL_DestroyTexture(textures.anim_expl);
-  SDL_DestroyTexture(textures.anim_hit);
-  SDL_DestroyTexture(textures.anim_chute);
-  SDL_DestroyTexture(textures.anim_pilot_angel);
-  SDL_DestroyTexture(textures.anim_pilot_fall_red);
-  SDL_DestroyTexture(textures.anim_pilot_fall_blue);
-  SDL_DestroyTexture(textures.anim_pilot_run_red);
-  SDL_DestroyTexture(textures.anim_pilot_run_blue);
-
-  for ( size_t i {}; i < textures.anim_background_frame_count; ++i )
-    SDL_DestroyTexture(textures.anim_background[i]);
-
-  delete[] textures.anim_background;
+    log_message( "\n\nResources: Unable to load sound from file '" + path + "'\nSDL_mixer Error: ", soundErrors[i] );
+    show_warning( "Unable to load sound!", path );
 
-  textures = {};
+    soundErrors[i].clear();
+  }
 
+  isLoadFinished = true;
 
-  log_message( "\nRESOURCES: Finished unloading textures!\n\n" );
+
+  log_message( "\nRESOURCES: Finished loading assets!\n\n" );
+
+  return true;
+}
+
+float
+resources_load_progress()
+{
+  if ( loadJobs.empty() == true )
+    return isLoadFinished == true ? 1.f : 0.f;
+
+  return
+    static_cast <float> (finishedLoadJobs.load(std::memory_order_acquire)) /
+    loadJobs.size();
+}
+
+bool
+resources_loaded()
+{
+  return isLoadFinished;
 }
 
+
 void
-sounds_load()
+textures_unload()
 {
-  log_message( "RESOURCES: Loading sounds..." );
+  log_message( "RESOURCES: Unloading textures..." );
 
 
-  const auto assetsRoot = get_assets_root();
+//  Workers may still be decoding when exiting early
+  join_load_workers();
 
-  sounds.shoot = loadSound( assetsRoot + "/sounds/shoot.ogg" );
-  sounds.explosion = loadSound( assetsRoot + "/sounds/explosion.ogg" );
-  sounds.hitPlane = loadSound( assetsRoot + "/sounds/hit_plane.ogg" );
-  sounds.hitChute = loadSound( assetsRoot + "/sounds/hit_chute.ogg" );
-  sounds.hitGround = loadSound( assetsRoot + "/sounds/hit_ground.ogg" );
-  sounds.pilotFallLoop = loadSound( assetsRoot + "/sounds/fall_loop.ogg" );
-  sounds.pilotChuteLoop = loadSound( assetsRoot + "/sounds/chute_loop.ogg" );
-  sounds.pilotDeath = loadSound( assetsRoot + "/sounds/pilot_death.ogg" );
-  sounds.pilotRescue = loadSound( assetsRoot + "/sounds/pilot_rescue.ogg" );
-  sounds.victory = loadSound( assetsRoot + "/sounds/victory.ogg" );
-  sounds.defeat = loadSound( assetsRoot + "/sounds/defeat.ogg" );
+//  Every texture is either an atlas page or cached
+  introAtlas.Unload();
+  atlas.Unload();
+  resourceCache().Close();
+
+  textures = {};
 
 
-  log_message( "\nRESOURCES: Finished loading sounds!\n\n" );
+  log_message( "\nRESOURCES: Finished unloading textures!\n\n" );
 }
 
 void
@@ -346,20 +576,17 @@ sounds_unload()
   log_message( "RESOURCES: Unloading sounds..." );
 
 
-  Mix_FreeChunk(sounds.shoot);
-  Mix_FreeChunk(sounds.explosion);
-  Mix_FreeChunk(sounds.hitPlane);
-  Mix_FreeChunk(sounds.hitChute);
-  Mix_FreeChunk(sounds.hitGround);
-  Mix_FreeChunk(sounds.pilotFallLoop);
-  Mix_FreeChunk(sounds.pilotChuteLoop);
-  Mix_FreeChunk(sounds.pilotDeath);
-  Mix_FreeChunk(sounds.pilotRescue);
-  Mix_FreeChunk(sounds.victory);
-  Mix_FreeChunk(sounds.defeat);
+  join_load_workers();
+
+  for ( const auto& asset : soundAssets )
+    Mix_FreeChunk(sounds.*asset.sound);
 
   sounds = {};
 
+//  Sound samples may point into the asset pack
+  resourceCache().Close();
+  assetPack.Close();
+
 
   log_message( "\nRESOURCES: Finished unloading sounds!\n\n" );
 }
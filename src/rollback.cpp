@@ -0,0 +1,605 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/rollback.hpp>
+#include <include/world.hpp>
+#include <include/world_snapshot.hpp>
+#include <include/constants.hpp>
+#include <include/controls.hpp>
+#include <include/game_state.hpp>
+#include <include/network.hpp>
+#include <include/network_data.hpp>
+#include <include/simulation.hpp>
+#include <include/time.hpp>
+#include <include/profiler.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+
+struct FrameRecord
+{
+  uint32_t frame {};
+  bool withRemote {};
+
+//  World state before this frame was simulated
+  WorldSnapshot snapshot {};
+
+  Controls localInput {};
+  Controls remoteInput {};
+
+  bool hasCorrection {};
+  PlaneNetworkData correction {};
+
+  EVENTS events[16] {};
+  uint8_t eventCount {};
+  uint8_t eventsApplied {};
+
+//  Hits on local plane, only checked on new frames
+  EVENTS localHits[4] {};
+  uint8_t localHitCount {};
+};
+
+struct RemoteInput
+{
+  uint32_t frame {};
+  bool isConfirmed {};
+  Controls input {};
+};
+
+
+static std::array <FrameRecord, rollbackFrames> frames {};
+static std::array <RemoteInput, rollbackFrames> remoteInputs {};
+
+static uint32_t currentFrame {};
+static uint32_t rollbackTarget {};
+
+static bool hasRemoteFrame {};
+static uint32_t remoteFrameLatest {};
+
+static uint8_t stallCooldown {};
+
+static SimEventHandler resimEventHandler {};
+
+
+//  Peer that is this many frames ahead skips a tick
+static constexpr float maxFrameAdvantage {3.f};
+static constexpr uint8_t stallInterval {8};
+
+//  Ticks missed during a hitch are caught up to this many at once,
+//  the rest is left for the opponent to wait out by stalling
+static constexpr uint32_t maxCatchUpFrames {4};
+
+//  Smaller discrepancies aren't worth a rollback
+static constexpr float coordsTolerance {0.002f};
+static constexpr float dirTolerance {0.01f};
+
+
+static FrameRecord&
+record(
+  const uint32_t frame )
+{
+  return frames[frame % rollbackFrames];
+}
+
+static void
+recordBegin(
+  const uint32_t frame )
+{
+  auto& rec = record(frame);
+
+  rec.frame = frame;
+  rec.withRemote = false;
+  rec.localInput = {};
+  rec.remoteInput = {};
+  rec.hasCorrection = false;
+  rec.eventCount = 0;
+  rec.eventsApplied = 0;
+  rec.localHitCount = 0;
+}
+
+static bool
+isInHistory(
+  const uint32_t frame )
+{
+  return
+    frame <= currentFrame &&
+    currentFrame - frame < rollbackFrames &&
+    record(frame).frame == frame;
+}
+
+static void
+rollbackTo(
+  const uint32_t frame )
+{
+  rollbackTarget = std::min(rollbackTarget, frame);
+}
+
+
+static uint8_t
+encodeControls(
+  const Controls& controls )
+{
+  return
+    controls.pitch |
+    controls.throttle << 2 |
+    controls.shoot << 4 |
+    controls.jump << 5;
+}
+
+static Controls
+decodeControls(
+  const uint8_t bits )
+{
+  Controls controls {};
+
+  controls.pitch = static_cast <PLANE_PITCH> (bits & 0b11);
+  controls.throttle = static_cast <PLANE_THROTTLE> (bits >> 2 & 0b11);
+  controls.shoot = bits >> 4 & 1;
+  controls.jump = bits >> 5 & 1;
+
+  return controls;
+}
+
+static bool
+operator == (
+  const Controls& lhs,
+  const Controls& rhs )
+{
+  return encodeControls(lhs) == encodeControls(rhs);
+}
+
+
+static Plane&
+localPlane()
+{
+  auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+
+  return
+    planeBlue.isLocal() == true
+    ? planeBlue
+    : world().planes.at(PLANE_TYPE::RED);
+}
+
+static Plane&
+remotePlane()
+{
+  auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+
+  return
+    planeBlue.isLocal() == false
+    ? planeBlue
+    : world().planes.at(PLANE_TYPE::RED);
+}
+
+
+//  Confirmed input if we have it, otherwise the last confirmed
+//  one held over. Jumps aren't repeated, since a held jump
+//  button would open the chute right after bailing out
+static Controls
+remoteInputFor(
+  const uint32_t frame )
+{
+  for ( uint32_t i {}; i < rollbackFrames && i <= frame; ++i )
+  {
+    const auto& slot = remoteInputs[(frame - i) % rollbackFrames];
+
+    if ( slot.frame != frame - i || slot.isConfirmed == false )
+      continue;
+
+    auto controls = slot.input;
+
+    if ( i > 0 )
+      controls.jump = false;
+
+    return controls;
+  }
+
+  return {};
+}
+
+static bool
+differsFrom(
+  const Plane& plane,
+  const PlaneNetworkData& data )
+{
+  if ( std::abs(plane.dir() - data.dir) > dirTolerance )
+    return true;
+
+  if (  plane.hasJumped() == true &&
+        ( std::abs(plane.pilot.x() - data.pilot_x) > coordsTolerance ||
+          std::abs(plane.pilot.y() - data.pilot_y) > coordsTolerance ) )
+    return true;
+
+  return
+    std::abs(plane.x() - data.x) > coordsTolerance ||
+    std::abs(plane.y() - data.y) > coordsTolerance;
+}
+
+
+//  Opponent was already told about these hits,
+//  so they must happen again when re-simulated
+static void
+replayLocalHit(
+  const EVENTS event )
+{
+  auto& planeLocal = localPlane();
+  auto& planeRemote = remotePlane();
+
+  switch ( event )
+  {
+    case EVENTS::HIT_PLANE:
+    {
+      planeLocal.Hit(planeRemote);
+      break;
+    }
+
+    case EVENTS::HIT_CHUTE:
+    {
+      planeLocal.pilot.ChuteHit(planeRemote);
+      break;
+    }
+
+    case EVENTS::HIT_PILOT:
+    {
+      planeLocal.pilot.Kill(planeRemote);
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+
+static void
+simulateFrame(
+  const uint32_t frame )
+{
+  auto& sim = world();
+  auto& rec = record(frame);
+
+  rec.snapshot.save(sim);
+
+
+  auto& planeLocal = localPlane();
+  auto& planeRemote = remotePlane();
+
+  if ( rec.withRemote == true )
+  {
+    if ( rec.hasCorrection == true )
+    {
+      planeRemote.setCoords(rec.correction);
+      planeRemote.setDir(rec.correction.dir);
+      planeRemote.pilot.setX(rec.correction.pilot_x);
+      planeRemote.pilot.setY(rec.correction.pilot_y);
+    }
+  }
+
+
+  for ( auto& cloud : sim.clouds )
+    cloud.Update();
+
+  processPlaneControls(planeLocal, rec.localInput);
+  planeLocal.Update();
+
+  if ( rec.withRemote == true )
+  {
+    rec.remoteInput = remoteInputFor(frame);
+
+    processPlaneControls(planeRemote, rec.remoteInput);
+    planeRemote.Update();
+
+//  Opponent's planes pushed these while updating this frame.
+//  Events arriving late are applied in the past, but
+//  their sounds and messages still belong to the present
+    for ( uint8_t i {}; i < rec.eventCount; ++i )
+    {
+      const bool isNewEvent = i >= rec.eventsApplied;
+
+      if ( isNewEvent == true && sim.isResimulating == true )
+        sim.eventHandler = resimEventHandler;
+
+      applyOpponentEvent(rec.events[i]);
+
+      if ( sim.isResimulating == true )
+        sim.eventHandler = nullptr;
+    }
+
+    rec.eventsApplied = rec.eventCount;
+  }
+
+//  AI keeps no history, so it only acts on new frames
+  if (  sim.state.debug.ai == true &&
+        sim.isResimulating == false )
+    sim.aiController.update();
+
+  sim.zeppelin.Update();
+  sim.bullets.Update();
+
+  if ( sim.isResimulating == true )
+    for ( uint8_t i {}; i < rec.localHitCount; ++i )
+      replayLocalHit(rec.localHits[i]);
+
+  sim.effects.Update();
+}
+
+
+void
+rollbackReset()
+{
+  currentFrame = 0;
+  rollbackTarget = 0;
+
+  hasRemoteFrame = false;
+  remoteFrameLatest = 0;
+  stallCooldown = 0;
+
+  for ( auto& slot : remoteInputs )
+    slot = {};
+
+  recordBegin(currentFrame);
+}
+
+uint32_t
+rollbackFrame()
+{
+  return currentFrame;
+}
+
+bool
+rollbackShouldStall(
+  const float roundTripTime )
+{
+  if ( hasRemoteFrame == false )
+    return false;
+
+  if ( stallCooldown > 0 )
+  {
+    --stallCooldown;
+    return false;
+  }
+
+
+  const float remoteFrameEstimate =
+    remoteFrameLatest + 0.5f * roundTripTime * constants::tickRate;
+
+  if ( currentFrame - remoteFrameEstimate < maxFrameAdvantage )
+    return false;
+
+
+  stallCooldown = stallInterval;
+
+  return true;
+}
+
+void
+rollbackAddRemoteInput(
+  const uint32_t frame,
+  const Controls& controls )
+{
+  if ( hasRemoteFrame == false || frame > remoteFrameLatest )
+  {
+    hasRemoteFrame = true;
+    remoteFrameLatest = frame;
+  }
+
+  if (  frame + rollbackFrames <= currentFrame ||
+        frame >= currentFrame + rollbackFrames )
+    return;
+
+
+  auto& slot = remoteInputs[frame % rollbackFrames];
+
+  if ( slot.frame == frame && slot.isConfirmed == true )
+    return;
+
+  slot = {frame, true, controls};
+
+
+  if ( isInHistory(frame) == false || frame == currentFrame )
+    return;
+
+  if ( (record(frame).remoteInput == controls) == false )
+    rollbackTo(frame);
+}
+
+void
+rollbackAddRemoteState(
+  const uint32_t frame,
+  const PlaneNetworkData& data )
+{
+//  Remote state is reported after simulating the frame
+  const auto targetFrame = frame + 1;
+
+  if ( isInHistory(targetFrame) == false )
+    return;
+
+
+  auto& rec = record(targetFrame);
+
+  if ( targetFrame < currentFrame )
+  {
+    const auto remoteType = remotePlane().type();
+    const auto& planeRemote =
+      rec.snapshot.planes[remoteType == PLANE_TYPE::BLUE ? 0 : 1];
+
+    if ( differsFrom(planeRemote, data) == false )
+      return;
+
+    rollbackTo(targetFrame);
+  }
+
+  rec.hasCorrection = true;
+  rec.correction = data;
+}
+
+void
+rollbackAddRemoteEvent(
+  const uint32_t frame,
+  const EVENTS event )
+{
+//  Frames too old or not simulated yet take it in the present
+  auto targetFrame = std::min(frame, currentFrame);
+
+  if ( isInHistory(targetFrame) == false )
+    targetFrame = currentFrame;
+
+
+  auto& rec = record(targetFrame);
+
+  if ( rec.eventCount >= sizeof(rec.events) / sizeof(rec.events[0]) )
+    return applyOpponentEvent(event);
+
+  rec.events[rec.eventCount++] = event;
+
+  rollbackTo(targetFrame);
+}
+
+void
+rollbackAddLocalEvent(
+  const EVENTS event )
+{
+  if (  event != EVENTS::HIT_PLANE &&
+        event != EVENTS::HIT_CHUTE &&
+        event != EVENTS::HIT_PILOT )
+    return;
+
+
+  auto& rec = record(currentFrame);
+
+  if ( rec.localHitCount < sizeof(rec.localHits) / sizeof(rec.localHits[0]) )
+    rec.localHits[rec.localHitCount++] = event;
+}
+
+void
+rollbackAdvance(
+  const Controls& local,
+  const bool withRemote )
+{
+  PROFILE_ZONE("rollbackAdvance");
+
+  auto& sim = world();
+
+//  Frames must step by exactly the same time on both peers
+//  and when re-simulated, whatever the local frame pacing is
+  const auto frameDeltaTime = deltaTime;
+  deltaTime = 1.0 / constants::tickRate;
+
+  const uint32_t oldestFrame =
+    currentFrame >= rollbackFrames
+    ? currentFrame - rollbackFrames + 1
+    : 0;
+
+  rollbackTarget = std::max(rollbackTarget, oldestFrame);
+
+  if ( rollbackTarget < currentFrame )
+  {
+    record(rollbackTarget).snapshot.restore(sim);
+
+    resimEventHandler = sim.eventHandler;
+    sim.eventHandler = nullptr;
+    sim.isResimulating = true;
+
+    for ( auto frame = rollbackTarget; frame < currentFrame; ++frame )
+      simulateFrame(frame);
+
+    sim.isResimulating = false;
+    sim.eventHandler = resimEventHandler;
+  }
+
+
+  const auto frameCount = std::clamp(
+    static_cast <uint32_t> (std::lround(frameDeltaTime * constants::tickRate)),
+    1u, maxCatchUpFrames );
+
+  for ( uint32_t i {}; i < frameCount; ++i )
+  {
+    auto& rec = record(currentFrame);
+
+    rec.localInput = local;
+    rec.withRemote = withRemote;
+
+    simulateFrame(currentFrame);
+
+    rollbackTarget = ++currentFrame;
+    recordBegin(currentFrame);
+  }
+
+  deltaTime = frameDeltaTime;
+}
+
+const WorldSnapshot*
+rollbackSnapshot(
+  const uint32_t frame )
+{
+//  Frames from rollbackTarget on are about to be re-simulated
+  if (  frame >= currentFrame ||
+        frame > rollbackTarget ||
+        isInHistory(frame) == false )
+    return nullptr;
+
+  return &record(frame).snapshot;
+}
+
+void
+rollbackPackInputs(
+  Packet& packet )
+{
+  if ( currentFrame == 0 )
+    return;
+
+
+  packet.frame = currentFrame - 1;
+
+  const uint8_t inputCount = sizeof(packet.inputs);
+
+  for ( uint8_t i {}; i < inputCount; ++i )
+  {
+    const uint32_t offset = inputCount - 1 - i;
+
+    if ( offset > packet.frame )
+      continue;
+
+    const auto frame = packet.frame - offset;
+
+    packet.inputs[i] = encodeControls(record(frame).localInput);
+  }
+}
+
+void
+rollbackUnpackInputs(
+  const Packet& packet )
+{
+  const uint8_t inputCount = sizeof(packet.inputs);
+
+  for ( uint8_t i {}; i < inputCount; ++i )
+  {
+    const uint32_t offset = inputCount - 1 - i;
+
+    if ( offset > packet.frame )
+      continue;
+
+    rollbackAddRemoteInput(
+      packet.frame - offset,
+      decodeControls(packet.inputs[i]) );
+  }
+}
@@ -19,6 +19,7 @@
 */
 
 #include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
 #include <include/canvas.hpp>
 #include <include/constants.hpp>
 #include <include/game_state.hpp>
@@ -484,6 +485,10 @@ void
 setRenderColor(
   const Color& color )
 {
+//  Every primitive is drawn right after picking its color,
+//  so sprites queued before it must be submitted first
+  sprite_batch_flush();
+
   SDL_SetRenderDrawColor(
     gRenderer,
     color.r,
@@ -0,0 +1,749 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Dedicated matchmaking and relay server.
+//  Doesn't run the game at all: no simulation, window or mixer.
+//  Answers the matchmaking requests of MatchMaker with its own
+//  address, then relays datagrams between the paired players on
+//  the same UDP socket, so clients play exactly as peer-to-peer
+//  and each of them keeps deciding hits and score on its own.
+//  All matches share the socket, datagrams are routed to the
+//  opponent by the sender's address.
+//  With --p2p it only pairs players and sends them each other's
+//  address instead, like the public matchmaking server.
+
+#include <include/enums.hpp>
+#include <include/matchmake.hpp>
+#include <include/utility.hpp>
+
+#include <lib/Net.h>
+#include <lib/picojson.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+using Clock = std::chrono::steady_clock;
+
+//  Same as the clients' connection timeout
+static constexpr double PlayerTimeout {10.0};
+static constexpr double SeekerTimeout {15.0};
+
+//  MatchMaker searches again if it gets no reply in 5 s,
+//  an earlier MMECHO would only make it stop listening
+static constexpr double EchoDelay {4.0};
+static constexpr double StatsInterval {10.0};
+
+
+struct ServerOptions
+{
+  uint16_t port {MATCHMAKE_SRV_PORT};
+  std::string publicIp {"127.0.0.1"};
+  uint32_t maxMatches {1024};
+  bool isRelay {true};
+};
+
+
+struct MatchPlayer
+{
+  net::Address address {};
+  Clock::time_point lastSeen {};
+};
+
+
+//  Host of the match flies blue, the other player red
+struct Match
+{
+  uint32_t id {};
+  MatchPlayer players[2] {};
+  bool isClosed {};
+};
+
+
+//  Player looking for an opponent. Its game socket sends
+//  FIND, its matchmaking socket MMSTREAM and gets the replies
+struct Seeker
+{
+  net::Address gameAddress {};
+  net::Address streamAddress {};
+  std::string password {};
+  Clock::time_point lastSeen {};
+  Clock::time_point echoTime {};
+};
+
+//  Kept for a while to resend MMOPPONENT to players
+//  that missed it and are still searching
+struct Pairing
+{
+  net::Address gameAddress {};
+  net::Address streamAddress {};
+  std::string opponentIp {};
+  uint16_t opponentPort {};
+  SRV_CLI nodeType {};
+  Clock::time_point time {};
+};
+
+struct Route
+{
+  std::shared_ptr <Match> match {};
+  uint8_t player {};
+};
+
+struct AddressHash
+{
+  size_t operator () (
+    const net::Address& address ) const
+  {
+    return std::hash <uint64_t> {} (
+      uint64_t{address.GetAddress()} << 16 | address.GetPort() );
+  }
+};
+
+
+struct Server
+{
+  ServerOptions options {};
+  net::Socket socket {};
+
+  std::unordered_map <int32_t, Seeker> seekers {};
+  std::unordered_map <int32_t, Pairing> pairings {};
+
+//  Seeker waiting for an opponent, by password
+  std::unordered_map <std::string, int32_t> waiting {};
+
+  std::unordered_map <net::Address, Route, AddressHash> routes {};
+
+  uint32_t matchCount {};
+  uint32_t nextMatchId {};
+
+//  Sent after the current batch is processed
+  std::vector <net::Socket::Datagram> outgoing {};
+  std::deque <std::string> replies {};
+
+  uint64_t pairingCount {};
+  uint64_t datagramsIn {};
+  uint64_t datagramsOut {};
+};
+
+
+static std::atomic <bool> isRunning {true};
+
+
+//  Net.h logs through the game's log_message,
+//  which lives in the SDL frontend
+void
+log_message(
+  const std::string& message,
+  const std::string& buffer1,
+  const std::string& buffer2,
+  const std::string& buffer3 )
+{
+  std::printf( "%s%s%s%s",
+    message.c_str(), buffer1.c_str(),
+    buffer2.c_str(), buffer3.c_str() );
+}
+
+
+static void
+printUsage(
+  const char* exeName )
+{
+  std::printf(
+    "Usage: %s [options]\n"
+    "  --port N          UDP port for matchmaking and relay (default %u)\n"
+    "  --public-ip IP    address players reach the server at (default 127.0.0.1)\n"
+    "  --max-matches N   concurrent matches (default 1024)\n"
+    "  --p2p             only pair players, they connect to each other directly\n",
+    exeName, MATCHMAKE_SRV_PORT );
+}
+
+static bool
+parseOptions(
+  int argc,
+  char* args[],
+  ServerOptions& options )
+{
+  for ( int i = 1; i < argc; ++i )
+  {
+    const std::string arg = args[i];
+
+    if ( arg == "--help" || arg == "-h" )
+      return false;
+
+    if ( arg == "--p2p" )
+    {
+      options.isRelay = false;
+      continue;
+    }
+
+    if ( i + 1 >= argc )
+      return false;
+
+    const std::string value = args[++i];
+
+    if ( arg == "--port" )
+      options.port = std::strtoul(value.c_str(), nullptr, 10);
+
+    else if ( arg == "--public-ip" )
+      options.publicIp = value;
+
+    else if ( arg == "--max-matches" )
+      options.maxMatches = std::strtoul(value.c_str(), nullptr, 10);
+
+    else
+      return false;
+  }
+
+  return options.port != 0;
+}
+
+
+static void
+sendReply(
+  Server& server,
+  const net::Address& destination,
+  const picojson::object& message )
+{
+  server.replies.push_back(picojson::value(message).serialize());
+
+  auto& reply = server.replies.back();
+
+  net::Socket::Datagram datagram {};
+  datagram.address = destination;
+  datagram.data = reinterpret_cast <unsigned char*> (reply.data());
+  datagram.size = reply.size();
+
+  server.outgoing.push_back(datagram);
+}
+
+static void
+sendStatus(
+  Server& server,
+  const net::Address& destination,
+  const MatchConnectStatus status )
+{
+  picojson::object message {};
+  message[MATCHMAKE_MSG_TYPE] = picojson::value( (double) status );
+
+  sendReply(server, destination, message);
+}
+
+static void
+sendOpponent(
+  Server& server,
+  const net::Address& destination,
+  const std::string& opponentIp,
+  const uint16_t opponentPort,
+  const SRV_CLI nodeType )
+{
+  picojson::object message {};
+  message[MATCHMAKE_MSG_TYPE] = picojson::value( (double) MatchConnectStatus::MMOPPONENT );
+  message["ip"] = picojson::value( opponentIp );
+  message["port"] = picojson::value( std::to_string(opponentPort) );
+  message["cs"] = picojson::value(
+    nodeType == SRV_CLI::SERVER ? "server" : "client" );
+
+  sendReply(server, destination, message);
+}
+
+
+static void
+sendPairing(
+  Server& server,
+  const Pairing& pairing )
+{
+  sendOpponent(server, pairing.streamAddress,
+    pairing.opponentIp, pairing.opponentPort,
+    pairing.nodeType );
+}
+
+static void
+pairSeeker(
+  Server& server,
+  const int32_t clientId,
+  const Seeker& seeker,
+  const std::string& opponentIp,
+  const uint16_t opponentPort,
+  const SRV_CLI nodeType )
+{
+  auto& pairing = server.pairings[clientId];
+  pairing.gameAddress = seeker.gameAddress;
+  pairing.streamAddress = seeker.streamAddress;
+  pairing.opponentIp = opponentIp;
+  pairing.opponentPort = opponentPort;
+  pairing.nodeType = nodeType;
+  pairing.time = Clock::now();
+
+  sendPairing(server, pairing);
+}
+
+
+static void
+closeMatch(
+  Server& server,
+  const std::shared_ptr <Match>& match,
+  const char* reason )
+{
+  match->isClosed = true;
+
+  for ( const auto& player : match->players )
+  {
+    const auto route = server.routes.find(player.address);
+
+    if (  route != server.routes.end() &&
+          route->second.match == match )
+      server.routes.erase(route);
+  }
+
+  --server.matchCount;
+
+  std::printf( "Match %u closed: %s\n", match->id, reason );
+}
+
+static void
+openMatch(
+  Server& server,
+  const int32_t hostId,
+  const int32_t guestId )
+{
+  const auto host = server.seekers.at(hostId);
+  const auto guest = server.seekers.at(guestId);
+
+  server.seekers.erase(hostId);
+  server.seekers.erase(guestId);
+
+  ++server.pairingCount;
+
+
+  if ( server.options.isRelay == false )
+  {
+    pairSeeker(server, hostId, host,
+      guest.gameAddress.ToString(false), guest.gameAddress.GetPort(),
+      SRV_CLI::SERVER );
+
+    pairSeeker(server, guestId, guest,
+      host.gameAddress.ToString(false), host.gameAddress.GetPort(),
+      SRV_CLI::CLIENT );
+
+    return;
+  }
+
+
+  auto match = std::make_shared <Match> ();
+  match->id = server.nextMatchId++;
+
+  const auto now = Clock::now();
+
+  auto& playerBlue = match->players[PLANE_TYPE::BLUE];
+  auto& playerRed = match->players[PLANE_TYPE::RED];
+
+  playerBlue.address = host.gameAddress;
+  playerBlue.lastSeen = now;
+
+  playerRed.address = guest.gameAddress;
+  playerRed.lastSeen = now;
+
+  server.routes[host.gameAddress] = {match, PLANE_TYPE::BLUE};
+  server.routes[guest.gameAddress] = {match, PLANE_TYPE::RED};
+
+  ++server.matchCount;
+
+
+  const auto& publicIp = server.options.publicIp;
+  const auto port = server.options.port;
+
+  pairSeeker(server, hostId, host, publicIp, port, SRV_CLI::SERVER);
+  pairSeeker(server, guestId, guest, publicIp, port, SRV_CLI::CLIENT);
+
+  std::printf( "Match %u opened: %s vs %s\n", match->id,
+    host.gameAddress.ToString().c_str(),
+    guest.gameAddress.ToString().c_str() );
+}
+
+static void
+findOpponent(
+  Server& server,
+  const int32_t clientId )
+{
+  auto& seeker = server.seekers.at(clientId);
+
+  if ( seeker.streamAddress.GetAddress() == 0 )
+    return;
+
+
+  const auto echoTime = Clock::now() +
+    std::chrono::duration_cast <Clock::duration> (
+      std::chrono::duration <double> {EchoDelay} );
+
+  const auto waiting = server.waiting.find(seeker.password);
+
+  if ( waiting != server.waiting.end() && waiting->second != clientId )
+  {
+    const auto other = server.seekers.find(waiting->second);
+
+    const bool isWaiting =
+      other != server.seekers.end() &&
+      other->second.password == seeker.password &&
+      other->second.gameAddress != seeker.gameAddress;
+
+    if ( isWaiting == true )
+    {
+      if (  server.options.isRelay == true &&
+            server.matchCount >= server.options.maxMatches )
+      {
+        seeker.echoTime = echoTime;
+        return;
+      }
+
+      server.waiting.erase(waiting);
+
+//    Who waited longer hosts
+      return openMatch(server, other->first, clientId);
+    }
+  }
+
+  server.waiting[seeker.password] = clientId;
+  seeker.echoTime = echoTime;
+}
+
+
+static bool
+parseStatus(
+  const net::Socket::Datagram& datagram,
+  MatchConnectStatus& status,
+  int32_t& clientId,
+  std::string& password )
+{
+  if ( datagram.size <= 0 || datagram.data[0] != '{' )
+    return false;
+
+
+  picojson::value json {};
+
+  const char* begin = reinterpret_cast <const char*> (datagram.data);
+  std::string error {};
+
+  picojson::parse( json, begin, begin + datagram.size, &error );
+
+  if ( error.empty() == false || json.is <picojson::object> () == false )
+    return false;
+
+
+  const auto& message = json.get <picojson::object> ();
+
+  const auto type = message.find(MATCHMAKE_MSG_TYPE);
+  const auto id = message.find(MATCHMAKE_MSG_CID);
+  const auto pass = message.find(MATCHMAKE_MSG_PASS);
+
+  if (  type == message.end() || type->second.is <double> () == false ||
+        id == message.end() || id->second.is <double> () == false )
+    return false;
+
+  status = static_cast <MatchConnectStatus> (type->second.get <double> ());
+  clientId = id->second.get <double> ();
+
+  if ( pass != message.end() )
+    password = pass->second.to_str();
+
+  return true;
+}
+
+static void
+handleMatchmaking(
+  Server& server,
+  const net::Socket::Datagram& datagram,
+  const MatchConnectStatus status,
+  const int32_t clientId,
+  const std::string& password )
+{
+  switch ( status )
+  {
+    case MatchConnectStatus::MMSTREAM:
+    {
+      const auto pairing = server.pairings.find(clientId);
+
+      if ( pairing != server.pairings.end() )
+      {
+        pairing->second.streamAddress = datagram.address;
+        return;
+      }
+
+      auto& seeker = server.seekers[clientId];
+      seeker.streamAddress = datagram.address;
+      seeker.lastSeen = Clock::now();
+
+      return;
+    }
+
+    case MatchConnectStatus::FIND:
+    {
+      const auto pairing = server.pairings.find(clientId);
+
+      if ( pairing != server.pairings.end() )
+      {
+        if ( pairing->second.gameAddress == datagram.address )
+          return sendPairing(server, pairing->second);
+
+        server.pairings.erase(pairing);
+      }
+
+      auto& seeker = server.seekers[clientId];
+      seeker.gameAddress = datagram.address;
+      seeker.password = password;
+      seeker.lastSeen = Clock::now();
+
+      return findOpponent(server, clientId);
+    }
+
+    default:
+      return;
+  }
+}
+
+
+static void
+handleDatagram(
+  Server& server,
+  net::Socket::Datagram& datagram )
+{
+  ++server.datagramsIn;
+
+  MatchConnectStatus status {};
+  int32_t clientId {};
+  std::string password {};
+
+  const bool isStatus = parseStatus(
+    datagram, status, clientId, password );
+
+//  Paired player searching again before reading MMOPPONENT
+  if ( isStatus == true && server.pairings.count(clientId) != 0 )
+    return handleMatchmaking(server, datagram, status, clientId, password);
+
+
+  const auto route = server.routes.find(datagram.address);
+
+  if ( route != server.routes.end() )
+  {
+    const auto match = route->second.match;
+
+//  Address is looking for a new match. Players
+//  only relay P2PACCEPT to each other
+    if (  isStatus == true &&
+          ( status == MatchConnectStatus::FIND ||
+            status == MatchConnectStatus::MMSTREAM ) )
+      closeMatch(server, match, "player left");
+
+    else
+    {
+      const auto player = route->second.player;
+      match->players[player].lastSeen = Clock::now();
+
+      auto forwarded = datagram;
+      forwarded.address = match->players[!player].address;
+      server.outgoing.push_back(forwarded);
+
+      return;
+    }
+  }
+
+  if ( isStatus == true )
+    handleMatchmaking(server, datagram, status, clientId, password);
+}
+
+
+static void
+updateTimers(
+  Server& server )
+{
+  const auto now = Clock::now();
+
+  for ( auto it = server.seekers.begin(); it != server.seekers.end(); )
+  {
+    auto& [clientId, seeker] = *it;
+
+    const std::chrono::duration <double> idle = now - seeker.lastSeen;
+
+    if ( idle.count() > SeekerTimeout )
+    {
+      const auto waiting = server.waiting.find(seeker.password);
+
+      if ( waiting != server.waiting.end() && waiting->second == clientId )
+        server.waiting.erase(waiting);
+
+      it = server.seekers.erase(it);
+      continue;
+    }
+
+    if (  seeker.echoTime != Clock::time_point{} &&
+          now >= seeker.echoTime )
+    {
+      sendStatus(server, seeker.streamAddress, MatchConnectStatus::MMECHO);
+      seeker.echoTime = {};
+    }
+
+    ++it;
+  }
+
+  for ( auto pairing = server.pairings.begin(); pairing != server.pairings.end(); )
+  {
+    const std::chrono::duration <double> age = now - pairing->second.time;
+
+    if ( age.count() > SeekerTimeout )
+      pairing = server.pairings.erase(pairing);
+    else
+      ++pairing;
+  }
+
+
+  std::vector <std::shared_ptr <Match>> timedOut {};
+
+  for ( const auto& [address, route] : server.routes )
+  {
+    const std::chrono::duration <double> idle =
+      now - route.match->players[route.player].lastSeen;
+
+    if ( idle.count() > PlayerTimeout )
+      timedOut.push_back(route.match);
+  }
+
+  for ( const auto& match : timedOut )
+    if ( match->isClosed == false )
+      closeMatch(server, match, "player timed out");
+}
+
+
+static void
+runNetwork(
+  Server& server )
+{
+  const int batchSize = net::Socket::batch_size;
+  const int datagramSize = 1200;
+
+  std::vector <unsigned char> arena (batchSize * datagramSize);
+  net::Socket::Datagram received[batchSize] {};
+
+  auto lastTimers = Clock::now();
+  auto lastStats = Clock::now();
+
+
+  while ( isRunning == true )
+  {
+    for ( int i {}; i < batchSize; ++i )
+    {
+      received[i].data = &arena[i * datagramSize];
+      received[i].size = datagramSize;
+    }
+
+    const int count = server.socket.ReceiveBatch(received, batchSize);
+
+    for ( int i {}; i < count; ++i )
+      handleDatagram(server, received[i]);
+
+    if ( server.outgoing.empty() == false )
+    {
+      server.datagramsOut += server.socket.SendBatch(
+        server.outgoing.data(), server.outgoing.size() );
+
+      server.outgoing.clear();
+      server.replies.clear();
+    }
+
+
+    const auto now = Clock::now();
+
+    if ( now - lastTimers > std::chrono::milliseconds{100} )
+    {
+      updateTimers(server);
+      lastTimers = now;
+    }
+
+    const std::chrono::duration <double> sinceStats = now - lastStats;
+
+    if ( sinceStats.count() > StatsInterval )
+    {
+      std::printf( "matches: %zu, seekers: %zu, pairings: %.1f/s, datagrams in: %.0f/s, out: %.0f/s\n",
+        server.routes.size() / 2, server.seekers.size(),
+        server.pairingCount / sinceStats.count(),
+        server.datagramsIn / sinceStats.count(),
+        server.datagramsOut / sinceStats.count() );
+
+      server.pairingCount = 0;
+      server.datagramsIn = 0;
+      server.datagramsOut = 0;
+      lastStats = now;
+    }
+
+    if ( count == 0 )
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+}
+
+
+int
+main(
+  int argc,
+  char* args[] )
+{
+  Server server {};
+
+  if ( parseOptions(argc, args, server.options) == false )
+  {
+    printUsage(args[0]);
+    return 1;
+  }
+
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+
+  if ( net::InitializeSockets() != 0 )
+  {
+    std::fprintf( stderr, "Failed to initialize sockets\n" );
+    return 1;
+  }
+
+  if ( server.socket.Open(server.options.port) == false )
+  {
+    std::fprintf( stderr, "Failed to open UDP port %u\n", server.options.port );
+    return 1;
+  }
+
+  std::signal( SIGINT, [] ( int ) { isRunning = false; } );
+  std::signal( SIGTERM, [] ( int ) { isRunning = false; } );
+
+  std::printf( "Listening on port %u as %s\n",
+    server.options.port, server.options.publicIp.c_str() );
+
+
+  runNetwork(server);
+
+  server.socket.Close();
+  net::ShutdownSockets();
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/simulation.hpp>
+#include <include/world.hpp>
+#include <include/constants.hpp>
+
+
+void
+setSimEventHandler(
+  const SimEventHandler handler )
+{
+  world().eventHandler = handler;
+}
+
+void
+simEventPush(
+  const SimEvent& event )
+{
+  const auto handler = world().eventHandler;
+
+  if ( handler != nullptr )
+    handler(event);
+}
+
+void
+simNetEventPush(
+  const EVENTS netEvent )
+{
+  SimEvent event {SIM_EVENT::NETWORK_EVENT};
+  event.netEvent = netEvent;
+
+  simEventPush(event);
+}
+
+
+void
+sim_reset()
+{
+  auto& sim = world();
+
+  if ( sim.clouds.empty() == true )
+  {
+    sim.clouds.resize(constants::cloud::count);
+
+    for ( uint8_t i = 0; i < sim.clouds.size(); i++ )
+      sim.clouds[i] = {static_cast <bool> (i % 2), i};
+  }
+
+  for ( auto& [planeType, plane] : sim.planes )
+  {
+    plane.Respawn();
+    plane.ResetScore();
+    plane.ResetStats();
+  }
+
+  for ( auto& [planeType, plane] : sim.planes )
+    plane.ResetSpawnProtection();
+
+  sim.zeppelin.Respawn();
+  sim.bullets.Clear();
+
+  for ( auto& cloud : sim.clouds )
+    cloud.Respawn();
+
+  sim.effects.Clear();
+}
+
+void
+sim_tick()
+{
+  auto& sim = world();
+
+  sim.aiController.update();
+
+
+  for ( auto& cloud : sim.clouds )
+    cloud.Update();
+
+  for ( auto& [planeType, plane] : sim.planes )
+    plane.Update();
+
+  sim.zeppelin.Update();
+  sim.bullets.Update();
+  sim.effects.Update();
+}
@@ -0,0 +1,256 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/sprite_batch.hpp>
+#include <include/sdl.hpp>
+
+#include <array>
+#include <cmath>
+#include <utility>
+
+
+static constexpr size_t maxSprites {1024};
+
+static SpriteBatchStats frameStats {};
+static SpriteBatchStats lastFrameStats {};
+
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+
+static SDL_Texture* batchTexture {};
+static float batchTextureWidth {};
+static float batchTextureHeight {};
+
+static std::array <SDL_Vertex, maxSprites * 4> vertices {};
+static size_t spriteCount {};
+
+static const auto indices =
+[] ()
+{
+  std::array <int, maxSprites * 6> result {};
+
+  for ( size_t i {}; i < maxSprites; ++i )
+  {
+    const int vertex = i * 4;
+
+    result[i * 6 + 0] = vertex + 0;
+    result[i * 6 + 1] = vertex + 1;
+    result[i * 6 + 2] = vertex + 2;
+    result[i * 6 + 3] = vertex + 2;
+    result[i * 6 + 4] = vertex + 3;
+    result[i * 6 + 5] = vertex + 0;
+  }
+
+  return result;
+}();
+
+#endif
+
+
+void
+sprite_batch_draw(
+  SDL_Texture* texture,
+  const SDL_Rect* srcRect,
+  const SDL_FRect& dstRect,
+  const uint8_t alpha )
+{
+  sprite_batch_draw_ex(
+    texture,
+    srcRect,
+    dstRect,
+    0.0,
+    SDL_FLIP_NONE,
+    alpha );
+}
+
+void
+sprite_batch_draw_ex(
+  SDL_Texture* texture,
+  const SDL_Rect* srcRect,
+  const SDL_FRect& dstRect,
+  const double angle,
+  const SDL_RendererFlip flip,
+  const uint8_t alpha )
+{
+  if ( texture == nullptr )
+    return;
+
+
+  ++frameStats.sprites;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+
+  if ( texture != batchTexture )
+  {
+    sprite_batch_flush();
+
+    int width {};
+    int height {};
+    SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+
+    batchTexture = texture;
+    batchTextureWidth = width;
+    batchTextureHeight = height;
+  }
+
+  if ( spriteCount == maxSprites )
+    sprite_batch_flush();
+
+
+  SDL_FRect uv {0.0f, 0.0f, 1.0f, 1.0f};
+
+  if ( srcRect != nullptr )
+    uv =
+    {
+      srcRect->x / batchTextureWidth,
+      srcRect->y / batchTextureHeight,
+      (srcRect->x + srcRect->w) / batchTextureWidth,
+      (srcRect->y + srcRect->h) / batchTextureHeight,
+    };
+
+  if ( (flip & SDL_FLIP_HORIZONTAL) != 0 )
+    std::swap(uv.x, uv.w);
+
+  if ( (flip & SDL_FLIP_VERTICAL) != 0 )
+    std::swap(uv.y, uv.h);
+
+
+  const float halfWidth = 0.5f * dstRect.w;
+  const float halfHeight = 0.5f * dstRect.h;
+
+  const SDL_FPoint center
+  {
+    dstRect.x + halfWidth,
+    dstRect.y + halfHeight,
+  };
+
+  SDL_FPoint corners[]
+  {
+    {-halfWidth, -halfHeight},
+    {halfWidth, -halfHeight},
+    {halfWidth, halfHeight},
+    {-halfWidth, halfHeight},
+  };
+
+//  Clockwise, same as SDL_RenderCopyEx
+  if ( angle != 0.0 )
+  {
+    const float radians = angle * M_PI / 180.0;
+    const float sinAngle = std::sin(radians);
+    const float cosAngle = std::cos(radians);
+
+    for ( auto& corner : corners )
+      corner =
+      {
+        corner.x * cosAngle - corner.y * sinAngle,
+        corner.x * sinAngle + corner.y * cosAngle,
+      };
+  }
+
+  const SDL_FPoint texCoords[]
+  {
+    {uv.x, uv.y},
+    {uv.w, uv.y},
+    {uv.w, uv.h},
+    {uv.x, uv.h},
+  };
+
+  const SDL_Color color {255, 255, 255, alpha};
+
+  auto* const quad = &vertices[spriteCount * 4];
+
+  for ( size_t i {}; i < 4; ++i )
+    quad[i] =
+    {
+      {center.x + corners[i].x, center.y + corners[i].y},
+      color,
+      texCoords[i],
+    };
+
+  ++spriteCount;
+
+#else
+
+//  SDL_RenderGeometry needs SDL 2.0.18
+  if ( alpha != 255 )
+    SDL_SetTextureAlphaMod(texture, alpha);
+
+  SDL_RenderCopyExF(
+    gRenderer,
+    texture,
+    srcRect,
+    &dstRect,
+    angle,
+    nullptr,
+    flip );
+
+  if ( alpha != 255 )
+    SDL_SetTextureAlphaMod(texture, 255);
+
+  ++frameStats.drawCalls;
+  frameStats.vertices += 4;
+
+#endif
+}
+
+void
+sprite_batch_flush()
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+
+  if ( spriteCount == 0 )
+    return;
+
+
+  SDL_RenderGeometry(
+    gRenderer,
+    batchTexture,
+    vertices.data(),
+    spriteCount * 4,
+    indices.data(),
+    spriteCount * 6 );
+
+  ++frameStats.drawCalls;
+  frameStats.vertices += spriteCount * 4;
+
+  spriteCount = 0;
+
+#endif
+}
+
+void
+sprite_batch_end_frame()
+{
+  sprite_batch_flush();
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+//  Texture may be destroyed before the next frame
+  batchTexture = nullptr;
+#endif
+
+  lastFrameStats = frameStats;
+  frameStats = {};
+}
+
+SpriteBatchStats
+sprite_batch_stats()
+{
+  return lastFrameStats;
+}
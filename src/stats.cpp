@@ -0,0 +1,148 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/stats.hpp>
+#include <include/plane.hpp>
+#include <include/game_state.hpp>
+#include <include/simulation.hpp>
+#include <include/world.hpp>
+
+#include <limits>
+
+
+void
+calcDerivedStats(
+  Statistics& stats )
+{
+  stats.totalHits =
+    stats.plane_hits + stats.chute_hits + stats.pilot_hits;
+
+  stats.misses =
+    stats.shots - stats.totalHits;
+
+
+  stats.suicides =
+    stats.crashes + stats.falls;
+
+
+  stats.totalKills =
+    stats.plane_kills + stats.pilot_hits;
+
+  stats.totalDeaths =
+    stats.plane_deaths + stats.pilot_deaths + stats.suicides;
+
+
+//  ACCURACY
+  if ( stats.shots == 0 )
+    stats.accuracy = 0.f;
+  else
+    stats.accuracy = stats.totalHits * 100.f / stats.shots;
+
+
+//  SELF-PRESERVATION
+  if ( stats.suicides + stats.rescues == 0 )
+    stats.selfPreservation =
+      100.f * (stats.totalKills + stats.totalDeaths > 0);
+
+  else
+    stats.selfPreservation =
+      stats.rescues * 100.f / (stats.suicides + stats.rescues);
+
+
+//  KD RATIO
+  if ( stats.totalKills == 0 )
+    stats.kdRatio = 0.f;
+
+  else if ( stats.totalDeaths == 0 )
+    stats.kdRatio = std::numeric_limits <float>::infinity();
+
+  else
+    stats.kdRatio = 1.f * stats.totalKills / stats.totalDeaths;
+
+
+//  SURVIVABILITY
+  if ( stats.totalKills + stats.totalDeaths == 0 )
+    stats.survivability = 0.f;
+
+  else if ( stats.totalKills > 0 &&
+            stats.totalDeaths + stats.rescues == 0 )
+    stats.survivability = 100.f;
+
+  else
+    stats.survivability =
+      stats.rescues * 100.f / (stats.totalDeaths + stats.rescues);
+
+
+//  SHOTS PER KILL
+  if ( stats.totalKills == 0 )
+    stats.shotsPerKill = 0.f;
+
+  else
+    stats.shotsPerKill =
+      1.f * stats.shots / stats.totalKills;
+}
+
+void
+updateRecentStats()
+{
+  for ( const auto& [planeType, plane] : world().planes )
+    gameState().stats.recent[planeType] = plane.stats();
+}
+
+void
+resetRecentStats()
+{
+  for ( auto& [planeType, stats] : gameState().stats.recent )
+    stats = {};
+}
+
+void
+updateTotalStats()
+{
+  auto& game = gameState();
+
+  const auto& planeRed = world().planes.at(PLANE_TYPE::RED);
+  const auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+
+  const auto& playerPlane =
+    planeRed.isBot() == false && planeRed.isLocal() == true
+    ? planeRed : planeBlue;
+
+  const auto& playerStats = game.stats.recent[playerPlane.type()];
+  auto& totalStats = game.stats.total;
+
+  totalStats.chute_hits   += playerStats.chute_hits;
+  totalStats.crashes      += playerStats.crashes;
+  totalStats.plane_deaths += playerStats.plane_deaths;
+  totalStats.pilot_deaths += playerStats.pilot_deaths;
+  totalStats.falls        += playerStats.falls;
+  totalStats.jumps        += playerStats.jumps;
+  totalStats.losses       += playerStats.losses;
+  totalStats.pilot_hits   += playerStats.pilot_hits;
+  totalStats.plane_hits   += playerStats.plane_hits;
+  totalStats.plane_kills  += playerStats.plane_kills;
+  totalStats.rescues      += playerStats.rescues;
+  totalStats.shots        += playerStats.shots;
+  totalStats.wins         += playerStats.wins;
+  totalStats.wins_vs_developer += playerStats.wins_vs_developer;
+  totalStats.wins_vs_insane += playerStats.wins_vs_insane;
+
+  simEventPush({SIM_EVENT::TOTAL_STATS_UPDATED});
+}
@@ -21,4 +21,4 @@
 #include <include/time.hpp>
 
 
-double deltaTime {};
+thread_local double deltaTime {};
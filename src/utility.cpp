@@ -47,6 +47,8 @@
 #define CONFIG_FILENAME BIPLANES_EXE_NAME ".conf"
 #define STATS_FILENAME BIPLANES_EXE_NAME ".stats"
 #define LOG_FILENAME BIPLANES_EXE_NAME ".log"
+#define ATLAS_FILENAME BIPLANES_EXE_NAME "_atlas"
+#define TRACE_FILENAME BIPLANES_EXE_NAME ".trace.json"
 
 // Global variable for PS Vita data directory
 #ifdef VITA_PLATFORM
@@ -187,6 +189,58 @@ get_stats_path()
 #endif
 }
 
+std::string
+get_atlas_cache_path()
+{
+#ifdef VITA_PLATFORM
+  // Ensure data directory exists before returning path
+  ensureDataDirectoryExists();
+  return vitaDataPath + "/" + ATLAS_FILENAME;
+#elif defined(_WIN32) || defined(__APPLE__) || defined(__MACH__)
+  return ATLAS_FILENAME;
+#else
+  const auto appImageDir = get_appimage_dir();
+
+  if ( appImageDir.empty() == false )
+    return appImageDir + "/" ATLAS_FILENAME;
+
+
+  const auto cacheParentPath = std::getenv("XDG_CACHE_HOME");
+
+  if (  cacheParentPath == nullptr ||
+        std::string{cacheParentPath}.empty() == true )
+    return ATLAS_FILENAME;
+
+  return std::string{cacheParentPath} + "/" ATLAS_FILENAME;
+#endif
+}
+
+std::string
+get_trace_path()
+{
+#ifdef VITA_PLATFORM
+  // Ensure data directory exists before returning path
+  ensureDataDirectoryExists();
+  return vitaDataPath + "/" + TRACE_FILENAME;
+#elif defined(_WIN32) || defined(__APPLE__) || defined(__MACH__)
+  return TRACE_FILENAME;
+#else
+  const auto appImageDir = get_appimage_dir();
+
+  if ( appImageDir.empty() == false )
+    return appImageDir + "/" TRACE_FILENAME;
+
+
+  const auto traceParentPath = std::getenv("XDG_STATE_HOME");
+
+  if (  traceParentPath == nullptr ||
+        std::string{traceParentPath}.empty() == true )
+    return TRACE_FILENAME;
+
+  return std::string{traceParentPath} + "/" TRACE_FILENAME;
+#endif
+}
+
 
 void
 settingsWrite()
@@ -223,6 +277,7 @@ settingsWrite()
   jsonConfig["EnableVSync"]       = picojson::value( game.isVSyncEnabled );
   jsonConfig["AudioVolume"]       = picojson::value( game.audioVolume / 100. );
   jsonConfig["StereoDepth"]       = picojson::value( game.stereoDepth / 100. );
+  jsonConfig["AssetCacheBudget"]  = picojson::value( (double) game.assetCacheBudget );
 
   picojson::object jsonControls;
   jsonControls["FIRE"]            = picojson::value( (double) bindings::player1.fire );
@@ -245,6 +300,7 @@ settingsWrite()
   jsonUtility["StatsOutput"]      = picojson::value( game.output.stats );
   jsonUtility["ShowAiLayer"]      = picojson::value( game.debug.ai );
   jsonUtility["ShowCollisions"]   = picojson::value( game.debug.collisions );
+  jsonUtility["ShowPerfHud"]      = picojson::value( game.debug.perfHud );
 
   picojson::object jsonSettings;
   jsonSettings["AutoFill"]        = picojson::value( jsonAutoFill );
@@ -325,6 +381,7 @@ settingsParse(
   {
     double audioVolume {};
     double stereoDepth {};
+    double assetCacheBudget {};
 
 
     auto& jsonConfig = jsonValue["Config"].get <picojson::object> ();
@@ -344,12 +401,18 @@ settingsParse(
     try { stereoDepth = jsonConfig.at( "StereoDepth" ).get <double> (); }
     catch ( const std::exception& ) { stereoDepth = game.stereoDepth / 100.; };
 
+    try { assetCacheBudget = jsonConfig.at( "AssetCacheBudget" ).get <double> (); }
+    catch ( const std::exception& ) { assetCacheBudget = game.assetCacheBudget; };
+
 
     if ( audioVolume >= 0.0 && audioVolume <= 1.0 )
       game.audioVolume = fractionToPercentage(audioVolume);
 
     if ( stereoDepth >= 0.0 && stereoDepth <= 1.0 )
       game.stereoDepth = fractionToPercentage(stereoDepth);
+
+    if ( assetCacheBudget >= 0.0 && assetCacheBudget <= 1024.0 )
+      game.assetCacheBudget = assetCacheBudget;
   }
   catch ( const std::exception& ) {};
 
@@ -458,6 +521,9 @@ settingsParse(
 
     try { game.debug.collisions = jsonUtility.at( "ShowCollisions" ).get <bool> (); }
     catch ( const std::exception& ) {};
+
+    try { game.debug.perfHud = jsonUtility.at( "ShowPerfHud" ).get <bool> (); }
+    catch ( const std::exception& ) {};
   }
   catch ( const std::exception& ) {};
 
@@ -0,0 +1,80 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/world_snapshot.hpp>
+#include <include/world.hpp>
+
+#include <algorithm>
+
+
+void
+WorldSnapshot::save(
+  const World& source )
+{
+  planes[0] = source.planes.at(PLANE_TYPE::BLUE);
+  planes[1] = source.planes.at(PLANE_TYPE::RED);
+
+
+  bulletCount = source.bullets.count();
+
+  for ( size_t i {}; i < bulletCount; ++i )
+    bullets[i] = source.bullets.at(i);
+
+
+  effects = source.effects;
+
+
+  cloudCount = std::min(source.clouds.size(), constants::cloud::count);
+  std::copy_n(source.clouds.begin(), cloudCount, clouds);
+
+  zeppelin = source.zeppelin;
+
+  isRoundFinished = source.state.isRoundFinished;
+}
+
+void
+WorldSnapshot::restore(
+  World& target ) const
+{
+  target.planes.at(PLANE_TYPE::BLUE) = planes[0];
+  target.planes.at(PLANE_TYPE::RED) = planes[1];
+
+//  Snapshot may come from another world
+  for ( auto& [planeType, plane] : target.planes )
+  {
+    plane.input.setPlane(&plane);
+    plane.pilot.setPlane(&plane);
+  }
+
+
+  target.bullets.mCount = 0;
+
+  for ( size_t i {}; i < bulletCount; ++i )
+    target.bullets.Insert(bullets[i]);
+
+
+  target.effects = effects;
+
+
+  target.clouds.assign(clouds, clouds + cloudCount);
+  target.zeppelin = zeppelin;
+
+  target.state.isRoundFinished = isRoundFinished;
+}
@@ -19,11 +19,9 @@
 */
 
 #include <include/zeppelin.hpp>
-#include <include/sdl.hpp>
 #include <include/time.hpp>
 #include <include/constants.hpp>
-#include <include/plane.hpp>
-#include <include/textures.hpp>
+#include <include/profiler.hpp>
 
 
 Zeppelin::Zeppelin()
@@ -34,6 +32,8 @@ Zeppelin::Zeppelin()
 void
 Zeppelin::Update()
 {
+  PROFILE_ZONE("Zeppelin::Update");
+
   namespace zeppelin = constants::zeppelin;
 
 
@@ -61,74 +61,6 @@ Zeppelin::Update()
     mIsAscending = true;
 }
 
-void
-Zeppelin::Draw()
-{
-  namespace zeppelin = constants::zeppelin;
-  namespace score = zeppelin::score;
-
-
-  const SDL_FRect zeppelinRect
-  {
-    toWindowSpaceX(mX - 0.5f * zeppelin::sizeX),
-    toWindowSpaceY(mY - 0.5f * zeppelin::sizeY),
-    scaleToScreenX(zeppelin::sizeX),
-    scaleToScreenY(zeppelin::sizeY),
-  };
-
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.zeppelin,
-    nullptr,
-    &zeppelinRect );
-
-
-  const auto& planeRed = planes.at(PLANE_TYPE::RED);
-  const auto& planeBlue = planes.at(PLANE_TYPE::BLUE);
-
-  SDL_FRect scoreRect
-  {
-    toWindowSpaceX(mX - score::numOffsetBlue1X),
-    toWindowSpaceY(mY - score::numOffsetY),
-    scaleToScreenX(score::sizeX),
-    scaleToScreenY(score::sizeY),
-  };
-
-
-//  Blue score
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.font_zeppelin_score,
-    &textures.zeppelin_score_rect[planeBlue.score() / 10],
-    &scoreRect );
-
-  scoreRect.x = toWindowSpaceX(mX - score::numOffsetBlue2X);
-
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.font_zeppelin_score,
-    &textures.zeppelin_score_rect[planeBlue.score() % 10],
-    &scoreRect );
-
-
-//  Red score
-  scoreRect.x = toWindowSpaceX(mX + score::numOffsetRed1X);
-
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.font_zeppelin_score,
-    &textures.zeppelin_score_rect[10 + planeRed.score() % 10],
-    &scoreRect );
-
-  scoreRect.x = toWindowSpaceX(mX + score::numOffsetRed2X);
-
-  SDL_RenderCopyF(
-    gRenderer,
-    textures.font_zeppelin_score,
-    &textures.zeppelin_score_rect[10 + planeRed.score() / 10],
-    &scoreRect );
-}
-
 void
 Zeppelin::Respawn()
 {
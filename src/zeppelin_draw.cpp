@@ -0,0 +1,91 @@
+/*
+  Biplanes Revival
+  Copyright (C) 2019-2025 Regular-dev community
+  https://regular-dev.org
+  regular.dev.org@gmail.com
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <include/zeppelin.hpp>
+#include <include/sdl.hpp>
+#include <include/sprite_batch.hpp>
+#include <include/constants.hpp>
+#include <include/plane.hpp>
+#include <include/world.hpp>
+#include <include/textures.hpp>
+
+
+void
+Zeppelin::Draw()
+{
+  namespace zeppelin = constants::zeppelin;
+  namespace score = zeppelin::score;
+
+
+  const SDL_FRect zeppelinRect
+  {
+    toWindowSpaceX(mX - 0.5f * zeppelin::sizeX),
+    toWindowSpaceY(mY - 0.5f * zeppelin::sizeY),
+    scaleToScreenX(zeppelin::sizeX),
+    scaleToScreenY(zeppelin::sizeY),
+  };
+
+  sprite_batch_draw(
+    textures.zeppelin,
+    &textures.zeppelin_rect,
+    zeppelinRect );
+
+
+  const auto& planeRed = world().planes.at(PLANE_TYPE::RED);
+  const auto& planeBlue = world().planes.at(PLANE_TYPE::BLUE);
+
+  SDL_FRect scoreRect
+  {
+    toWindowSpaceX(mX - score::numOffsetBlue1X),
+    toWindowSpaceY(mY - score::numOffsetY),
+    scaleToScreenX(score::sizeX),
+    scaleToScreenY(score::sizeY),
+  };
+
+
+//  Blue score
+  sprite_batch_draw(
+    textures.font_zeppelin_score,
+    &textures.zeppelin_score_rect[planeBlue.score() / 10],
+    scoreRect );
+
+  scoreRect.x = toWindowSpaceX(mX - score::numOffsetBlue2X);
+
+  sprite_batch_draw(
+    textures.font_zeppelin_score,
+    &textures.zeppelin_score_rect[planeBlue.score() % 10],
+    scoreRect );
+
+
+//  Red score
+  scoreRect.x = toWindowSpaceX(mX + score::numOffsetRed1X);
+
+  sprite_batch_draw(
+    textures.font_zeppelin_score,
+    &textures.zeppelin_score_rect[10 + planeRed.score() % 10],
+    scoreRect );
+
+  scoreRect.x = toWindowSpaceX(mX + score::numOffsetRed2X);
+
+  sprite_batch_draw(
+    textures.font_zeppelin_score,
+    &textures.zeppelin_score_rect[10 + planeRed.score() / 10],
+    scoreRect );
+}